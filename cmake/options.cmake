@@ -12,6 +12,8 @@ option(BUILD_METRICS                        "Build Metrics, generate data for Gr
 option(BUILD_RECASTDEMOMOD                  "Build map/vmap/mmap viewer"                OFF)
 option(BUILD_GIT_ID                         "Build git_id"                              OFF)
 option(BUILD_DOCS                           "Build documentation with doxygen"          OFF)
+option(BUILD_LOADGEN                        "Build headless client load generator"      OFF)
+option(BUILD_BENCHMARKS                     "Build microbenchmarks"                     OFF)
 option(CMAKE_INTERPROCEDURAL_OPTIMIZATION   "Enable link-time optimizations"            OFF)
 option(BUILD_DEPRECATED_PLAYERBOT           "Build previous version of Playerbot mod"   OFF)
 set(DEV_BINARY_DIR ${CMAKE_BINARY_DIR} CACHE STRING "Executable directory on Windows")
@@ -40,6 +42,8 @@ message(STATUS
     BUILD_RECASTDEMOMOD     Build map/vmap/mmap viewer
     BUILD_GIT_ID            Build git_id
     BUILD_DOCS              Build documentation with doxygen
+    BUILD_LOADGEN           Build headless client load generator
+    BUILD_BENCHMARKS        Build microbenchmarks
     CMAKE_INTERPROCEDURAL_OPTIMIZATION Enable link-time optimizations
     BUILD_DEPRECATED_PLAYERBOT         Build Playerbot mod (deprecated)
     BUILD_SCRIPTDEV         Build scriptdev. (Disable it to speedup build
@@ -0,0 +1,76 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BENCHMARK_BENCHMARK_H
+#define BENCHMARK_BENCHMARK_H
+
+#include "Common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+class dtNavMesh;
+
+struct BenchmarkOptions
+{
+    BenchmarkOptions() : repeat(5), threads(4) {}
+
+    uint32 repeat;                                          // runs per measurement, the fastest one is reported
+    uint32 threads;                                         // producer threads of the contention benchmarks
+};
+
+/// runs body repeat times and returns the duration of the fastest run in nanoseconds
+template<class BODY>
+uint64 MeasureBest(uint32 repeat, BODY&& body)
+{
+    uint64 best = std::numeric_limits<uint64>::max();
+    for (uint32 i = 0; i < std::max(repeat, 1u); ++i)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        body();
+        auto const end = std::chrono::steady_clock::now();
+        best = std::min(best, uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+    return best;
+}
+
+/// one synthetic navmesh tile of 96x96 square polygons of 2 yards with pillars, nullptr on failure
+dtNavMesh* BuildBenchNavMesh();
+
+void RunBroadcastBenchmark(BenchmarkOptions const& options);
+void RunCellSearchBenchmark(BenchmarkOptions const& options);
+void RunCorridorPatchBenchmark(BenchmarkOptions const& options);
+void RunDBCLoadBenchmark(BenchmarkOptions const& options);
+void RunEventQueueBenchmark(BenchmarkOptions const& options);
+void RunGridLoadBenchmark(BenchmarkOptions const& options);
+void RunLoginStormBenchmark(BenchmarkOptions const& options);
+void RunMapScheduleBenchmark(BenchmarkOptions const& options);
+#ifdef BUILD_METRICS
+void RunMetricSeriesBenchmark(BenchmarkOptions const& options);
+#endif
+void RunPacketPoolBenchmark(BenchmarkOptions const& options);
+void RunPathCacheBenchmark(BenchmarkOptions const& options);
+void RunReceiveFramingBenchmark(BenchmarkOptions const& options);
+void RunSpawnQueueBenchmark(BenchmarkOptions const& options);
+void RunTickFlushBenchmark(BenchmarkOptions const& options);
+void RunTickProfileBenchmark(BenchmarkOptions const& options);
+void RunUpdateCompressBenchmark(BenchmarkOptions const& options);
+void RunVisibilityBenchmark(BenchmarkOptions const& options);
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// A packet broadcast to the sessions around a player, once the way WorldSocket::SendPacket used to
+/// queue it, a fresh buffer with header and body per receiver and one write each, and once the way
+/// it does now, one shared copy of the packet for all receivers, small bodies appended to the output
+/// buffer of the socket and large ones referenced, sent by one gathered write per flush.
+
+#include "Benchmark.h"
+#include "Util/ByteBuffer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    size_t const HEADER_SIZE = 4;                           // ServerPktHeader
+    size_t const COPY_LIMIT = 512;                          // WORLD_SOCKET_COPY_LIMIT
+    uint32 const BROADCASTS_PER_FLUSH = 8;                  // packets queued for a socket before a write completes
+    uint64 const BYTES_PER_MEASUREMENT = 256 * 1024 * 1024; // bytes delivered to the receivers per measurement
+
+    // socket before: every packet went into a buffer of its own, written by its own async_write
+    struct CopySocket
+    {
+        std::deque<std::shared_ptr<std::vector<char>>> writes;
+
+        void SendPacket(ByteBuffer const& packet, uint8 const* header, uint64& copied)
+        {
+            std::shared_ptr<std::vector<char>> message = std::make_shared<std::vector<char>>(HEADER_SIZE + packet.size());
+            std::memcpy(message->data(), header, HEADER_SIZE);
+            std::memcpy(message->data() + HEADER_SIZE, packet.contents(), packet.size());
+            copied += HEADER_SIZE + packet.size();
+            writes.push_back(std::move(message));
+        }
+
+        // every completed write released its buffer
+        uint64 Flush()
+        {
+            uint64 written = 0;
+            for (auto const& message : writes)
+                written += message->size();
+            writes.clear();
+            return written;
+        }
+    };
+
+    // socket now: headers and small bodies coalesced, large bodies referenced, one gathered write
+    struct GatherSocket
+    {
+        std::vector<uint8> data;
+        std::vector<std::pair<size_t, std::shared_ptr<ByteBuffer const>>> references;
+        std::vector<std::pair<uint8 const*, size_t>> buffers;
+
+        void SendPacket(std::shared_ptr<ByteBuffer const> const& packet, uint8 const* header, uint64& copied)
+        {
+            data.insert(data.end(), header, header + HEADER_SIZE);
+            copied += HEADER_SIZE;
+            if (packet->size() <= COPY_LIMIT)
+            {
+                data.insert(data.end(), packet->contents(), packet->contents() + packet->size());
+                copied += packet->size();
+            }
+            else
+                references.emplace_back(data.size(), packet);
+        }
+
+        // WorldSocket::StartWrite splits the coalesced bytes where a referenced body goes in
+        uint64 Flush()
+        {
+            buffers.clear();
+            size_t offset = 0;
+            for (auto const& [position, packet] : references)
+            {
+                if (position > offset)
+                    buffers.emplace_back(data.data() + offset, position - offset);
+                buffers.emplace_back(packet->contents(), packet->size());
+                offset = position;
+            }
+            if (data.size() > offset)
+                buffers.emplace_back(data.data() + offset, data.size() - offset);
+
+            uint64 written = 0;
+            for (auto const& buffer : buffers)
+                written += buffer.second;
+
+            // both keep their capacity for the next flush
+            data.clear();
+            references.clear();
+            return written;
+        }
+    };
+}
+
+void RunBroadcastBenchmark(BenchmarkOptions const& options)
+{
+    size_t const sizes[] = { 32, 128, 512, 2048, 16384 };
+    uint32 const receiverCounts[] = { 10, 50, 200 };
+    uint8 const header[HEADER_SIZE] = { 0x12, 0x34, 0x56, 0x78 };
+
+    printf("%9s %6s %11s %12s %12s %12s %12s %8s\n", "receivers", "body", "broadcasts", "copy ns", "gather ns", "copy B", "gather B", "speedup");
+    for (uint32 receivers : receiverCounts)
+    {
+        for (size_t size : sizes)
+        {
+            ByteBuffer packet(size);
+            for (size_t i = 0; i < size; ++i)
+                packet << uint8(i);
+
+            uint32 const broadcasts = uint32(std::max<uint64>(BYTES_PER_MEASUREMENT / ((size + HEADER_SIZE) * receivers), BROADCASTS_PER_FLUSH));
+            std::vector<CopySocket> copySockets(receivers);
+            std::vector<GatherSocket> gatherSockets(receivers);
+
+            uint64 copyCopied = 0, gatherCopied = 0, copyWritten = 0, gatherWritten = 0;
+            uint64 const copyTime = MeasureBest(options.repeat, [&]()
+            {
+                copyCopied = copyWritten = 0;
+                for (uint32 i = 0; i < broadcasts; ++i)
+                {
+                    // each MessageDeliverer receiver got the packet itself
+                    for (CopySocket& socket : copySockets)
+                        socket.SendPacket(packet, header, copyCopied);
+
+                    if ((i + 1) % BROADCASTS_PER_FLUSH == 0 || i + 1 == broadcasts)
+                        for (CopySocket& socket : copySockets)
+                            copyWritten += socket.Flush();
+                }
+            });
+            uint64 const gatherTime = MeasureBest(options.repeat, [&]()
+            {
+                gatherCopied = gatherWritten = 0;
+                for (uint32 i = 0; i < broadcasts; ++i)
+                {
+                    // SharedMessage copies the packet once on first delivery
+                    std::shared_ptr<ByteBuffer const> shared = std::make_shared<ByteBuffer const>(packet);
+                    gatherCopied += size;
+                    for (GatherSocket& socket : gatherSockets)
+                        socket.SendPacket(shared, header, gatherCopied);
+
+                    if ((i + 1) % BROADCASTS_PER_FLUSH == 0 || i + 1 == broadcasts)
+                        for (GatherSocket& socket : gatherSockets)
+                            gatherWritten += socket.Flush();
+                }
+            });
+
+            if (copyWritten != gatherWritten)
+                printf("MISMATCH: copied path wrote %llu bytes, gathered path %llu\n", (unsigned long long)copyWritten, (unsigned long long)gatherWritten);
+
+            printf("%9u %6u %11u %12.1f %12.1f %12.0f %12.0f %7.2fx\n", receivers, uint32(size), broadcasts,
+                   double(copyTime) / broadcasts, double(gatherTime) / broadcasts,
+                   double(copyCopied) / broadcasts, double(gatherCopied) / broadcasts, double(copyTime) / double(gatherTime));
+        }
+    }
+}
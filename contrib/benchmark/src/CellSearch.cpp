@@ -0,0 +1,272 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Range search for living units around a unit, the AnyUnitInObjectRangeCheck case, once over the
+/// grid reference lists of the cells and once over the flat per cell arrays of CellObjectIndex
+/// filtered by MaNGOS::DistanceFilter, which is what Cell::VisitIndexedObjects does. The flat
+/// search runs a second time with the plain float loop of the filter in place of its SSE2 and AVX2
+/// paths, to tell the gain of the layout from the gain of the vector code.
+
+#include "Benchmark.h"
+#include "GameSystem/GridRefManager.h"
+#include "GameSystem/GridReference.h"
+#include "Util/DistanceFilter.h"
+
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    float const CELL_SIZE = 533.33333f / 16;                // SIZE_OF_GRID_CELL
+    uint32 const TOTAL_UNITS = 32768;                       // units in the searched map, spread over as many cells as the density asks for
+    uint64 const UNIT_TESTS = 4000000;                      // units looked at per measurement of the grid layout
+
+    // Stand-in for a Creature. The fields the range check reads are far apart like in Unit and the
+    // combat reach is read through a virtual call from the update field array of its own allocation.
+    class BenchUnit
+    {
+        public:
+            BenchUnit(float x, float y, float z, float combatReach, bool alive) :
+                m_x(x), m_y(y), m_z(z), m_floatValues(new float[4]()), m_alive(alive)
+            {
+                m_floatValues[0] = combatReach;
+            }
+            virtual ~BenchUnit() { delete[] m_floatValues; }
+
+            virtual float GetCombatReach() const { return m_floatValues[0]; }
+            bool IsAlive() const { return m_alive; }
+            float GetPositionX() const { return m_x; }
+            float GetPositionY() const { return m_y; }
+            float GetPositionZ() const { return m_z; }
+
+            // WorldObject::IsWithinDistInMap
+            bool IsWithinDistInMap(BenchUnit const* obj, float dist) const
+            {
+                float dx = m_x - obj->m_x;
+                float dy = m_y - obj->m_y;
+                float dz = m_z - obj->m_z;
+                float maxdist = dist + GetCombatReach() + obj->GetCombatReach();
+                return dx * dx + dy * dy + dz * dz < maxdist * maxdist;
+            }
+
+            GridReference<BenchUnit>& GetGridRef() { return m_gridRef; }
+
+        private:
+            uint8 m_object[48];                             // update field pointers, guid, type
+            float m_x, m_y, m_z;                            // WorldObject::m_position
+            uint8 m_worldObject[400];
+            float* m_floatValues;
+            uint8 m_unit[1600];
+            bool m_alive;                                   // Unit::m_deathState
+            uint8 m_creature[600];
+            GridReference<BenchUnit> m_gridRef;             // Creature::m_gridRef
+    };
+
+    // MaNGOS::AnyUnitInObjectRangeCheck
+    struct RangeCheck
+    {
+        RangeCheck(BenchUnit const* obj, float range) : i_obj(obj), i_range(range) {}
+        bool operator()(BenchUnit* u) const { return u->IsAlive() && i_obj->IsWithinDistInMap(u, i_range); }
+
+        BenchUnit const* i_obj;
+        float i_range;
+    };
+
+    // arrays of one cell like CellObjectIndex keeps them
+    struct FlatCell
+    {
+        std::vector<BenchUnit*> objects;
+        std::vector<float> x, y, z, combatReach;
+    };
+
+    struct BenchMap
+    {
+        uint32 side;                                        // cells per row
+        std::vector<GridRefManager<BenchUnit>> lists;
+        std::vector<FlatCell> flat;
+        std::vector<std::unique_ptr<BenchUnit>> units;
+        std::vector<std::unique_ptr<uint8[]>> filler;       // other allocations between the units
+
+        uint32 CellOf(float coord) const { return std::min(uint32(std::max(coord, 0.0f) / CELL_SIZE), side - 1); }
+    };
+
+    void BuildMap(BenchMap& map, uint32 density, std::mt19937& rng)
+    {
+        map.side = std::max(3u, uint32(std::sqrt(double(TOTAL_UNITS / density))));
+        map.lists = std::vector<GridRefManager<BenchUnit>>(map.side * map.side);
+        map.flat.resize(map.side * map.side);
+
+        uint32 const count = map.side * map.side * density;
+        std::uniform_real_distribution<float> coord(0.0f, map.side * CELL_SIZE);
+        std::uniform_real_distribution<float> height(0.0f, 8.0f);
+        std::uniform_real_distribution<float> reach(0.5f, 2.5f);
+        std::uniform_int_distribution<uint32> fillerSize(32, 4096);
+        std::bernoulli_distribution alive(0.9);
+
+        // units spawn all over the map in any order, with unrelated allocations in between
+        for (uint32 i = 0; i < count; ++i)
+        {
+            map.filler.emplace_back(new uint8[fillerSize(rng)]);
+            map.units.emplace_back(new BenchUnit(coord(rng), coord(rng), height(rng), reach(rng), alive(rng)));
+            BenchUnit* unit = map.units.back().get();
+            uint32 cell = map.CellOf(unit->GetPositionY()) * map.side + map.CellOf(unit->GetPositionX());
+
+            unit->GetGridRef().link(&map.lists[cell], unit);
+
+            FlatCell& flat = map.flat[cell];
+            flat.objects.push_back(unit);
+            flat.x.push_back(unit->GetPositionX());
+            flat.y.push_back(unit->GetPositionY());
+            flat.z.push_back(unit->GetPositionZ());
+            flat.combatReach.push_back(unit->GetCombatReach());
+        }
+    }
+
+    // Cell::Visit over the reference lists, the check runs on every unit of the touched cells
+    uint64 SearchGrid(BenchMap& map, BenchUnit const& searcher, float radius, uint64& tested)
+    {
+        RangeCheck check(&searcher, radius);
+        float const reach = radius + searcher.GetCombatReach();
+        uint64 found = 0;
+        for (uint32 cy = map.CellOf(searcher.GetPositionY() - reach); cy <= map.CellOf(searcher.GetPositionY() + reach); ++cy)
+        {
+            for (uint32 cx = map.CellOf(searcher.GetPositionX() - reach); cx <= map.CellOf(searcher.GetPositionX() + reach); ++cx)
+            {
+                GridRefManager<BenchUnit>& list = map.lists[cy * map.side + cx];
+                for (GridRefManager<BenchUnit>::iterator itr = list.begin(); itr != list.end(); ++itr)
+                {
+                    ++tested;
+                    if (check(itr->getSource()))
+                        ++found;
+                }
+            }
+        }
+        return found;
+    }
+
+    // the plain float loop DistanceFilter::InRange falls back to without SSE2
+    uint64 InRangeScalar(float const* xs, float const* ys, float const* zs, float const* extra, uint32 count,
+                         float x, float y, float z, float radius)
+    {
+        uint64 mask = 0;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float dx = xs[i] - x;
+            float dy = ys[i] - y;
+            float dz = zs ? zs[i] - z : 0.0f;
+            float maxDist = radius + extra[i];
+            if (dx * dx + dy * dy + dz * dz <= maxDist * maxDist)
+                mask |= uint64(1) << i;
+        }
+        return mask;
+    }
+
+    typedef uint64 (*InRangeFn)(float const*, float const*, float const*, float const*, uint32, float, float, float, float);
+
+    // Cell::VisitIndexedObjects, only the units the distance filter passes reach the check
+    uint64 SearchFlat(BenchMap& map, BenchUnit const& searcher, float radius, uint64& tested, InRangeFn inRange)
+    {
+        RangeCheck check(&searcher, radius);
+        float const x = searcher.GetPositionX();
+        float const y = searcher.GetPositionY();
+        float const reach = radius + searcher.GetCombatReach();
+        uint64 found = 0;
+        for (uint32 cy = map.CellOf(y - reach); cy <= map.CellOf(y + reach); ++cy)
+        {
+            for (uint32 cx = map.CellOf(x - reach); cx <= map.CellOf(x + reach); ++cx)
+            {
+                FlatCell const& cell = map.flat[cy * map.side + cx];
+                uint32 const size = uint32(cell.objects.size());
+                for (uint32 begin = 0; begin < size; begin += MaNGOS::DistanceFilter::BATCH_SIZE)
+                {
+                    uint32 count = std::min(size - begin, MaNGOS::DistanceFilter::BATCH_SIZE);
+                    uint64 survivors = inRange(&cell.x[begin], &cell.y[begin], &cell.z[begin], &cell.combatReach[begin], count,
+                                               x, y, searcher.GetPositionZ(), reach);
+                    while (survivors)
+                    {
+                        uint32 i = begin + uint32(std::countr_zero(survivors));
+                        survivors &= survivors - 1;
+                        ++tested;
+                        if (check(cell.objects[i]))
+                            ++found;
+                    }
+                }
+            }
+        }
+        return found;
+    }
+}
+
+void RunCellSearchBenchmark(BenchmarkOptions const& options)
+{
+    uint32 const densities[] = { 4, 16, 64, 256 };
+    float const radii[] = { 5.0f, 10.0f, 30.0f };
+
+    printf("%10s %7s %9s %8s %12s %12s %12s %13s %8s %8s\n", "units/cell", "radius", "searches", "found", "grid ns", "scalar ns", "flat ns",
+           "checks g/f", "speedup", "simd");
+    for (uint32 density : densities)
+    {
+        std::mt19937 rng(density);
+        BenchMap map;
+        BuildMap(map, density, rng);
+
+        for (float radius : radii)
+        {
+            // searchers stand on random units, in crowded cells a search touches up to nine cells
+            uint32 const searches = uint32(std::max<uint64>(UNIT_TESTS / (density * 9), 1000));
+            std::vector<BenchUnit const*> searchers(searches);
+            std::uniform_int_distribution<size_t> pick(0, map.units.size() - 1);
+            for (BenchUnit const*& searcher : searchers)
+                searcher = map.units[pick(rng)].get();
+
+            uint64 gridFound = 0, scalarFound = 0, flatFound = 0, gridTested = 0, scalarTested = 0, flatTested = 0;
+            uint64 const gridTime = MeasureBest(options.repeat, [&]()
+            {
+                gridFound = gridTested = 0;
+                for (BenchUnit const* searcher : searchers)
+                    gridFound += SearchGrid(map, *searcher, radius, gridTested);
+            });
+            uint64 const scalarTime = MeasureBest(options.repeat, [&]()
+            {
+                scalarFound = scalarTested = 0;
+                for (BenchUnit const* searcher : searchers)
+                    scalarFound += SearchFlat(map, *searcher, radius, scalarTested, InRangeScalar);
+            });
+            uint64 const flatTime = MeasureBest(options.repeat, [&]()
+            {
+                flatFound = flatTested = 0;
+                for (BenchUnit const* searcher : searchers)
+                    flatFound += SearchFlat(map, *searcher, radius, flatTested, MaNGOS::DistanceFilter::InRange);
+            });
+
+            if (gridFound != flatFound || scalarFound != flatFound)
+                printf("MISMATCH: grid found %llu units, scalar %llu, flat %llu\n", (unsigned long long)gridFound, (unsigned long long)scalarFound,
+                       (unsigned long long)flatFound);
+
+            printf("%10u %7.0f %9u %8.1f %12.1f %12.1f %12.1f %6.1f/%-6.1f %7.2fx %7.2fx\n", density, radius, searches, double(gridFound) / searches,
+                   double(gridTime) / searches, double(scalarTime) / searches, double(flatTime) / searches,
+                   double(gridTested) / searches, double(flatTested) / searches, double(gridTime) / double(flatTime),
+                   double(scalarTime) / double(flatTime));
+        }
+    }
+}
@@ -0,0 +1,310 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// The poly path of a chaser repathing to a wandering target every step, the way PathFinder::BuildPolyPath
+/// does it, once with a new findPath whenever the target left the old path and once patching the
+/// persistent dtPathCorridor first, with the checks of PathFinder::PatchCorridor. The navmesh is one
+/// synthetic tile of square polygons with pillars in the way.
+
+#include "Benchmark.h"
+
+#include <Detour/Include/DetourCommon.h>
+#include <Detour/Include/DetourNavMesh.h>
+#include <Detour/Include/DetourNavMeshBuilder.h>
+#include <Detour/Include/DetourNavMeshQuery.h>
+#include <DetourCrowd/Include/DetourPathCorridor.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+    uint32 const CELLS = 96;                                // polygons per side of the tile
+    float const CELL_SIZE = 2.0f;                           // yards per polygon
+    float const VOXEL_SIZE = 0.5f;                          // dtNavMeshCreateParams::cs
+    uint32 const MAX_POLYS = 74;                            // MAX_PATH_LENGTH
+    float const PATCH_SLOP = 0.5f;                          // CORRIDOR_PATCH_SLOP
+    uint32 const STEPS = 20000;                             // target steps of one yard per measurement
+    int const NVP = 6;                                      // DT_VERTS_PER_POLYGON of the mmaps
+    unsigned short const NULL_INDEX = 0xffff;
+    unsigned short const BORDER = 0x800f;
+}
+
+// one tile of open cells, about one in twelve cells is a pillar, shared with the path cache benchmark
+dtNavMesh* BuildBenchNavMesh()
+{
+    std::mt19937 rng(CELLS);
+    std::bernoulli_distribution pillar(0.08);
+    std::vector<int32> polyOfCell(CELLS * CELLS, -1);
+    uint32 polyCount = 0;
+    for (uint32 z = 0; z < CELLS; ++z)
+        for (uint32 x = 0; x < CELLS; ++x)
+            if (!pillar(rng) || (x > CELLS / 2 - 4 && x < CELLS / 2 + 4 && z > CELLS / 2 - 4 && z < CELLS / 2 + 4))
+                polyOfCell[z * CELLS + x] = int32(polyCount++);
+
+    unsigned short const step = (unsigned short)(CELL_SIZE / VOXEL_SIZE);
+    std::vector<unsigned short> verts;
+    for (uint32 z = 0; z <= CELLS; ++z)
+    {
+        for (uint32 x = 0; x <= CELLS; ++x)
+        {
+            verts.push_back((unsigned short)(x * step));
+            verts.push_back(0);
+            verts.push_back((unsigned short)(z * step));
+        }
+    }
+
+    std::vector<unsigned short> polys(polyCount * NVP * 2, NULL_INDEX);
+    for (uint32 z = 0; z < CELLS; ++z)
+    {
+        for (uint32 x = 0; x < CELLS; ++x)
+        {
+            int32 const poly = polyOfCell[z * CELLS + x];
+            if (poly < 0)
+                continue;
+
+            // corners and the cell behind the edge from each corner to the next
+            uint32 const corners[4][2] = { { x, z }, { x, z + 1 }, { x + 1, z + 1 }, { x + 1, z } };
+            int32 const neighbours[4][2] = { { int32(x) - 1, int32(z) }, { int32(x), int32(z) + 1 }, { int32(x) + 1, int32(z) }, { int32(x), int32(z) - 1 } };
+            unsigned short* p = &polys[poly * NVP * 2];
+            for (uint32 i = 0; i < 4; ++i)
+            {
+                p[i] = (unsigned short)(corners[i][1] * (CELLS + 1) + corners[i][0]);
+                int32 const nx = neighbours[i][0], nz = neighbours[i][1];
+                bool const inside = nx >= 0 && nz >= 0 && nx < int32(CELLS) && nz < int32(CELLS);
+                p[NVP + i] = inside && polyOfCell[nz * CELLS + nx] >= 0 ? (unsigned short)polyOfCell[nz * CELLS + nx] : BORDER;
+            }
+        }
+    }
+
+    std::vector<unsigned short> flags(polyCount, 1);
+    std::vector<unsigned char> areas(polyCount, 0);
+
+    dtNavMeshCreateParams params;
+    memset(&params, 0, sizeof(params));
+    params.verts = verts.data();
+    params.vertCount = int(verts.size() / 3);
+    params.polys = polys.data();
+    params.polyFlags = flags.data();
+    params.polyAreas = areas.data();
+    params.polyCount = int(polyCount);
+    params.nvp = NVP;
+    params.bmin[0] = params.bmin[1] = params.bmin[2] = 0.0f;
+    params.bmax[0] = params.bmax[2] = CELLS * CELL_SIZE;
+    params.bmax[1] = 2.0f;
+    params.walkableHeight = 2.0f;
+    params.walkableRadius = 0.5f;
+    params.walkableClimb = 1.0f;
+    params.cs = VOXEL_SIZE;
+    params.ch = VOXEL_SIZE;
+    params.buildBvTree = true;
+
+    unsigned char* data = nullptr;
+    int size = 0;
+    if (!dtCreateNavMeshData(&params, &data, &size))
+        return nullptr;
+
+    dtNavMesh* mesh = dtAllocNavMesh();
+    if (dtStatusFailed(mesh->init(data, size, DT_TILE_FREE_DATA)))
+    {
+        dtFreeNavMesh(mesh);
+        return nullptr;
+    }
+    return mesh;
+}
+
+namespace
+{
+    struct TrailPoint
+    {
+        float pos[3];
+        dtPolyRef poly;
+    };
+
+    // a target wandering one yard per step along the surface, turning away from pillars and borders
+    std::vector<TrailPoint> BuildTrail(dtNavMeshQuery const& query, dtQueryFilter const& filter)
+    {
+        std::mt19937 rng(STEPS);
+        std::uniform_real_distribution<float> turn(-0.4f, 0.4f);
+        std::bernoulli_distribution side(0.5);
+
+        float const center[3] = { CELLS * CELL_SIZE / 2, 0.0f, CELLS * CELL_SIZE / 2 };
+        float const extents[3] = { 2.0f, 4.0f, 2.0f };
+        TrailPoint point;
+        query.findNearestPoly(center, extents, &filter, &point.poly, point.pos);
+
+        std::vector<TrailPoint> trail;
+        trail.push_back(point);
+        float heading = 0.0f;
+        dtPolyRef visited[16];
+        while (trail.size() < STEPS)
+        {
+            heading += turn(rng);
+            float const wanted[3] = { point.pos[0] + std::cos(heading), point.pos[1], point.pos[2] + std::sin(heading) };
+            TrailPoint next;
+            int visitedCount = 0;
+            query.moveAlongSurface(point.poly, point.pos, wanted, &filter, next.pos, visited, &visitedCount, 16);
+            next.poly = visitedCount ? visited[visitedCount - 1] : point.poly;
+
+            // blocked, walk off to one side next time
+            if (dtVdist2DSqr(next.pos, point.pos) < 0.25f)
+                heading += side(rng) ? 1.57f : -1.57f;
+
+            point = next;
+            trail.push_back(point);
+        }
+        return trail;
+    }
+
+    struct PathState
+    {
+        dtPolyRef polys[MAX_POLYS];
+        int count = 0;
+        dtPathCorridor corridor;
+        bool corridorValid = false;
+
+        uint64 searches = 0;
+        uint64 patches = 0;
+        uint64 cuts = 0;
+        uint64 length = 0;
+    };
+
+    // the old path still contains both polygons, BuildPolyPath cuts the sub path out
+    bool CutPath(PathState& state, dtPolyRef startPoly, dtPolyRef endPoly)
+    {
+        int start = 0;
+        while (start < state.count && state.polys[start] != startPoly)
+            ++start;
+        if (start == state.count)
+            return false;
+
+        int end = state.count - 1;
+        while (end > start && state.polys[end] != endPoly)
+            --end;
+        if (end == start && startPoly != endPoly)
+            return false;
+
+        state.count = end - start + 1;
+        memmove(state.polys, state.polys + start, state.count * sizeof(dtPolyRef));
+        return true;
+    }
+
+    // PathFinder::PatchCorridor without the navmesh generation check, the tile never changes here
+    bool PatchCorridor(PathState& state, dtNavMeshQuery& query, dtQueryFilter const& filter, TrailPoint const& start, TrailPoint const& end)
+    {
+        if (!state.corridor.movePosition(start.pos, &query, &filter) || !state.corridor.moveTargetPosition(end.pos, &query, &filter))
+            return false;
+
+        if (state.corridor.getFirstPoly() != start.poly || state.corridor.getLastPoly() != end.poly ||
+            dtVdist2DSqr(state.corridor.getPos(), start.pos) > PATCH_SLOP * PATCH_SLOP ||
+            dtVdist2DSqr(state.corridor.getTarget(), end.pos) > PATCH_SLOP * PATCH_SLOP)
+            return false;
+
+        int const count = state.corridor.getPathCount();
+        if (count > int(MAX_POLYS))
+            return false;
+
+        return state.corridor.isValid(count, &query, &filter);
+    }
+
+    void BuildPolyPath(PathState& state, dtNavMeshQuery& query, dtQueryFilter const& filter, TrailPoint const& start, TrailPoint const& end, bool useCorridor)
+    {
+        bool const canPatch = useCorridor && state.corridorValid;
+        state.corridorValid = false;
+
+        if (CutPath(state, start.poly, end.poly))
+            ++state.cuts;
+        else if (canPatch && PatchCorridor(state, query, filter, start, end))
+        {
+            ++state.patches;
+            state.count = state.corridor.getPathCount();
+            memcpy(state.polys, state.corridor.getPath(), state.count * sizeof(dtPolyRef));
+        }
+        else
+        {
+            ++state.searches;
+            if (dtStatusFailed(query.findPath(start.poly, end.poly, start.pos, end.pos, &filter, state.polys, &state.count, MAX_POLYS)) || !state.count)
+            {
+                state.count = 0;
+                return;
+            }
+        }
+
+        state.length += state.count;
+
+        // PathFinder::SetCorridor
+        if (useCorridor)
+        {
+            state.corridor.reset(state.polys[0], start.pos);
+            state.corridor.setCorridor(end.pos, state.polys, state.count);
+            state.corridorValid = true;
+        }
+    }
+}
+
+void RunCorridorPatchBenchmark(BenchmarkOptions const& options)
+{
+    uint32 const distances[] = { 3, 10, 30 };
+
+    dtNavMesh* mesh = BuildBenchNavMesh();
+    dtNavMeshQuery* query = dtAllocNavMeshQuery();
+    if (!mesh || dtStatusFailed(query->init(mesh, 1024)))
+    {
+        printf("ERROR: could not build the navmesh\n");
+        dtFreeNavMeshQuery(query);
+        dtFreeNavMesh(mesh);
+        return;
+    }
+
+    dtQueryFilter filter;
+    std::vector<TrailPoint> const trail = BuildTrail(*query, filter);
+
+    printf("%8s %8s %9s %14s %12s %12s %8s\n", "distance", "repaths", "polys", "cut/patch/srch", "search ns", "corridor ns", "speedup");
+    for (uint32 distance : distances)
+    {
+        uint32 const repaths = uint32(trail.size()) - distance;
+        PathState searchState, corridorState;
+        searchState.corridor.init(MAX_POLYS * 3);
+        corridorState.corridor.init(MAX_POLYS * 3);
+
+        // the chaser walks the trail of the target, distance steps behind it
+        auto run = [&](PathState& state, bool useCorridor)
+        {
+            state.count = 0;
+            state.corridorValid = false;
+            state.searches = state.patches = state.cuts = state.length = 0;
+            for (uint32 i = distance; i < trail.size(); ++i)
+                BuildPolyPath(state, *query, filter, trail[i - distance], trail[i], useCorridor);
+        };
+
+        uint64 const searchTime = MeasureBest(options.repeat, [&]() { run(searchState, false); });
+        uint64 const corridorTime = MeasureBest(options.repeat, [&]() { run(corridorState, true); });
+
+        printf("%8u %8u %4.1f/%-4.1f %4.0f%%/%2.0f%%/%2.0f%% %12.1f %12.1f %7.2fx\n", distance, repaths,
+               double(searchState.length) / repaths, double(corridorState.length) / repaths,
+               100.0 * corridorState.cuts / repaths, 100.0 * corridorState.patches / repaths, 100.0 * corridorState.searches / repaths,
+               double(searchTime) / repaths, double(corridorTime) / repaths, double(searchTime) / double(corridorTime));
+    }
+
+    dtFreeNavMeshQuery(query);
+    dtFreeNavMesh(mesh);
+}
@@ -0,0 +1,266 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Loading a DBC store from synthetic .dbc files, once the way DBCFileLoader used to, the whole file
+/// read into the heap, converted into a structure copy and its string block copied, and once through
+/// DBCStorage as it is now, the file mapped and served in place where the format allows it.
+
+#include "Benchmark.h"
+#include "Database/DBCStore.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct DBCCase
+    {
+        char const* name;
+        std::string format;
+        uint32 records;
+    };
+
+    // record layout of the store, the size of each field as AutoProduceData writes it
+    size_t FieldSize(char field)
+    {
+        switch (field)
+        {
+            case FT_FLOAT: return sizeof(float);
+            case FT_IND:
+            case FT_INT: return sizeof(uint32);
+            case FT_BYTE: return sizeof(uint8);
+            case FT_STRING: return sizeof(char*);
+            default: return 0;
+        }
+    }
+
+    // writes a file of records with 4 byte fields, strings of 8 to 40 characters for the string fields
+    void WriteDBC(std::string const& path, std::string const& format, uint32 records)
+    {
+        std::mt19937 rng(records);
+        std::uniform_int_distribution<uint32> length(8, 40);
+
+        uint32 const fields = uint32(format.size());
+        std::vector<uint32> data(size_t(records) * fields);
+        std::string strings(1, '\0');
+        for (uint32 y = 0; y < records; ++y)
+        {
+            for (uint32 x = 0; x < fields; ++x)
+            {
+                uint32& value = data[size_t(y) * fields + x];
+                if (format[x] == FT_IND)
+                    value = y * 2 + 1;
+                else if (format[x] == FT_STRING)
+                {
+                    value = uint32(strings.size());
+                    strings.append(length(rng), char('a' + (x + y) % 26));
+                    strings.push_back('\0');
+                }
+                else
+                    value = rng();
+            }
+        }
+
+        uint32 const header[5] = { 0x43424457, records, fields, fields * 4, uint32(strings.size()) };
+        FILE* f = fopen(path.c_str(), "wb");
+        fwrite(header, sizeof(header), 1, f);
+        fwrite(data.data(), sizeof(uint32), data.size(), f);
+        fwrite(strings.data(), 1, strings.size(), f);
+        fclose(f);
+    }
+
+    // the store as DBCFileLoader built it before files were mapped
+    struct HeapStore
+    {
+        char* dataTable = nullptr;
+        char** indexTable = nullptr;
+        char* stringPool = nullptr;
+        uint32 count = 0;
+        size_t heapBytes = 0;
+
+        ~HeapStore()
+        {
+            delete[] dataTable;
+            delete[] indexTable;
+            delete[] stringPool;
+        }
+
+        bool Load(std::string const& path, std::string const& format)
+        {
+            FILE* f = fopen(path.c_str(), "rb");
+            if (!f)
+                return false;
+
+            uint32 header[5];
+            if (fread(header, sizeof(header), 1, f) != 1)
+            {
+                fclose(f);
+                return false;
+            }
+            uint32 const recordCount = header[1], fieldCount = header[2], recordSize = header[3], stringSize = header[4];
+
+            // DBCFileLoader::data, freed once the store is built
+            unsigned char* file = new unsigned char[recordSize * recordCount + stringSize];
+            if (fread(file, recordSize * recordCount + stringSize, 1, f) != 1)
+            {
+                fclose(f);
+                delete[] file;
+                return false;
+            }
+            fclose(f);
+            unsigned char const* stringTable = file + recordSize * recordCount;
+
+            int32 indexPos;
+            uint32 const structSize = DBCFileLoader::GetFormatRecordSize(format.c_str(), &indexPos);
+
+            // AutoProduceData, index table sized by the largest id, then every field converted
+            uint32 maxId = 0;
+            for (uint32 y = 0; y < recordCount; ++y)
+                maxId = std::max(maxId, *reinterpret_cast<uint32 const*>(file + y * recordSize + indexPos * 4));
+            count = maxId + 1;
+            indexTable = new char*[count]();
+            dataTable = new char[recordCount * structSize];
+
+            size_t offset = 0;
+            for (uint32 y = 0; y < recordCount; ++y)
+            {
+                unsigned char const* record = file + y * recordSize;
+                indexTable[*reinterpret_cast<uint32 const*>(record + indexPos * 4)] = &dataTable[offset];
+                for (uint32 x = 0; x < fieldCount; ++x)
+                {
+                    size_t const size = FieldSize(format[x]);
+                    if (format[x] == FT_STRING)
+                        *reinterpret_cast<char**>(&dataTable[offset]) = nullptr;
+                    else if (size)
+                        memcpy(&dataTable[offset], record + x * 4, size);
+                    offset += size;
+                }
+            }
+
+            // AutoProduceStrings, a copy of the string block the records point into
+            stringPool = new char[stringSize];
+            memcpy(stringPool, stringTable, stringSize);
+            offset = 0;
+            for (uint32 y = 0; y < recordCount; ++y)
+            {
+                for (uint32 x = 0; x < fieldCount; ++x)
+                {
+                    if (format[x] == FT_STRING)
+                        *reinterpret_cast<char**>(&dataTable[offset]) = stringPool + *reinterpret_cast<uint32 const*>(file + y * recordSize + x * 4);
+                    offset += FieldSize(format[x]);
+                }
+            }
+
+            // the file buffer only lives through the load
+            heapBytes = size_t(recordCount) * structSize + count * sizeof(char*) + stringSize;
+            delete[] file;
+            return true;
+        }
+
+        char const* LookupEntry(uint32 id) const { return id < count ? indexTable[id] : nullptr; }
+    };
+
+    // reads every field and every string of the store once, the first access pages mapped files in
+    template<class STORE>
+    uint64 Touch(STORE const& store, uint32 count, std::string const& format)
+    {
+        uint64 sum = 0;
+        for (uint32 id = 0; id < count; ++id)
+        {
+            char const* record = reinterpret_cast<char const*>(store.LookupEntry(id));
+            if (!record)
+                continue;
+
+            size_t offset = 0;
+            for (char field : format)
+            {
+                if (field == FT_STRING)
+                    sum += strlen(*reinterpret_cast<char* const*>(record + offset));
+                else if (FieldSize(field) == sizeof(uint32))
+                    sum += *reinterpret_cast<uint32 const*>(record + offset);
+                else if (FieldSize(field) == sizeof(uint8))
+                    sum += *reinterpret_cast<uint8 const*>(record + offset);
+                offset += FieldSize(field);
+            }
+        }
+        return sum;
+    }
+}
+
+void RunDBCLoadBenchmark(BenchmarkOptions const& options)
+{
+    // Spell.dbc sized records with strings and skipped fields, and a plain integer table served in place
+    std::string spellFormat = "n";
+    for (uint32 i = 1; i < 173; ++i)
+        spellFormat += "iiifxiisx"[i % 9];
+    DBCCase const cases[] =
+    {
+        { "converted", spellFormat, 22000 },
+        { "in place", "niiiiiffffii", 200000 },
+    };
+
+    std::filesystem::path const dir = std::filesystem::temp_directory_path();
+
+    printf("%10s %8s %8s %11s %11s %11s %11s %9s %9s\n", "format", "records", "file KB", "heap ms", "mapped ms", "heap+t ms", "mapped+t ms", "heap KB", "mapped KB");
+    for (DBCCase const& entry : cases)
+    {
+        std::string const path = (dir / ("cmangos_benchmark_" + std::to_string(entry.records) + ".dbc")).string();
+        WriteDBC(path, entry.format, entry.records);
+        uintmax_t const fileSize = std::filesystem::file_size(path);
+
+        uint64 heapSum = 0, mappedSum = 0;
+        size_t heapBytes = 0, mappedBytes = 0;
+        auto loadHeap = [&](bool touch)
+        {
+            HeapStore store;
+            store.Load(path, entry.format);
+            heapBytes = store.heapBytes;
+            if (touch)
+                heapSum = Touch(store, store.count, entry.format);
+        };
+        auto loadMapped = [&](bool touch)
+        {
+            DBCStorage<char> store(entry.format.c_str());
+            store.Load(path.c_str());
+            // only the index table and converted records are on the heap, strings stay in the mapping
+            mappedBytes = store.GetNumRows() * sizeof(char*);
+            if (entry.format.find_first_not_of("nifb") != std::string::npos)
+                mappedBytes += size_t(entry.records) * DBCFileLoader::GetFormatRecordSize(entry.format.c_str());
+            if (touch)
+                mappedSum = Touch(store, store.GetNumRows(), entry.format);
+        };
+
+        uint64 const heapTime = MeasureBest(options.repeat, [&]() { loadHeap(false); });
+        uint64 const mappedTime = MeasureBest(options.repeat, [&]() { loadMapped(false); });
+        uint64 const heapTouchTime = MeasureBest(options.repeat, [&]() { loadHeap(true); });
+        uint64 const mappedTouchTime = MeasureBest(options.repeat, [&]() { loadMapped(true); });
+
+        if (heapSum != mappedSum)
+            printf("MISMATCH: heap store read %llu, mapped store %llu\n", (unsigned long long)heapSum, (unsigned long long)mappedSum);
+
+        printf("%10s %8u %8.0f %11.2f %11.2f %11.2f %11.2f %9.0f %9.0f\n", entry.name, entry.records, double(fileSize) / 1024,
+               heapTime / 1e6, mappedTime / 1e6, heapTouchTime / 1e6, mappedTouchTime / 1e6, double(heapBytes) / 1024, double(mappedBytes) / 1024);
+
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,194 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// The event queues of many units ticking at the world update rate, once with the multimap
+/// EventProcessor used to keep its events in and once with the binary heap of EventProcessor.
+/// Every event requeues itself like periodic events do, and a share of one shot events is added
+/// and destroyed every tick.
+
+#include "Benchmark.h"
+#include "Utilities/EventProcessor.h"
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    uint32 const TICK = 50;                                 // world update interval in ms
+    uint32 const TICKS = 200;                               // ticks per measurement
+    uint64 const EVENTS = 40000;                            // events queued over all units
+
+    // EventProcessor as it was, a multimap from execution time to event
+    class MultimapEventProcessor
+    {
+        public:
+            MultimapEventProcessor() : m_time(0) {}
+            ~MultimapEventProcessor()
+            {
+                for (auto& event : m_events)
+                    delete event.second;
+            }
+
+            void Update(uint32 p_time)
+            {
+                m_time += p_time;
+
+                std::multimap<uint64, BasicEvent*>::iterator i;
+                while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+                {
+                    BasicEvent* Event = i->second;
+                    m_events.erase(i);
+
+                    if (Event->Execute(m_time, p_time))
+                        delete Event;
+                }
+            }
+
+            void AddEvent(BasicEvent* Event, uint64 e_time)
+            {
+                Event->m_addTime = m_time;
+                Event->m_execTime = e_time;
+                m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+            }
+
+            uint64 CalculateTime(uint64 t_offset) const { return m_time + t_offset; }
+
+        private:
+            uint64 m_time;
+            std::multimap<uint64, BasicEvent*> m_events;
+    };
+
+    // records the execution order, both queues have to run events due together in insertion order
+    struct Trace
+    {
+        uint64 executed = 0;
+        uint64 hash = 0;
+
+        void Record(uint32 id)
+        {
+            ++executed;
+            hash = hash * 1000003 + id;
+        }
+    };
+
+    // a periodic event, requeued on every execution until its owner goes away
+    template<class PROCESSOR>
+    class PeriodicEvent : public BasicEvent
+    {
+        public:
+            PeriodicEvent(PROCESSOR& owner, Trace& trace, uint32 id, uint32 period) : m_owner(owner), m_trace(trace), m_id(id), m_period(period) {}
+
+            bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+            {
+                m_trace.Record(m_id);
+                m_owner.AddEvent(this, m_owner.CalculateTime(m_period));
+                return false;
+            }
+
+        private:
+            PROCESSOR& m_owner;
+            Trace& m_trace;
+            uint32 m_id;
+            uint32 m_period;
+    };
+
+    // a delayed spell hit or despawn, destroyed after it ran
+    class OneShotEvent : public BasicEvent
+    {
+        public:
+            OneShotEvent(Trace& trace, uint32 id) : m_trace(trace), m_id(id) {}
+
+            bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+            {
+                m_trace.Record(m_id);
+                return true;
+            }
+
+        private:
+            Trace& m_trace;
+            uint32 m_id;
+    };
+
+    template<class PROCESSOR>
+    void Simulate(uint32 units, uint32 eventsPerUnit, uint32 oneShotsPerTick, Trace& trace)
+    {
+        std::mt19937 rng(units);
+        std::uniform_int_distribution<uint32> period(1, 100);       // 50 ms to 5 s in ticks
+        std::uniform_int_distribution<uint32> delay(0, 40);
+        std::uniform_int_distribution<uint32> pick(0, units - 1);
+
+        std::vector<std::unique_ptr<PROCESSOR>> processors;
+        processors.reserve(units);
+        uint32 id = 0;
+        for (uint32 i = 0; i < units; ++i)
+        {
+            processors.emplace_back(new PROCESSOR());
+            for (uint32 j = 0; j < eventsPerUnit; ++j)
+            {
+                uint32 const eventPeriod = period(rng) * TICK;
+                processors[i]->AddEvent(new PeriodicEvent<PROCESSOR>(*processors[i], trace, id++, eventPeriod), processors[i]->CalculateTime(eventPeriod));
+            }
+        }
+
+        for (uint32 tick = 0; tick < TICKS; ++tick)
+        {
+            for (uint32 i = 0; i < oneShotsPerTick; ++i)
+            {
+                PROCESSOR& processor = *processors[pick(rng)];
+                processor.AddEvent(new OneShotEvent(trace, id++), processor.CalculateTime(delay(rng) * TICK));
+            }
+
+            for (auto& processor : processors)
+                processor->Update(TICK);
+        }
+    }
+}
+
+void RunEventQueueBenchmark(BenchmarkOptions const& options)
+{
+    uint32 const eventsPerUnit[] = { 1, 4, 16, 64 };
+
+    printf("%11s %7s %10s %12s %12s %12s %8s\n", "events/unit", "units", "executed", "map ns/ev", "heap ns/ev", "heap ms", "speedup");
+    for (uint32 perUnit : eventsPerUnit)
+    {
+        uint32 const units = uint32(EVENTS / perUnit);
+        uint32 const oneShots = units / 20;
+
+        Trace mapTrace, heapTrace;
+        uint64 const mapTime = MeasureBest(options.repeat, [&]()
+        {
+            mapTrace = Trace();
+            Simulate<MultimapEventProcessor>(units, perUnit, oneShots, mapTrace);
+        });
+        uint64 const heapTime = MeasureBest(options.repeat, [&]()
+        {
+            heapTrace = Trace();
+            Simulate<EventProcessor>(units, perUnit, oneShots, heapTrace);
+        });
+
+        if (mapTrace.hash != heapTrace.hash || mapTrace.executed != heapTrace.executed)
+            printf("MISMATCH: events ran in a different order\n");
+
+        printf("%11u %7u %10llu %12.1f %12.1f %12.1f %7.2fx\n", perUnit, units, (unsigned long long)heapTrace.executed,
+               double(mapTime) / mapTrace.executed, double(heapTime) / heapTrace.executed, heapTime / 1e6, double(mapTime) / double(heapTime));
+    }
+}
@@ -0,0 +1,171 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// A player running into a grid that was not loaded, once loading all objects of the grid at
+/// entry and once with GridLoading.Staged, the cell the player stands in at entry and the cells it
+/// runs into loaded at once, the others by the map updates within GridLoading.TickBudget. Loading
+/// an object is a stand-in spending a fixed time, LoadFromDB needs a database and a map.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    uint32 const CELLS = 16;                                // MAX_NUMBER_OF_CELLS
+    float const CELL_SIZE = 533.33333f / CELLS;             // SIZE_OF_GRID_CELL
+    uint32 const TICK = 50;                                 // map update interval in ms
+    float const RUN_SPEED = 7.0f;                           // yards per second
+    uint32 const TICKS = 200;                               // map updates followed after the entry, ten seconds
+    uint32 const BUDGET = 5;                                // GridLoading.TickBudget default in ms
+
+    // Creature::LoadFromDB, the object is built and added to the map
+    struct BenchObject
+    {
+        uint8 data[2800];
+    };
+
+    void LoadObject(std::vector<std::unique_ptr<BenchObject>>& objects, uint32 cost)
+    {
+        Clock::time_point const end = Clock::now() + std::chrono::microseconds(cost);
+        objects.emplace_back(new BenchObject());
+        while (Clock::now() < end)
+            ;
+    }
+
+    struct BenchGrid
+    {
+        std::vector<uint32> spawns;                         // objects per cell
+        std::bitset<CELLS * CELLS> loaded;                  // NGrid::i_loadedCells
+        std::vector<std::unique_ptr<BenchObject>> objects;
+
+        void LoadCell(uint32 cell, uint32 cost)
+        {
+            for (uint32 i = 0; i < spawns[cell]; ++i)
+                LoadObject(objects, cost);
+            loaded.set(cell);
+        }
+    };
+
+    // spawns spread unevenly like a grid with a town and open land around it
+    std::vector<uint32> BuildSpawns(uint32 total, std::mt19937& rng)
+    {
+        std::vector<double> weights(CELLS * CELLS);
+        std::exponential_distribution<double> weight(1.0);
+        for (double& w : weights)
+            w = std::pow(weight(rng), 3);
+        std::discrete_distribution<uint32> cell(weights.begin(), weights.end());
+
+        std::vector<uint32> spawns(CELLS * CELLS, 0);
+        for (uint32 i = 0; i < total; ++i)
+            ++spawns[cell(rng)];
+        return spawns;
+    }
+
+    struct LoadResult
+    {
+        double entry = 0.0;                                 // ms of the map update the player entered in
+        double worst = 0.0;                                 // ms of the slowest later map update
+        uint32 complete = 0;                                // map updates until every cell was loaded
+    };
+
+    double Elapsed(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // the player enters at the west border and runs east through the middle of the grid
+    LoadResult Simulate(std::vector<uint32> const& spawns, uint32 cost, bool staged)
+    {
+        BenchGrid grid;
+        grid.spawns = spawns;
+        grid.objects.reserve(std::accumulate(spawns.begin(), spawns.end(), 0u));
+
+        LoadResult result;
+        float x = 0.0f, y = CELL_SIZE * CELLS / 2;
+        for (uint32 tick = 0; tick < TICKS; ++tick)
+        {
+            Clock::time_point const start = Clock::now();
+            uint32 const cell = std::min(uint32(x / CELL_SIZE), CELLS - 1) * CELLS + uint32(y / CELL_SIZE);
+
+            // Map::EnsureGridLoaded, from player entry and PlayerRelocation
+            if (!staged && tick == 0)
+            {
+                for (uint32 i = 0; i < CELLS * CELLS; ++i)
+                    grid.LoadCell(i, cost);
+            }
+            else if (!grid.loaded.test(cell))
+                grid.LoadCell(cell, cost);
+
+            // Map::UpdateStagedGridLoading
+            if (staged && tick > 0)
+            {
+                for (uint32 i = 0; i < CELLS * CELLS && !grid.loaded.all(); ++i)
+                {
+                    if (grid.loaded.test(i))
+                        continue;
+                    grid.LoadCell(i, cost);
+                    if (Elapsed(start) >= BUDGET)
+                        break;
+                }
+            }
+
+            double const duration = Elapsed(start);
+            if (tick == 0)
+                result.entry = duration;
+            else
+                result.worst = std::max(result.worst, duration);
+            if (!result.complete && grid.loaded.all())
+                result.complete = tick + 1;
+
+            x += RUN_SPEED * TICK / 1000;
+        }
+        return result;
+    }
+}
+
+void RunGridLoadBenchmark(BenchmarkOptions const& /*options*/)
+{
+    uint32 const totals[] = { 300, 1500 };                  // open land, a town
+    uint32 const costs[] = { 20, 100 };                     // us per object
+
+    printf("%8s %8s %12s %12s %12s %12s %10s\n", "objects", "cost us", "full entry", "staged entry", "full worst", "staged worst", "complete");
+    for (uint32 total : totals)
+    {
+        std::mt19937 rng(total);
+        std::vector<uint32> const spawns = BuildSpawns(total, rng);
+        for (uint32 cost : costs)
+        {
+            LoadResult const full = Simulate(spawns, cost, false);
+            LoadResult const staged = Simulate(spawns, cost, true);
+
+            printf("%8u %8u %12.2f %12.2f %12.2f %12.2f %10u\n", total, cost, full.entry, staged.entry, full.worst, staged.worst, staged.complete);
+        }
+    }
+}
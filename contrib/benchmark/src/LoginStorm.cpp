@@ -0,0 +1,199 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// A storm of logons arriving at realmd at once, every logon a challenge, a proof and a realm list
+/// request, with login database queries simulated by waiting for a fixed latency. Once the way
+/// AuthSocket used to run the queries, synchronously on the listener thread, and once the way it
+/// does now, on the threads of LoginQueryPool with the continuation posted back to the listener.
+
+#include "Benchmark.h"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    uint32 const LOGONS = 200;                              // clients connecting at the same moment
+    uint32 const STEPS = 3;                                 // logon challenge, logon proof, realm list
+    // queries of each step before, ip ban, account and account ban, then the session key update and
+    // the account id, then the gm level and the character count of each of the two realms
+    uint32 const OLD_QUERIES[STEPS] = { 3, 2, 3 };
+    // and now, the account id comes from the challenge and the realm list is one joined query
+    uint32 const NEW_QUERIES[STEPS] = { 3, 1, 1 };
+
+    // LoginQueryPool
+    class QueryPool
+    {
+        public:
+            void Start(uint32 threads)
+            {
+                m_context.restart();
+                m_work = std::make_unique<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>(m_context.get_executor());
+                for (uint32 i = 0; i < std::max(threads, 1u); ++i)
+                    m_threads.emplace_back([this]() { m_context.run(); });
+            }
+
+            void Stop()
+            {
+                m_work.reset();
+                for (std::thread& thread : m_threads)
+                    thread.join();
+                m_threads.clear();
+            }
+
+            template<class Executor, class Query, class Handler>
+            void Execute(Executor const& executor, Query&& query, Handler&& handler)
+            {
+                boost::asio::post(m_context, [executor, query = std::forward<Query>(query), handler = std::forward<Handler>(handler)]() mutable
+                {
+                    auto result = query();
+                    boost::asio::post(executor, [result = std::move(result), handler = std::move(handler)]() mutable
+                    {
+                        handler(std::move(result));
+                    });
+                });
+            }
+
+        private:
+            boost::asio::io_context m_context;
+            std::unique_ptr<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> m_work;
+            std::vector<std::thread> m_threads;
+    };
+
+    // every thread querying holds a connection of its own, so queries only wait for the database
+    void Query(std::chrono::microseconds latency, uint32 count)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            std::this_thread::sleep_for(latency);
+    }
+
+    struct Storm
+    {
+        Storm(boost::asio::io_context& context, std::chrono::microseconds latency) :
+            listener(context), work(boost::asio::make_work_guard(context)), latency(latency) {}
+
+        boost::asio::io_context& listener;
+        boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work;
+        std::chrono::microseconds latency;
+        Clock::time_point start;
+        std::vector<double> latencies;                      // ms from arrival to the realm list
+
+        void Finished()
+        {
+            latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+            if (latencies.size() == LOGONS)
+                work.reset();
+        }
+    };
+
+    // the handler queries and answers, the next packet of the client is handled afterwards
+    void OldStep(Storm& storm, uint32 step)
+    {
+        if (step == STEPS)
+        {
+            storm.Finished();
+            return;
+        }
+
+        Query(storm.latency, OLD_QUERIES[step]);
+        boost::asio::post(storm.listener, [&storm, step]() { OldStep(storm, step + 1); });
+    }
+
+    // the handler hands the queries to the pool and answers when the result is posted back
+    void NewStep(Storm& storm, QueryPool& pool, uint32 step)
+    {
+        if (step == STEPS)
+        {
+            storm.Finished();
+            return;
+        }
+
+        pool.Execute(storm.listener.get_executor(), [latency = storm.latency, step]() { Query(latency, NEW_QUERIES[step]); return true; },
+                     [&storm, &pool, step](bool) { NewStep(storm, pool, step + 1); });
+    }
+
+    struct StormResult
+    {
+        double total = 0.0;                                 // ms until the last logon finished
+        double p50 = 0.0;
+        double p99 = 0.0;
+    };
+
+    // runs the storm repeat times and keeps the run that finished first
+    template<class START>
+    StormResult RunStorm(uint32 repeat, std::chrono::microseconds latency, START&& start)
+    {
+        StormResult best;
+        for (uint32 i = 0; i < std::max(repeat, 1u); ++i)
+        {
+            boost::asio::io_context context;
+            Storm storm(context, latency);
+            storm.start = Clock::now();
+            for (uint32 logon = 0; logon < LOGONS; ++logon)
+                boost::asio::post(context, [&storm, &start]() { start(storm); });
+            context.run();
+
+            std::sort(storm.latencies.begin(), storm.latencies.end());
+            StormResult result;
+            result.total = storm.latencies.back();
+            result.p50 = storm.latencies[storm.latencies.size() / 2];
+            result.p99 = storm.latencies[storm.latencies.size() * 99 / 100];
+            if (!i || result.total < best.total)
+                best = result;
+        }
+        return best;
+    }
+}
+
+void RunLoginStormBenchmark(BenchmarkOptions const& options)
+{
+    uint32 const latencies[] = { 200, 1000 };              // microseconds per query
+
+    printf("%6s %5s %10s %10s %10s %10s %10s %10s\n", "db ms", "conns", "old p50", "old p99", "old/s", "new p50", "new p99", "new/s");
+    for (uint32 latencyUs : latencies)
+    {
+        std::chrono::microseconds const latency(latencyUs);
+
+        // the listener thread queried on the one connection realmd used to open
+        StormResult const old = RunStorm(options.repeat, latency, [](Storm& storm) { OldStep(storm, 0); });
+
+        uint32 const connectionCounts[] = { 1, options.threads };
+        for (uint32 connections : connectionCounts)
+        {
+            QueryPool pool;
+            pool.Start(connections);
+            StormResult const result = RunStorm(options.repeat, latency, [&pool](Storm& storm) { NewStep(storm, pool, 0); });
+            pool.Stop();
+
+            printf("%6.1f %5u %10.1f %10.1f %10.0f %10.1f %10.1f %10.0f\n", latencyUs / 1000.0, connections,
+                   old.p50, old.p99, LOGONS * 1000.0 / old.total, result.p50, result.p99, LOGONS * 1000.0 / result.total);
+
+            if (connections == options.threads)
+                break;
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Microbenchmarks of hot server data structures, each one comparing the current layout or
+/// algorithm against the one it replaced on synthetic data.
+
+#include "Common.h"
+#include "Benchmark.h"
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct BenchmarkEntry
+    {
+        char const* name;
+        char const* description;
+        void (*run)(BenchmarkOptions const& options);
+    };
+
+    BenchmarkEntry const s_benchmarks[] =
+    {
+        { "broadcast", "packet broadcast through per receiver copies and through shared gathered writes", &RunBroadcastBenchmark },
+        { "cellsearch", "unit range search over grid reference lists and the flat cell index", &RunCellSearchBenchmark },
+        { "compress", "update packet compression through a stream per packet and through the reset per thread stream", &RunUpdateCompressBenchmark },
+        { "corridor", "chase repaths through full path searches and through the patched path corridor", &RunCorridorPatchBenchmark },
+        { "dbcload", "DBC store loading through a heap copy and through the mapped file", &RunDBCLoadBenchmark },
+        { "events", "unit event queues as a multimap and as the EventProcessor heap", &RunEventQueueBenchmark },
+        { "gridload", "map update times of a player entering a grid loaded at once and with staged loading", &RunGridLoadBenchmark },
+        { "loginstorm", "realmd logons with queries on the listener thread and on the login query pool", &RunLoginStormBenchmark },
+        { "mapschedule", "map updates of a world tick through the shared queue and through the work stealing MapUpdater", &RunMapScheduleBenchmark },
+#ifdef BUILD_METRICS
+        { "metrics", "per unit duration metrics as tagged measurements and as registered series", &RunMetricSeriesBenchmark },
+#endif
+        { "packetpool", "received packets through new and delete and through the WorldPacketPool", &RunPacketPoolBenchmark },
+        { "pathcache", "full repaths through findPath and through the PolyPathCache", &RunPathCacheBenchmark },
+        { "receive", "client packet framing through two reads per packet and through the socket receive buffer", &RunReceiveFramingBenchmark },
+        { "spawnqueue", "pending respawns of a map in a scanned vector and in the ordered spawn queue", &RunSpawnQueueBenchmark },
+        { "tickflush", "socket writes and packet latency of immediate and tick aligned flushing", &RunTickFlushBenchmark },
+        { "tickprofile", "the cost of a profiler zone not recording and recording, and the ring memory per thread", &RunTickProfileBenchmark },
+        { "visibility", "client guid lists as a set and as a flat set, and visibility updates of stepped and incremental mode", &RunVisibilityBenchmark },
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+    std::vector<std::string> names;
+
+    boost::program_options::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "print usage message")
+    ("list,l", "list the benchmarks")
+    ("run,r", boost::program_options::value<std::vector<std::string>>(&names), "benchmark to run, all when omitted")
+    ("repeat", boost::program_options::value<uint32>(&options.repeat)->default_value(options.repeat), "runs per measurement, the fastest one is reported")
+    ("threads,t", boost::program_options::value<uint32>(&options.threads)->default_value(options.threads), "producer threads of the contention benchmarks");
+
+    boost::program_options::positional_options_description positional;
+    positional.add("run", -1);
+
+    boost::program_options::variables_map vm;
+
+    try
+    {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv).options(desc).positional(positional).run(), vm);
+        boost::program_options::notify(vm);
+    }
+    catch (boost::program_options::error const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    if (vm.count("list"))
+    {
+        for (BenchmarkEntry const& entry : s_benchmarks)
+            printf("%-14s %s\n", entry.name, entry.description);
+        return 0;
+    }
+
+    if (!options.threads)
+        options.threads = 1;
+
+    for (std::string const& name : names)
+    {
+        bool found = false;
+        for (BenchmarkEntry const& entry : s_benchmarks)
+            found |= name == entry.name;
+        if (!found)
+        {
+            std::cerr << "ERROR: unknown benchmark " << name << ", see --list" << std::endl;
+            return 1;
+        }
+    }
+
+    for (BenchmarkEntry const& entry : s_benchmarks)
+    {
+        if (!names.empty() && std::find(names.begin(), names.end(), entry.name) == names.end())
+            continue;
+
+        printf("=== %s: %s ===\n", entry.name, entry.description);
+        entry.run(options);
+        printf("\n");
+    }
+    return 0;
+}
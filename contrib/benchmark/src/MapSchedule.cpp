@@ -0,0 +1,238 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// The map updates of one world tick handed to the update threads, once through the single shared
+/// queue MapUpdater used to have, with a heap allocated worker per map, and once through the work
+/// stealing deques of MapUpdater, with the reused workers and the task group of MapManager.
+
+#include "Benchmark.h"
+#include "Maps/MapUpdater.h"
+#include "Util/ProducerConsumerQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // MapUpdater as it was, workers report their completion themselves
+    class QueueMapUpdater
+    {
+        public:
+            QueueMapUpdater() : _cancelationToken(false), pending_requests(0) {}
+
+            void activate(size_t num_threads)
+            {
+                for (size_t i = 0; i < num_threads; ++i)
+                    _workerThreads.push_back(std::thread(&QueueMapUpdater::WorkerThread, this));
+            }
+
+            void deactivate()
+            {
+                _cancelationToken = true;
+
+                _queue.Cancel();
+
+                for (auto& thread : _workerThreads)
+                    thread.join();
+            }
+
+            void wait()
+            {
+                std::unique_lock<std::mutex> lock(_lock);
+
+                while (pending_requests > 0)
+                    _condition.wait(lock);
+            }
+
+            void update_finished()
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+
+                --pending_requests;
+                _condition.notify_all();
+            }
+
+            void schedule_update(Worker* worker)
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+
+                ++pending_requests;
+                _queue.Push(std::move(worker));
+            }
+
+        private:
+            ProducerConsumerQueue<Worker*> _queue;
+
+            std::vector<std::thread> _workerThreads;
+            std::atomic<bool> _cancelationToken;
+
+            std::mutex _lock;
+            std::condition_variable _condition;
+            size_t pending_requests;
+
+            void WorkerThread()
+            {
+                while (true)
+                {
+                    Worker* request = nullptr;
+
+                    _queue.WaitAndPop(request);
+
+                    if (_cancelationToken)
+                    {
+                        delete request;
+                        return;
+                    }
+
+                    request->execute();
+
+                    delete request;
+                }
+            }
+    };
+
+    // a map whose update takes cost microseconds, spent sleeping so the update threads overlap like
+    // on as many cores as there are threads whatever the machine running the benchmark has
+    struct BenchMap
+    {
+        uint32 id;
+        uint32 cost;
+    };
+
+    void UpdateMap(BenchMap const& map)
+    {
+        if (map.cost)
+            std::this_thread::sleep_for(std::chrono::microseconds(map.cost));
+    }
+
+    // MapUpdateWorker as it was
+    class QueueMapWorker : public Worker
+    {
+        public:
+            QueueMapWorker(BenchMap const& map, QueueMapUpdater& updater) : m_map(map), m_updater(updater) {}
+
+            void execute() override
+            {
+                UpdateMap(m_map);
+                m_updater.update_finished();
+            }
+
+        private:
+            BenchMap const& m_map;
+            QueueMapUpdater& m_updater;
+    };
+
+    // MapUpdateWorker
+    class MapWorker : public Worker
+    {
+        public:
+            explicit MapWorker(BenchMap const& map) : m_map(map) {}
+
+            void execute() override { UpdateMap(m_map); }
+
+        private:
+            BenchMap const& m_map;
+    };
+
+    // two continents and instances of a tenth of their cost or less, in map id order like MapManager::i_maps
+    std::vector<BenchMap> BuildMaps(uint32 count, uint32 continentCost)
+    {
+        std::mt19937 rng(count);
+        std::uniform_int_distribution<uint32> instanceCost(continentCost / 40, continentCost / 10);
+
+        std::vector<BenchMap> maps;
+        for (uint32 i = 0; i < count; ++i)
+            maps.push_back({ i, i < 2 ? continentCost : instanceCost(rng) });
+        return maps;
+    }
+
+    // world ticks through the old updater, returns the fastest tick in ns
+    uint64 RunQueueTicks(std::vector<BenchMap> const& maps, uint32 threads, uint32 ticks)
+    {
+        QueueMapUpdater updater;
+        updater.activate(threads);
+
+        uint64 best = MeasureBest(ticks, [&]()
+        {
+            for (BenchMap const& map : maps)
+                updater.schedule_update(new QueueMapWorker(map, updater));
+            updater.wait();
+        });
+
+        updater.deactivate();
+        return best;
+    }
+
+    // world ticks as MapManager::Update does them now, returns the fastest tick in ns
+    uint64 RunStealingTicks(std::vector<BenchMap> const& maps, uint32 threads, uint32 ticks)
+    {
+        MapUpdater updater;
+        updater.activate(threads);
+
+        // cheapest first, the threads start with the newest task of their own deque
+        std::vector<BenchMap const*> scheduled;
+        for (BenchMap const& map : maps)
+            scheduled.push_back(&map);
+        std::sort(scheduled.begin(), scheduled.end(), [](BenchMap const* left, BenchMap const* right) { return left->cost < right->cost; });
+
+        MapUpdater::TaskGroup group;
+        std::vector<MapWorker> workers;
+        uint64 best = MeasureBest(ticks, [&]()
+        {
+            workers.clear();
+            workers.reserve(scheduled.size());
+            for (BenchMap const* map : scheduled)
+            {
+                workers.emplace_back(*map);
+                updater.schedule_update(workers.back(), group);
+            }
+            updater.wait(group);
+        });
+
+        updater.deactivate();
+        return best;
+    }
+}
+
+void RunMapScheduleBenchmark(BenchmarkOptions const& options)
+{
+    uint32 const mapCounts[] = { 8, 64, 512 };
+    uint32 const continentCosts[] = { 0, 10000 };           // empty updates, then a continent update of 10 ms
+
+    printf("%6s %7s %8s %12s %12s %8s\n", "maps", "cont us", "threads", "queue us", "stealing us", "speedup");
+    for (uint32 continentCost : continentCosts)
+    {
+        for (uint32 count : mapCounts)
+        {
+            std::vector<BenchMap> const maps = BuildMaps(count, continentCost);
+            // the fastest of many ticks, the empty ticks are short enough for a few hundred
+            uint32 const ticks = continentCost ? std::max(options.repeat, 1u) * 4 : std::max(options.repeat, 1u) * 100;
+
+            uint64 const queueTime = RunQueueTicks(maps, options.threads, ticks);
+            uint64 const stealingTime = RunStealingTicks(maps, options.threads, ticks);
+
+            printf("%6u %7u %8u %12.1f %12.1f %7.2fx\n", count, continentCost, options.threads,
+                   queueTime / 1e3, stealingTime / 1e3, double(queueTime) / double(stealingTime));
+        }
+    }
+}
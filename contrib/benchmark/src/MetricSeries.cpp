@@ -0,0 +1,116 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// The per unit duration metric of Unit::Update staying under its threshold, once as the tagged
+/// metric::duration it used to be and once as the metric::timer recording into a series, with
+/// series recording on and off. Also prints the memory of the series slots every recording
+/// thread holds. Only built with BUILD_METRICS.
+
+#include "Benchmark.h"
+
+#ifdef BUILD_METRICS
+
+#include "Metric/Metric.h"
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    uint32 const CALLS = 200000;                            // unit updates per measurement
+
+    struct BenchUnit
+    {
+        uint32 entry;
+        uint32 guidLow;
+        uint32 guidHigh;
+        uint32 mapId;
+        uint32 instanceId;
+    };
+
+    // Unit::Update before the series
+    void UpdateDuration(BenchUnit const& unit)
+    {
+        metric::duration<std::chrono::microseconds> meas("unit.update", {
+            { "entry", std::to_string(unit.entry) },
+            { "guid", std::to_string(unit.guidLow) },
+            { "unit_type", std::to_string(unit.guidHigh) },
+            { "map_id", std::to_string(unit.mapId) },
+            { "instance_id", std::to_string(unit.instanceId) }
+        }, 1000);
+    }
+
+    // Unit::Update
+    void UpdateTimer(BenchUnit const& unit)
+    {
+        static metric::series_id const series = metric::register_series("unit.update", metric::series_type::histogram);
+        metric::timer<std::chrono::microseconds> meas(series, 1000, [&unit](metric::measurement& outlier)
+        {
+            outlier.add_tag("entry", std::to_string(unit.entry));
+            outlier.add_tag("guid", std::to_string(unit.guidLow));
+            outlier.add_tag("unit_type", std::to_string(unit.guidHigh));
+            outlier.add_tag("map_id", std::to_string(unit.mapId));
+            outlier.add_tag("instance_id", std::to_string(unit.instanceId));
+        });
+    }
+}
+
+void RunMetricSeriesBenchmark(BenchmarkOptions const& options)
+{
+    BenchUnit const unit = { 12345, 987654, 0xF130, 530, 0 };
+
+    uint64 const durationTime = MeasureBest(options.repeat, [&]()
+    {
+        for (uint32 i = 0; i < CALLS; ++i)
+            UpdateDuration(unit);
+    });
+
+    metric::set_recording(false);
+    uint64 const idleTime = MeasureBest(options.repeat, [&]()
+    {
+        for (uint32 i = 0; i < CALLS; ++i)
+            UpdateTimer(unit);
+    });
+
+    metric::set_recording(true);
+    uint64 const timerTime = MeasureBest(options.repeat, [&]()
+    {
+        for (uint32 i = 0; i < CALLS; ++i)
+            UpdateTimer(unit);
+    });
+    metric::set_recording(false);
+
+    uint64 samples = 0;
+    for (metric::series_summary const& summary : metric::collect())
+        samples += summary.count;
+    if (samples != uint64(CALLS) * std::max(options.repeat, 1u))
+        printf("MISMATCH: collected %llu samples\n", (unsigned long long)samples);
+
+    printf("%22s %10s\n", "ns per unit update", "");
+    printf("%22s %10.1f\n", "tagged duration", double(durationTime) / CALLS);
+    printf("%22s %10.1f\n", "timer, not recording", double(idleTime) / CALLS);
+    printf("%22s %10.1f\n", "timer, recording", double(timerTime) / CALLS);
+
+    // series_slot of Series.cpp, a slot for every possible series in each thread that recorded once
+    size_t const slotSize = 3 * sizeof(std::atomic<uint64>) + metric::HISTOGRAM_BUCKETS * sizeof(std::atomic<uint32>);
+    printf("\nseries slots per recording thread: %u series x %u bytes = %.1f KB\n", metric::MAX_SERIES, uint32(slotSize),
+           metric::MAX_SERIES * slotSize / 1024.0);
+}
+
+#endif
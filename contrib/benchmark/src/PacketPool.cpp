@@ -0,0 +1,148 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Received packets created by the network thread and freed by the world thread after handling,
+/// once with a new WorldPacket for every packet like WorldSocket used to make, and once taken from
+/// and given back to the WorldPacketPool.
+
+#include "Benchmark.h"
+#include "Server/WorldPacketPool.h"
+
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    uint32 const PACKETS = 500000;                          // packets received per measurement
+    uint32 const BURST = 4;                                 // packets read from one socket at once
+
+    // packet sizes of the client stream, movement mostly with some chat and spell casts
+    std::vector<uint16> BuildSizes(std::mt19937& rng)
+    {
+        std::uniform_int_distribution<uint32> kind(0, 9), small(16, 40), large(40, 300);
+        std::vector<uint16> sizes(PACKETS);
+        for (uint16& size : sizes)
+            size = uint16(kind(rng) < 8 ? small(rng) : large(rng));
+        return sizes;
+    }
+
+    // WorldSocket::ProcessIncomingData, the body copied into the new packet
+    template<bool POOLED>
+    std::unique_ptr<WorldPacket> Receive(uint8 const* data, uint16 size)
+    {
+        std::unique_ptr<WorldPacket> packet = POOLED ? sWorldPacketPool.Acquire(MSG_MOVE_HEARTBEAT, size) : std::make_unique<WorldPacket>(MSG_MOVE_HEARTBEAT, size);
+        packet->append(data, size);
+        return packet;
+    }
+
+    // WorldSession::Update, the handler reads the packet then it is dropped
+    template<bool POOLED>
+    uint64 Handle(std::unique_ptr<WorldPacket> packet)
+    {
+        uint64 sum = packet->size() + packet->contents()[packet->size() - 1];
+        if (POOLED)
+            sWorldPacketPool.Release(std::move(packet));
+        return sum;
+    }
+
+    // both sides on one thread, the cost of the allocations alone
+    template<bool POOLED>
+    uint64 RunSingle(std::vector<uint16> const& sizes, std::vector<uint8> const& data)
+    {
+        uint64 sum = 0;
+        std::vector<std::unique_ptr<WorldPacket>> queue;
+        for (size_t i = 0; i < sizes.size(); i += BURST)
+        {
+            for (size_t j = i; j < std::min(sizes.size(), i + BURST); ++j)
+                queue.push_back(Receive<POOLED>(data.data(), sizes[j]));
+            for (std::unique_ptr<WorldPacket>& packet : queue)
+                sum += Handle<POOLED>(std::move(packet));
+            queue.clear();
+        }
+        return sum;
+    }
+
+    // a network thread queueing for the world thread through a locked deque like WorldSession::m_recvQueue,
+    // the world thread swaps it out every millisecond
+    template<bool POOLED>
+    uint64 RunThreaded(std::vector<uint16> const& sizes, std::vector<uint8> const& data)
+    {
+        std::mutex lock;
+        std::deque<std::unique_ptr<WorldPacket>> queue;
+        bool done = false;
+
+        std::thread network([&]()
+        {
+            for (size_t i = 0; i < sizes.size(); i += BURST)
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                for (size_t j = i; j < std::min(sizes.size(), i + BURST); ++j)
+                    queue.push_back(Receive<POOLED>(data.data(), sizes[j]));
+            }
+            std::lock_guard<std::mutex> guard(lock);
+            done = true;
+        });
+
+        uint64 sum = 0;
+        std::deque<std::unique_ptr<WorldPacket>> handled;
+        while (true)
+        {
+            bool finished;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                std::swap(queue, handled);
+                finished = done;
+            }
+            for (std::unique_ptr<WorldPacket>& packet : handled)
+                sum += Handle<POOLED>(std::move(packet));
+            handled.clear();
+            if (finished && queue.empty())
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        network.join();
+        return sum;
+    }
+}
+
+void RunPacketPoolBenchmark(BenchmarkOptions const& options)
+{
+    std::mt19937 rng(PACKETS);
+    std::vector<uint16> const sizes = BuildSizes(rng);
+    std::vector<uint8> const data(300, 0x2A);
+
+    printf("%10s %12s %12s %8s\n", "mode", "new ns", "pool ns", "speedup");
+    for (bool threaded : { false, true })
+    {
+        uint64 newSum = 0, poolSum = 0;
+        uint64 const newTime = MeasureBest(options.repeat, [&]() { newSum = threaded ? RunThreaded<false>(sizes, data) : RunSingle<false>(sizes, data); });
+        uint64 const poolTime = MeasureBest(options.repeat, [&]() { poolSum = threaded ? RunThreaded<true>(sizes, data) : RunSingle<true>(sizes, data); });
+
+        if (newSum != poolSum)
+            printf("MISMATCH: handled %llu and %llu\n", (unsigned long long)newSum, (unsigned long long)poolSum);
+
+        printf("%10s %12.1f %12.1f %7.2fx\n", threaded ? "threaded" : "single", double(newTime) / PACKETS, double(poolTime) / PACKETS,
+               double(newTime) / double(poolTime));
+    }
+}
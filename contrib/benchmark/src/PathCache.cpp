@@ -0,0 +1,183 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Full repaths of PathFinder::BuildPolyPath, the case where neither end is on the old path, once
+/// always through dtNavMeshQuery::findPath and once through the PolyPathCache first, on the
+/// synthetic navmesh tile of the corridor benchmark. Followers stand around a target that stands
+/// still, or a pack follows a wandering target along its trail.
+
+#include "Benchmark.h"
+#include "MotionGenerators/PolyPathCache.h"
+
+#include <Detour/Include/DetourNavMesh.h>
+#include <Detour/Include/DetourNavMeshQuery.h>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    float const MESH_SIZE = 96 * 2.0f;                      // yards per side of BuildBenchNavMesh
+    uint32 const MAX_POLYS = 74;                            // MAX_PATH_LENGTH
+    uint32 const CACHE_SIZE = 1024;                         // PathFinder.CacheSize default
+    uint32 const FOLLOWERS = 10;
+    uint32 const STEPS = 4000;                              // repaths of every follower per measurement
+
+    struct PathEnd
+    {
+        float pos[3];
+        dtPolyRef poly;
+    };
+
+    struct PathRequest
+    {
+        PathEnd start;
+        PathEnd end;
+    };
+
+    PathEnd NearestPoly(dtNavMeshQuery const& query, dtQueryFilter const& filter, float x, float z)
+    {
+        float const point[3] = { x, 0.0f, z };
+        float const extents[3] = { 2.0f, 4.0f, 2.0f };
+        PathEnd end;
+        query.findNearestPoly(point, extents, &filter, &end.poly, end.pos);
+        return end;
+    }
+
+    // followers standing in a ring of 5 to 20 yards around a target that stands still, a caster pack
+    // waiting for the target to come out of line of sight
+    std::vector<PathRequest> BuildStanding(dtNavMeshQuery const& query, dtQueryFilter const& filter)
+    {
+        std::mt19937 rng(FOLLOWERS);
+        std::uniform_real_distribution<float> angle(0.0f, 6.28f), radius(5.0f, 20.0f);
+        PathEnd const target = NearestPoly(query, filter, MESH_SIZE / 2, MESH_SIZE / 2);
+
+        std::vector<PathEnd> followers;
+        for (uint32 i = 0; i < FOLLOWERS; ++i)
+        {
+            float const a = angle(rng), r = radius(rng);
+            followers.push_back(NearestPoly(query, filter, MESH_SIZE / 2 + std::cos(a) * r, MESH_SIZE / 2 + std::sin(a) * r));
+        }
+
+        std::vector<PathRequest> requests;
+        for (uint32 step = 0; step < STEPS; ++step)
+            for (PathEnd const& follower : followers)
+                requests.push_back({ follower, target });
+        return requests;
+    }
+
+    // a target wandering a yard per step and a pack following 3 to 12 yards behind on its trail
+    std::vector<PathRequest> BuildPack(dtNavMeshQuery const& query, dtQueryFilter const& filter)
+    {
+        std::mt19937 rng(STEPS);
+        std::uniform_real_distribution<float> turn(-0.4f, 0.4f);
+
+        std::vector<PathEnd> trail;
+        trail.push_back(NearestPoly(query, filter, MESH_SIZE / 2, MESH_SIZE / 2));
+        float heading = 0.0f;
+        dtPolyRef visited[16];
+        while (trail.size() < STEPS + FOLLOWERS + 3)
+        {
+            PathEnd const& point = trail.back();
+            heading += turn(rng);
+            float const wanted[3] = { point.pos[0] + std::cos(heading), point.pos[1], point.pos[2] + std::sin(heading) };
+            PathEnd next;
+            int visitedCount = 0;
+            query.moveAlongSurface(point.poly, point.pos, wanted, &filter, next.pos, visited, &visitedCount, 16);
+            next.poly = visitedCount ? visited[visitedCount - 1] : point.poly;
+            if (std::fabs(next.pos[0] - point.pos[0]) + std::fabs(next.pos[2] - point.pos[2]) < 0.5f)
+                heading += 1.57f;
+            trail.push_back(next);
+        }
+
+        std::vector<PathRequest> requests;
+        for (uint32 step = FOLLOWERS + 3; step < trail.size(); ++step)
+            for (uint32 i = 0; i < FOLLOWERS; ++i)
+                requests.push_back({ trail[step - 3 - i], trail[step] });
+        return requests;
+    }
+
+    // the findPath branch of PathFinder::BuildPolyPath, returns the summed path lengths
+    uint64 Repath(std::vector<PathRequest> const& requests, dtNavMesh const* mesh, dtNavMeshQuery& query, dtQueryFilter const& filter, bool useCache)
+    {
+        dtPolyRef path[MAX_POLYS];
+        uint64 total = 0;
+        for (PathRequest const& request : requests)
+        {
+            PolyPathCache& cache = PolyPathCache::Instance(useCache ? CACHE_SIZE : 0);
+            PolyPathCache::Key key = { mesh, request.start.poly, request.end.poly, cache.IsEnabled() ? PolyPathCache::HashFilter(filter) : 0 };
+            uint32 length = 0;
+            if (!cache.IsEnabled() || !cache.Find(key, 0, path, length, MAX_POLYS))
+            {
+                int count = 0;
+                if (dtStatusSucceed(query.findPath(request.start.poly, request.end.poly, request.start.pos, request.end.pos, &filter, path, &count, MAX_POLYS)) && count)
+                    cache.Insert(key, 0, path, uint32(count));
+                length = uint32(count);
+            }
+            total += length;
+        }
+        return total;
+    }
+}
+
+void RunPathCacheBenchmark(BenchmarkOptions const& options)
+{
+    dtNavMesh* mesh = BuildBenchNavMesh();
+    dtNavMeshQuery* query = dtAllocNavMeshQuery();
+    if (!mesh || dtStatusFailed(query->init(mesh, 1024)))
+    {
+        printf("ERROR: could not build the navmesh\n");
+        dtFreeNavMeshQuery(query);
+        dtFreeNavMesh(mesh);
+        return;
+    }
+
+    dtQueryFilter filter;
+    struct Scenario
+    {
+        char const* name;
+        std::vector<PathRequest> requests;
+    };
+    Scenario const scenarios[] = { { "standing", BuildStanding(*query, filter) }, { "pack", BuildPack(*query, filter) } };
+
+    // findPath weighs the polygons by the positions in the end polygons, a corridor cached for other
+    // positions on the same polygons can differ, the polys column shows the average lengths
+    printf("%9s %9s %8s %11s %12s %12s %8s\n", "followers", "repaths", "hits", "polys", "findPath ns", "cache ns", "speedup");
+    for (Scenario const& scenario : scenarios)
+    {
+        uint64 searchLength = 0, cacheLength = 0, hits = 0, misses = 0;
+        uint64 const searchTime = MeasureBest(options.repeat, [&]() { searchLength = Repath(scenario.requests, mesh, *query, filter, false); });
+        PolyPathCache::ConsumeMetrics(hits, misses);
+        uint64 const cacheTime = MeasureBest(options.repeat, [&]()
+        {
+            PolyPathCache::Instance(0);                     // start empty
+            cacheLength = Repath(scenario.requests, mesh, *query, filter, true);
+        });
+        PolyPathCache::ConsumeMetrics(hits, misses);
+
+        size_t const repaths = scenario.requests.size();
+        printf("%9s %9u %7.1f%% %5.3f/%-5.3f %12.1f %12.1f %7.2fx\n", scenario.name, uint32(repaths), 100.0 * hits / double(hits + misses),
+               double(searchLength) / repaths, double(cacheLength) / repaths, double(searchTime) / repaths, double(cacheTime) / repaths, double(searchTime) / double(cacheTime));
+    }
+
+    dtFreeNavMeshQuery(query);
+    dtFreeNavMesh(mesh);
+}
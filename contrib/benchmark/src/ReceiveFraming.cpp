@@ -0,0 +1,233 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Client packets read from a loopback connection, once the way WorldSocket::ProcessIncomingData used
+/// to read them, one read for the header and one for the body into buffers of their own which were
+/// then copied into the packet, and once the way it does now, a read of whatever arrived into the
+/// receive buffer of the socket and every complete packet in it framed in place.
+
+#include "Benchmark.h"
+#include "Util/ByteBuffer.h"
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    size_t const HEADER_SIZE = 6;                           // ClientPktHeader
+    size_t const READ_BUFFER = 16 * 1024;                   // WORLD_SOCKET_READ_BUFFER
+    uint32 const PACKETS = 200000;                          // client packets per measurement
+
+    // sWorldPacketPool, packets are handed back once the session handled them
+    class PacketPool
+    {
+        public:
+            std::unique_ptr<ByteBuffer> Acquire(size_t size)
+            {
+                if (m_free.empty())
+                    return std::make_unique<ByteBuffer>(size);
+                std::unique_ptr<ByteBuffer> packet = std::move(m_free.back());
+                m_free.pop_back();
+                packet->clear();
+                packet->reserve(size);
+                return packet;
+            }
+            void Release(std::unique_ptr<ByteBuffer> packet) { m_free.push_back(std::move(packet)); }
+
+        private:
+            std::vector<std::unique_ptr<ByteBuffer>> m_free;
+    };
+
+    struct Received
+    {
+        uint64 packets = 0;
+        uint64 reads = 0;
+        uint64 checksum = 0;
+    };
+
+    // the session handles the packet and its buffer goes back to the pool
+    void HandlePacket(PacketPool& pool, uint32 cmd, std::unique_ptr<ByteBuffer> packet, Received& received)
+    {
+        received.checksum += cmd + packet->size();
+        ++received.packets;
+        pool.Release(std::move(packet));
+    }
+
+    // header and body read separately into buffers of their own
+    void ReadPerPacket(boost::asio::ip::tcp::socket& socket, PacketPool& pool, size_t bytes, Received& received)
+    {
+        size_t consumed = 0;
+        while (consumed < bytes)
+        {
+            std::shared_ptr<std::array<uint8, HEADER_SIZE>> header = std::make_shared<std::array<uint8, HEADER_SIZE>>();
+            boost::asio::read(socket, boost::asio::buffer(header->data(), HEADER_SIZE));
+            ++received.reads;
+
+            uint16 const size = uint16((*header)[0] << 8 | (*header)[1]);
+            uint32 cmd;
+            memcpy(&cmd, header->data() + 2, sizeof(cmd));
+
+            std::shared_ptr<std::vector<uint8>> body = std::make_shared<std::vector<uint8>>(size - 4);
+            if (!body->empty())
+            {
+                boost::asio::read(socket, boost::asio::buffer(body->data(), body->size()));
+                ++received.reads;
+            }
+
+            std::unique_ptr<ByteBuffer> packet = pool.Acquire(body->size());
+            packet->append(*body);
+            consumed += HEADER_SIZE + body->size();
+            HandlePacket(pool, cmd, std::move(packet), received);
+        }
+    }
+
+    // everything that arrived read at once, complete packets framed in the receive buffer
+    struct ReceiveBuffer
+    {
+        std::vector<uint8> data = std::vector<uint8>(READ_BUFFER);
+        size_t start = 0;
+        size_t end = 0;
+    };
+
+    void ReadBuffered(boost::asio::ip::tcp::socket& socket, PacketPool& pool, ReceiveBuffer& buffer, size_t bytes, Received& received)
+    {
+        size_t consumed = 0;
+        while (consumed < bytes)
+        {
+            if (buffer.start > 0)
+            {
+                if (buffer.end > buffer.start)
+                    memmove(buffer.data.data(), buffer.data.data() + buffer.start, buffer.end - buffer.start);
+                buffer.end -= buffer.start;
+                buffer.start = 0;
+            }
+
+            buffer.end += socket.read_some(boost::asio::buffer(buffer.data.data() + buffer.end, buffer.data.size() - buffer.end));
+            ++received.reads;
+
+            while (buffer.end - buffer.start >= HEADER_SIZE)
+            {
+                uint8 const* header = buffer.data.data() + buffer.start;
+                uint16 const size = uint16(header[0] << 8 | header[1]);
+                size_t const packetSize = size - 4;
+                if (buffer.end - buffer.start < HEADER_SIZE + packetSize)
+                    break;
+
+                uint32 cmd;
+                memcpy(&cmd, header + 2, sizeof(cmd));
+
+                std::unique_ptr<ByteBuffer> packet = pool.Acquire(packetSize);
+                packet->append(header + HEADER_SIZE, packetSize);
+                buffer.start += HEADER_SIZE + packetSize;
+                consumed += HEADER_SIZE + packetSize;
+                HandlePacket(pool, cmd, std::move(packet), received);
+            }
+        }
+    }
+
+    // a client stream of mostly movement sized packets, split into bursts of whole packets
+    std::vector<uint8> BuildStream(uint32 burst, std::vector<size_t>& bursts)
+    {
+        std::mt19937 rng(burst);
+        std::discrete_distribution<uint32> kind({ 70, 25, 5 });
+        std::uniform_int_distribution<uint32> small(0, 24), medium(24, 120), large(120, 600);
+
+        std::vector<uint8> stream;
+        size_t burstBytes = 0;
+        for (uint32 i = 0; i < PACKETS; ++i)
+        {
+            uint32 const kinds[] = { small(rng), medium(rng), large(rng) };
+            uint32 const body = 4 + kinds[kind(rng)];
+            uint32 const cmd = 0xB5 + i % 16;           // MSG_MOVE_*
+            stream.push_back(uint8((body + 4) >> 8));
+            stream.push_back(uint8(body + 4));
+            stream.insert(stream.end(), reinterpret_cast<uint8 const*>(&cmd), reinterpret_cast<uint8 const*>(&cmd) + sizeof(cmd));
+            for (uint32 j = 0; j < body; ++j)
+                stream.push_back(uint8(i + j));
+
+            burstBytes += HEADER_SIZE + body;
+            if ((i + 1) % burst == 0 || i + 1 == PACKETS)
+            {
+                bursts.push_back(burstBytes);
+                burstBytes = 0;
+            }
+        }
+        return stream;
+    }
+
+    // sends the stream burst after burst, each burst is read completely before the next one goes out
+    template<class READ>
+    void Replay(boost::asio::ip::tcp::socket& client, std::vector<uint8> const& stream, std::vector<size_t> const& bursts, READ&& read)
+    {
+        size_t offset = 0;
+        for (size_t bytes : bursts)
+        {
+            boost::asio::write(client, boost::asio::buffer(stream.data() + offset, bytes));
+            read(bytes);
+            offset += bytes;
+        }
+    }
+}
+
+void RunReceiveFramingBenchmark(BenchmarkOptions const& options)
+{
+    uint32 const bursts[] = { 1, 4, 16, 64 };
+
+    boost::asio::io_context context;
+    boost::asio::ip::tcp::acceptor acceptor(context, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    boost::asio::ip::tcp::socket client(context), server(context);
+    client.connect(acceptor.local_endpoint());
+    acceptor.accept(server);
+    client.set_option(boost::asio::ip::tcp::no_delay(true));
+
+    printf("%12s %13s %13s %13s %13s %9s %8s\n", "pkts/arrival", "reads old/new", "old ns/pkt", "new ns/pkt", "old pkt/s", "new pkt/s", "speedup");
+    for (uint32 burst : bursts)
+    {
+        std::vector<size_t> burstBytes;
+        std::vector<uint8> const stream = BuildStream(burst, burstBytes);
+
+        PacketPool oldPool, newPool;
+        ReceiveBuffer buffer;
+        Received oldReceived, newReceived;
+        uint64 const oldTime = MeasureBest(options.repeat, [&]()
+        {
+            oldReceived = Received();
+            Replay(client, stream, burstBytes, [&](size_t bytes) { ReadPerPacket(server, oldPool, bytes, oldReceived); });
+        });
+        uint64 const newTime = MeasureBest(options.repeat, [&]()
+        {
+            newReceived = Received();
+            Replay(client, stream, burstBytes, [&](size_t bytes) { ReadBuffered(server, newPool, buffer, bytes, newReceived); });
+        });
+
+        if (oldReceived.checksum != newReceived.checksum || oldReceived.packets != newReceived.packets)
+            printf("MISMATCH: old path received %llu packets, new path %llu\n", (unsigned long long)oldReceived.packets, (unsigned long long)newReceived.packets);
+
+        printf("%12u %6.2f/%-6.2f %13.1f %13.1f %13.0f %9.0f %7.2fx\n", burst,
+               double(oldReceived.reads) / oldReceived.packets, double(newReceived.reads) / newReceived.packets,
+               double(oldTime) / PACKETS, double(newTime) / PACKETS,
+               PACKETS * 1e9 / double(oldTime), PACKETS * 1e9 / double(newTime), double(oldTime) / double(newTime));
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// The pending respawns of a map, once in the unsorted vector SpawnManager used to scan completely
+/// on every map update and once in the multimap keyed by respawn time it keeps them in now. Killed
+/// creatures are queued at the rate respawns are due, so the queue keeps its size.
+
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <map>
+#include <vector>
+
+namespace
+{
+    uint32 const TICK = 100;                                // map update interval in ms
+    uint32 const TICKS = 3000;                              // map updates per measurement, five minutes
+    uint64 const MIN_DELAY = 5 * 60 * 1000;                 // respawn delays of five minutes
+    uint64 const MAX_DELAY = 2 * 60 * 60 * 1000;            // to two hours
+
+    // SpawnInfo, constructing it for the map always succeeds here
+    struct BenchSpawn
+    {
+        BenchSpawn(uint64 when, uint32 dbguid) : respawnTime(when), dbguid(dbguid) {}
+
+        uint64 respawnTime;
+        uint32 dbguid;
+    };
+
+    // SpawnManager as it was
+    struct VectorQueue
+    {
+        std::vector<BenchSpawn> spawns;
+
+        void Add(uint64 when, uint32 dbguid) { spawns.emplace_back(when, dbguid); }
+
+        template<class SPAWNED>
+        void Update(uint64 now, SPAWNED&& spawned)
+        {
+            for (auto itr = spawns.begin(); itr != spawns.end();)
+            {
+                if (itr->respawnTime <= now && spawned(*itr))
+                    itr = spawns.erase(itr);
+                else
+                    ++itr;
+            }
+        }
+    };
+
+    // SpawnManager::SpawnQueue
+    struct OrderedQueue
+    {
+        std::multimap<uint64, BenchSpawn> spawns;
+
+        void Add(uint64 when, uint32 dbguid) { spawns.emplace(when, BenchSpawn(when, dbguid)); }
+
+        template<class SPAWNED>
+        void Update(uint64 now, SPAWNED&& spawned)
+        {
+            for (auto itr = spawns.begin(); itr != spawns.end() && itr->first <= now;)
+            {
+                if (spawned(itr->second))
+                    itr = spawns.erase(itr);
+                else
+                    ++itr;
+            }
+        }
+    };
+
+    // respawn delay of a creature killed at the given time, independent of the order the queue visits spawns in
+    uint64 RespawnDelay(uint32 dbguid, uint64 now)
+    {
+        uint64 x = (uint64(dbguid) << 32 | (now / TICK)) * 0x9E3779B97F4A7C15ull;
+        x ^= x >> 31;
+        return MIN_DELAY + x % (MAX_DELAY - MIN_DELAY);
+    }
+
+    // every respawned creature dies again and is queued with a new respawn delay, returns the time spent in the ticks
+    template<class QUEUE>
+    uint64 Simulate(uint32 pending, uint64& respawned, uint64& checksum)
+    {
+        QUEUE queue;
+        uint64 now = 0;
+        for (uint32 i = 0; i < pending; ++i)
+            queue.Add(RespawnDelay(i, now) - MIN_DELAY, i);
+
+        std::vector<uint32> killed;
+        return MeasureBest(1, [&]()
+        {
+            for (uint32 tick = 0; tick < TICKS; ++tick)
+            {
+                now += TICK;
+                queue.Update(now, [&](BenchSpawn const& spawn)
+                {
+                    checksum += spawn.dbguid * now;
+                    killed.push_back(spawn.dbguid);
+                    return true;
+                });
+
+                // AddCreature after the update, inserting during it is deferred
+                for (uint32 dbguid : killed)
+                    queue.Add(now + RespawnDelay(dbguid, now), dbguid);
+                respawned += killed.size();
+                killed.clear();
+            }
+        });
+    }
+}
+
+void RunSpawnQueueBenchmark(BenchmarkOptions const& options)
+{
+    uint32 const pendingCounts[] = { 1000, 10000, 50000 };
+
+    printf("%8s %10s %14s %15s %8s\n", "pending", "respawns", "vector ns/tick", "ordered ns/tick", "speedup");
+    for (uint32 pending : pendingCounts)
+    {
+        // filling the queue is left out, only the map updates are timed
+        uint64 vectorTime = std::numeric_limits<uint64>::max(), orderedTime = std::numeric_limits<uint64>::max();
+        uint64 vectorSum = 0, orderedSum = 0, vectorRespawns = 0, orderedRespawns = 0;
+        for (uint32 i = 0; i < std::max(options.repeat, 1u); ++i)
+        {
+            vectorSum = orderedSum = vectorRespawns = orderedRespawns = 0;
+            vectorTime = std::min(vectorTime, Simulate<VectorQueue>(pending, vectorRespawns, vectorSum));
+            orderedTime = std::min(orderedTime, Simulate<OrderedQueue>(pending, orderedRespawns, orderedSum));
+        }
+
+        if (vectorSum != orderedSum || vectorRespawns != orderedRespawns)
+            printf("MISMATCH: vector queue respawned %llu, ordered queue %llu\n", (unsigned long long)vectorRespawns, (unsigned long long)orderedRespawns);
+
+        printf("%8u %10llu %14.1f %15.1f %7.2fx\n", pending, (unsigned long long)orderedRespawns,
+               double(vectorTime) / TICKS, double(orderedTime) / TICKS, double(vectorTime) / double(orderedTime));
+    }
+}
@@ -0,0 +1,276 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Packets sent to sessions over loopback connections during map updates, once with
+/// Network.TickAlignedFlush = 0, a write started as soon as a packet is queued and no write is
+/// outstanding, and once with Network.TickAlignedFlush = 1, the queued packets written when the
+/// session is flushed at the end of the tick. Runs in real time at the world tick rate.
+
+#include "Benchmark.h"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    uint32 const TICK = 50;                                 // world update interval in ms
+    uint32 const TICKS = 40;                                // ticks per measurement
+    uint32 const STEPS = 10;                                // map update steps queueing packets, over the first half of the tick
+    size_t const OUT_BUFFER = 65536;                        // Network.OutUBuff
+
+    struct SendStats
+    {
+        uint64 writes = 0;
+        uint64 bytes = 0;
+        std::vector<double> latencies;                      // ms from queueing a packet to its write completing
+    };
+
+    // WorldSocket::OutBuffer, with the time every packet was queued at
+    struct OutBuffer
+    {
+        std::vector<uint8> data;
+        std::vector<Clock::time_point> queued;
+
+        bool empty() const { return data.empty(); }
+        void clear() { data.clear(); queued.clear(); }
+    };
+
+    // the sending side of WorldSocket
+    class BenchSocket : public std::enable_shared_from_this<BenchSocket>
+    {
+        public:
+            BenchSocket(boost::asio::ip::tcp::socket socket, bool tickAligned) :
+                m_socket(std::move(socket)), m_tickAligned(tickAligned), m_writing(false), m_flushPending(false) {}
+
+            void SendPacket(uint8 const* data, size_t size)
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+
+                m_outBuffer.data.insert(m_outBuffer.data.end(), data, data + size);
+                m_outBuffer.queued.push_back(Clock::now());
+
+                if (!m_writing && MustWrite())
+                    StartWrite();
+            }
+
+            void Flush()
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+
+                if (m_writing)
+                    m_flushPending = true;
+                else if (!m_outBuffer.empty())
+                    StartWrite();
+            }
+
+            SendStats const& GetStats() const { return m_stats; }
+
+        private:
+            bool MustWrite() const { return !m_outBuffer.empty() && (!m_tickAligned || m_outBuffer.data.size() >= OUT_BUFFER); }
+
+            void StartWrite()
+            {
+                std::swap(m_writeBuffer, m_outBuffer);
+                m_flushPending = false;
+                m_writing = true;
+
+                auto self(shared_from_this());
+                boost::asio::async_write(m_socket, boost::asio::buffer(m_writeBuffer.data), [self](boost::system::error_code const& /*error*/, std::size_t /*written*/)
+                {
+                    std::lock_guard<std::mutex> guard(self->m_lock);
+
+                    Clock::time_point const now = Clock::now();
+                    ++self->m_stats.writes;
+                    self->m_stats.bytes += self->m_writeBuffer.data.size();
+                    for (Clock::time_point queued : self->m_writeBuffer.queued)
+                        self->m_stats.latencies.push_back(std::chrono::duration<double, std::milli>(now - queued).count());
+                    self->m_writeBuffer.clear();
+
+                    if (self->m_outBuffer.empty() || (!self->m_flushPending && !self->MustWrite()))
+                    {
+                        self->m_writing = false;
+                        return;
+                    }
+
+                    self->StartWrite();
+                });
+            }
+
+            boost::asio::ip::tcp::socket m_socket;
+            bool m_tickAligned;
+            std::mutex m_lock;
+            OutBuffer m_outBuffer;
+            OutBuffer m_writeBuffer;
+            bool m_writing;
+            bool m_flushPending;
+            SendStats m_stats;
+    };
+
+    // the client, reads whatever arrives
+    struct BenchClient
+    {
+        explicit BenchClient(boost::asio::io_context& context) : socket(context), data(64 * 1024), received(0) {}
+
+        void Read()
+        {
+            socket.async_read_some(boost::asio::buffer(data), [this](boost::system::error_code const& error, std::size_t bytes)
+            {
+                received += bytes;
+                if (!error)
+                    Read();
+            });
+        }
+
+        boost::asio::ip::tcp::socket socket;
+        std::vector<uint8> data;
+        std::atomic<uint64> received;
+    };
+
+    struct FlushResult
+    {
+        double writes = 0.0;                                // socket writes per session and tick
+        double p50 = 0.0;
+        double p99 = 0.0;
+        double cpu = 0.0;                                   // process cpu ms per tick
+        uint64 sent = 0;
+        uint64 received = 0;
+    };
+
+    FlushResult Simulate(uint32 sessions, bool tickAligned)
+    {
+        boost::asio::io_context context;
+        auto work = boost::asio::make_work_guard(context);
+        boost::asio::ip::tcp::acceptor acceptor(context, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+
+        std::vector<std::unique_ptr<BenchClient>> clients;
+        std::vector<std::shared_ptr<BenchSocket>> sockets;
+        for (uint32 i = 0; i < sessions; ++i)
+        {
+            clients.emplace_back(new BenchClient(context));
+            clients.back()->socket.connect(acceptor.local_endpoint());
+            boost::asio::ip::tcp::socket server(context);
+            acceptor.accept(server);
+            server.set_option(boost::asio::ip::tcp::no_delay(true));
+            sockets.push_back(std::make_shared<BenchSocket>(std::move(server), tickAligned));
+            clients.back()->Read();
+        }
+
+        // the network thread
+        std::thread network([&context]() { context.run(); });
+
+        std::mt19937 rng(sessions);
+        std::uniform_int_distribution<uint32> perStep(0, 3), size(8, 200);
+        std::vector<uint8> packet(256, 0x2A);
+
+        uint64 sent = 0;
+        std::clock_t const cpuStart = std::clock();
+        Clock::time_point tickStart = Clock::now();
+        for (uint32 tick = 0; tick < TICKS; ++tick)
+        {
+            // the map update, every step sends the movement, spell and update packets it produced
+            for (uint32 step = 0; step < STEPS; ++step)
+            {
+                for (auto& socket : sockets)
+                {
+                    for (uint32 count = perStep(rng); count > 0; --count)
+                    {
+                        uint32 const bytes = size(rng);
+                        socket->SendPacket(packet.data(), bytes);
+                        sent += bytes;
+                    }
+                }
+                std::this_thread::sleep_until(tickStart + std::chrono::microseconds(TICK * 1000 / 2 * (step + 1) / STEPS));
+            }
+
+            // WorldSession::FlushSocket at the end of the map and world updates
+            for (auto& socket : sockets)
+                socket->Flush();
+
+            tickStart += std::chrono::milliseconds(TICK);
+            std::this_thread::sleep_until(tickStart);
+        }
+        double const cpu = double(std::clock() - cpuStart) * 1000.0 / CLOCKS_PER_SEC / TICKS;
+
+        // everything was flushed, wait for the clients to have it
+        uint64 received = 0;
+        for (uint32 i = 0; i < 1000 && received < sent; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            received = 0;
+            for (auto const& client : clients)
+                received += client->received;
+        }
+
+        work.reset();
+        context.stop();
+        network.join();
+
+        FlushResult result;
+        std::vector<double> latencies;
+        uint64 writes = 0;
+        for (auto const& socket : sockets)
+        {
+            writes += socket->GetStats().writes;
+            latencies.insert(latencies.end(), socket->GetStats().latencies.begin(), socket->GetStats().latencies.end());
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        result.writes = double(writes) / sessions / TICKS;
+        if (!latencies.empty())
+        {
+            result.p50 = latencies[latencies.size() / 2];
+            result.p99 = latencies[latencies.size() * 99 / 100];
+        }
+        result.cpu = cpu;
+        result.sent = sent;
+        result.received = received;
+        return result;
+    }
+}
+
+void RunTickFlushBenchmark(BenchmarkOptions const& /*options*/)
+{
+    uint32 const sessionCounts[] = { 10, 100, 500 };
+
+    printf("%8s %15s %9s %9s %9s %9s %8s %8s\n", "sessions", "writes/tick i/t", "imm p50", "imm p99", "tick p50", "tick p99", "imm cpu", "tick cpu");
+    for (uint32 sessions : sessionCounts)
+    {
+        FlushResult const immediate = Simulate(sessions, false);
+        FlushResult const aligned = Simulate(sessions, true);
+
+        if (immediate.received != immediate.sent || aligned.received != aligned.sent)
+            printf("MISMATCH: clients received %llu/%llu and %llu/%llu bytes\n", (unsigned long long)immediate.received, (unsigned long long)immediate.sent,
+                   (unsigned long long)aligned.received, (unsigned long long)aligned.sent);
+
+        printf("%8u %7.2f/%-7.2f %9.2f %9.2f %9.2f %9.2f %8.2f %8.2f\n", sessions, immediate.writes, aligned.writes,
+               immediate.p50, immediate.p99, aligned.p50, aligned.p99, immediate.cpu, aligned.cpu);
+    }
+}
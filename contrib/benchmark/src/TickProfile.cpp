@@ -0,0 +1,81 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// The cost of a PROFILE_ZONE around a short function, once without a zone, once with the profiler
+/// not recording and once recording into the ring of the thread, as with a slow tick threshold set.
+/// Also prints the memory of the ring every recording thread holds.
+
+#include "Benchmark.h"
+#include "Util/TickProfiler.h"
+
+#include <cstdio>
+
+namespace
+{
+    uint32 const CALLS = 1000000;                           // zones entered per measurement
+
+    volatile uint32 s_sink;
+
+    // a handler or update small enough that the zone around it matters
+    template<bool ZONE>
+    void Work(uint32 value)
+    {
+        if (ZONE)
+        {
+            PROFILE_ZONE("bench.work");
+            s_sink = s_sink + value;
+        }
+        else
+            s_sink = s_sink + value;
+    }
+}
+
+void RunTickProfileBenchmark(BenchmarkOptions const& options)
+{
+    uint64 const plainTime = MeasureBest(options.repeat, [&]()
+    {
+        for (uint32 i = 0; i < CALLS; ++i)
+            Work<false>(i);
+    });
+
+    sTickProfiler.SetSlowTickThreshold(0);
+    uint64 const idleTime = MeasureBest(options.repeat, [&]()
+    {
+        for (uint32 i = 0; i < CALLS; ++i)
+            Work<true>(i);
+    });
+
+    // any threshold makes the profiler record, no tick is marked so nothing is dumped
+    sTickProfiler.SetSlowTickThreshold(1000000);
+    uint64 const recordTime = MeasureBest(options.repeat, [&]()
+    {
+        for (uint32 i = 0; i < CALLS; ++i)
+            Work<true>(i);
+    });
+    sTickProfiler.SetSlowTickThreshold(0);
+
+    printf("%22s %10s %10s\n", "ns per call", "", "zone");
+    printf("%22s %10.1f %10s\n", "no zone", double(plainTime) / CALLS, "");
+    printf("%22s %10.1f %10.1f\n", "zone, not recording", double(idleTime) / CALLS, double(idleTime - std::min(idleTime, plainTime)) / CALLS);
+    printf("%22s %10.1f %10.1f\n", "zone, recording", double(recordTime) / CALLS, double(recordTime - std::min(recordTime, plainTime)) / CALLS);
+
+    // allocated by the first zone a thread closes while the profiler records, kept until shutdown
+    printf("\nring per recording thread: %u events x %u bytes = %.1f KB\n", uint32(PROFILER_RING_SIZE), uint32(sizeof(ProfileEvent)),
+           sizeof(ProfileThreadBuffer) / 1024.0);
+}
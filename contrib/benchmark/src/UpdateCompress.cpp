@@ -0,0 +1,146 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Compression of update packets as UpdateData::Compress does it, once with a deflateInit and
+/// deflateEnd pair for every packet like it used to, and once with the z_stream kept per thread
+/// and reset between packets.
+
+#include "Benchmark.h"
+
+#include <zlib.h>
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+    uint32 const PACKETS = 2000;                            // packets compressed per measurement
+
+    // values update blocks, a packed guid, an update mask and the changed fields, repeated like
+    // the blocks of the creatures around a player
+    std::vector<uint8> BuildPayload(uint32 size, std::mt19937& rng)
+    {
+        std::uniform_int_distribution<uint32> byte(0, 255), fields(2, 12);
+        std::vector<uint8> payload;
+        payload.reserve(size);
+        while (payload.size() < size)
+        {
+            payload.push_back(0);                           // UPDATETYPE_VALUES
+            payload.push_back(0x0F);                        // packed guid mask
+            for (uint32 i = 0; i < 4; ++i)
+                payload.push_back(uint8(byte(rng)));
+            payload.push_back(5);                           // mask blocks
+            for (uint32 i = 0; i < 20; ++i)
+                payload.push_back(i % 7 ? 0 : uint8(byte(rng)));
+            for (uint32 i = fields(rng); i > 0; --i)
+            {
+                uint32 value = byte(rng) < 192 ? byte(rng) : byte(rng) << 16;
+                payload.insert(payload.end(), reinterpret_cast<uint8*>(&value), reinterpret_cast<uint8*>(&value) + sizeof(value));
+            }
+        }
+        payload.resize(size);
+        return payload;
+    }
+
+    // the deflate calls of UpdateData::Compress, returns the compressed size
+    uint32 Deflate(z_stream& stream, std::vector<uint8>& dst, std::vector<uint8>& src)
+    {
+        stream.next_out = dst.data();
+        stream.avail_out = uInt(dst.size());
+        stream.next_in = src.data();
+        stream.avail_in = uInt(src.size());
+
+        if (deflate(&stream, Z_NO_FLUSH) != Z_OK || stream.avail_in != 0)
+            return 0;
+        if (deflate(&stream, Z_FINISH) != Z_STREAM_END)
+            return 0;
+        return uint32(stream.total_out);
+    }
+
+    // a stream set up and torn down for every packet
+    uint64 CompressFresh(std::vector<std::vector<uint8>>& packets, std::vector<uint8>& dst, int level)
+    {
+        uint64 total = 0;
+        for (std::vector<uint8>& packet : packets)
+        {
+            z_stream stream;
+            stream.zalloc = (alloc_func)nullptr;
+            stream.zfree = (free_func)nullptr;
+            stream.opaque = (voidpf)nullptr;
+            if (deflateInit(&stream, level) != Z_OK)
+                return 0;
+            total += Deflate(stream, dst, packet);
+            deflateEnd(&stream);
+        }
+        return total;
+    }
+
+    // UpdateDeflateContext, one stream reset between packets
+    uint64 CompressReused(std::vector<std::vector<uint8>>& packets, std::vector<uint8>& dst, z_stream& stream)
+    {
+        uint64 total = 0;
+        for (std::vector<uint8>& packet : packets)
+        {
+            if (deflateReset(&stream) != Z_OK)
+                return 0;
+            total += Deflate(stream, dst, packet);
+        }
+        return total;
+    }
+}
+
+void RunUpdateCompressBenchmark(BenchmarkOptions const& options)
+{
+    uint32 const sizes[] = { 128, 512, 2048, 8192, 32768 };
+    int const levels[] = { 1, 6 };                          // Compression default, zlib default
+
+    printf("%6s %6s %8s %12s %12s %8s\n", "level", "bytes", "ratio", "init ns", "reset ns", "speedup");
+    for (int level : levels)
+    {
+        z_stream stream;
+        stream.zalloc = (alloc_func)nullptr;
+        stream.zfree = (free_func)nullptr;
+        stream.opaque = (voidpf)nullptr;
+        if (deflateInit(&stream, level) != Z_OK)
+            return;
+
+        for (uint32 size : sizes)
+        {
+            std::mt19937 rng(size);
+            std::vector<std::vector<uint8>> packets;
+            for (uint32 i = 0; i < PACKETS; ++i)
+                packets.push_back(BuildPayload(size, rng));
+            std::vector<uint8> dst(compressBound(size));
+
+            uint64 freshBytes = 0, reusedBytes = 0;
+            uint64 const freshTime = MeasureBest(options.repeat, [&]() { freshBytes = CompressFresh(packets, dst, level); });
+            uint64 const reusedTime = MeasureBest(options.repeat, [&]() { reusedBytes = CompressReused(packets, dst, stream); });
+
+            if (freshBytes != reusedBytes || !freshBytes)
+                printf("MISMATCH: fresh streams wrote %llu bytes, the reused one %llu\n", (unsigned long long)freshBytes, (unsigned long long)reusedBytes);
+
+            printf("%6d %6u %8.2f %12.1f %12.1f %7.2fx\n", level, size, double(size) * PACKETS / double(reusedBytes ? reusedBytes : 1),
+                   double(freshTime) / PACKETS, double(reusedTime) / PACKETS, double(freshTime) / double(reusedTime));
+        }
+
+        deflateEnd(&stream);
+    }
+}
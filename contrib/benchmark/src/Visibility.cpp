@@ -0,0 +1,206 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// The two parts of player visibility updates. First the client guid list VisibleNotifier works
+/// on, once snapshotted into a GuidSet whose visited guids are erased and once into the flat
+/// GuidFlatSet with a visited bitmap. Then how many visibility updates walking units trigger, once
+/// every Visibility.RelocationLowerLimit yards and once with Visibility.Incremental at cell borders.
+
+#include "Benchmark.h"
+#include "Entities/ObjectGuid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    uint32 const NOTIFIES = 2000;                           // visibility updates per measurement of the list
+    float const CELL_SIZE = 533.33333f / 16;                // SIZE_OF_GRID_CELL
+    float const LOWER_LIMIT = 10.0f;                        // Visibility.RelocationLowerLimit default
+    float const RUN_SPEED = 7.0f;                           // yards per second
+    uint32 const UPDATE = 100;                              // ms between relocations of a walking unit
+
+    struct NotifyInput
+    {
+        std::vector<ObjectGuid> known;                      // at client before the update
+        std::vector<ObjectGuid> visited;                    // met by the grid visit, mostly the known ones
+    };
+
+    // a player standing among count objects of which a tenth left the range and a tenth came into it
+    NotifyInput BuildNotify(uint32 count, std::mt19937& rng)
+    {
+        std::uniform_int_distribution<uint32> counter(1, 0xFFFFFF), entry(1, 30000);
+        std::bernoulli_distribution changed(0.1);
+        NotifyInput input;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            ObjectGuid guid(HIGHGUID_UNIT, entry(rng), counter(rng));
+            bool const stays = !changed(rng);
+            input.known.push_back(guid);
+            if (stays)
+                input.visited.push_back(guid);
+            if (changed(rng))
+                input.visited.push_back(ObjectGuid(HIGHGUID_UNIT, entry(rng), counter(rng)));
+        }
+        std::shuffle(input.visited.begin(), input.visited.end(), rng);
+        return input;
+    }
+
+    // VisibleNotifier as it was, the copy of the set loses every visited guid, the rest went out of range
+    uint64 NotifySet(GuidSet const& clientGuids, NotifyInput const& input)
+    {
+        GuidSet snapshot(clientGuids);
+        for (ObjectGuid guid : input.visited)
+            snapshot.erase(guid);
+
+        uint64 outOfRange = 0;
+        for (ObjectGuid guid : snapshot)
+            outOfRange += guid.GetCounter();
+        return outOfRange;
+    }
+
+    // VisibleNotifier, a copied vector and a bitmap of the visited entries
+    uint64 NotifyFlat(GuidFlatSet const& clientGuids, NotifyInput const& input)
+    {
+        GuidFlatSet snapshot(clientGuids);
+        std::vector<bool> visited(snapshot.size(), false);
+        for (ObjectGuid guid : input.visited)
+        {
+            size_t index = snapshot.index(guid);
+            if (index != snapshot.size())
+                visited[index] = true;
+        }
+
+        uint64 outOfRange = 0;
+        for (size_t i = 0; i < snapshot.size(); ++i)
+            if (!visited[i])
+                outOfRange += snapshot[i].GetCounter();
+        return outOfRange;
+    }
+
+    struct WalkResult
+    {
+        uint64 stepped = 0;                                 // visibility updates every LOWER_LIMIT yards
+        uint64 incremental = 0;                             // of those, the ones crossing a cell border
+        double maxLag = 0.0;                                // most yards walked without an update in incremental mode
+    };
+
+    // units walking to random points of a few grids for an hour of game time, Unit::OnRelocated for both modes
+    WalkResult Walk(uint32 units, float area, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> point(0.0f, area);
+        WalkResult result;
+        for (uint32 u = 0; u < units; ++u)
+        {
+            float x = point(rng), y = point(rng);
+            float tx = point(rng), ty = point(rng);
+            float lastX = x, lastY = y;                     // m_last_notified_position
+            float incX = x, incY = y;                       // where the last incremental update happened
+            int32 cellX = int32(x / CELL_SIZE), cellY = int32(y / CELL_SIZE);
+            for (uint32 t = 0; t < 3600 * 1000 / UPDATE; ++t)
+            {
+                float dx = tx - x, dy = ty - y;
+                float dist = std::sqrt(dx * dx + dy * dy);
+                float step = RUN_SPEED * UPDATE / 1000;
+                if (dist <= step)
+                {
+                    x = tx;
+                    y = ty;
+                    tx = point(rng);
+                    ty = point(rng);
+                }
+                else
+                {
+                    x += dx / dist * step;
+                    y += dy / dist * step;
+                }
+
+                float ldx = x - lastX, ldy = y - lastY;
+                if (ldx * ldx + ldy * ldy <= LOWER_LIMIT * LOWER_LIMIT)
+                    continue;
+                lastX = x;
+                lastY = y;
+                ++result.stepped;
+
+                int32 const cx = int32(x / CELL_SIZE), cy = int32(y / CELL_SIZE);
+                float const idx = x - incX, idy = y - incY;
+                result.maxLag = std::max(result.maxLag, double(std::sqrt(idx * idx + idy * idy)));
+                if (cx != cellX || cy != cellY)
+                {
+                    cellX = cx;
+                    cellY = cy;
+                    incX = x;
+                    incY = y;
+                    ++result.incremental;
+                }
+            }
+        }
+        return result;
+    }
+}
+
+void RunVisibilityBenchmark(BenchmarkOptions const& options)
+{
+    uint32 const counts[] = { 20, 100, 500, 2000 };
+
+    printf("%9s %12s %12s %8s\n", "at client", "set ns", "flat ns", "speedup");
+    for (uint32 count : counts)
+    {
+        std::mt19937 rng(count);
+        std::vector<NotifyInput> inputs;
+        std::vector<GuidSet> sets;
+        std::vector<GuidFlatSet> flats;
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            inputs.push_back(BuildNotify(count, rng));
+            sets.emplace_back(inputs.back().known.begin(), inputs.back().known.end());
+            flats.emplace_back();
+            for (ObjectGuid guid : inputs.back().known)
+                flats.back().insert(guid);
+        }
+
+        uint64 setSum = 0, flatSum = 0;
+        uint64 const setTime = MeasureBest(options.repeat, [&]()
+        {
+            setSum = 0;
+            for (uint32 i = 0; i < NOTIFIES; ++i)
+                setSum += NotifySet(sets[i % sets.size()], inputs[i % inputs.size()]);
+        });
+        uint64 const flatTime = MeasureBest(options.repeat, [&]()
+        {
+            flatSum = 0;
+            for (uint32 i = 0; i < NOTIFIES; ++i)
+                flatSum += NotifyFlat(flats[i % flats.size()], inputs[i % inputs.size()]);
+        });
+
+        if (setSum != flatSum)
+            printf("MISMATCH: out of range sums %llu and %llu\n", (unsigned long long)setSum, (unsigned long long)flatSum);
+
+        printf("%9u %12.1f %12.1f %7.2fx\n", count, double(setTime) / NOTIFIES, double(flatTime) / NOTIFIES, double(setTime) / double(flatTime));
+    }
+
+    printf("\n%8s %14s %14s %10s %10s\n", "units", "stepped/unit", "cells/unit", "fewer", "max lag yd");
+    std::mt19937 rng(1);
+    WalkResult const walk = Walk(200, CELL_SIZE * 32, rng);
+    printf("%8u %14.1f %14.1f %9.2fx %10.1f\n", 200u, double(walk.stepped) / 200, double(walk.incremental) / 200,
+           double(walk.stepped) / double(walk.incremental), walk.maxLag);
+}
@@ -0,0 +1,119 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "LatencyStats.h"
+
+#include <cstdio>
+
+void LatencyHistogram::Add(uint64 micros)
+{
+    ++m_buckets[Buckets::Index(micros)];
+    if (!m_count || micros < m_min)
+        m_min = micros;
+    if (micros > m_max)
+        m_max = micros;
+    m_sum += micros;
+    ++m_count;
+}
+
+uint64 LatencyHistogram::GetPercentile(uint32 percent) const
+{
+    if (!m_count)
+        return 0;
+
+    return std::min(Buckets::Percentile(m_buckets, m_count, percent), m_max);
+}
+
+void LatencyStats::AddSample(uint32 opcode, char const* name, uint64 micros)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    OpcodeStats& stats = m_opcodes[opcode];
+    if (stats.name.empty())
+        stats.name = name;
+    stats.latency.Add(micros);
+}
+
+void LatencyStats::AddServerDiff(uint32 diff)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_serverDiff.Add(diff);
+    m_lastServerDiff = diff;
+}
+
+void LatencyStats::CountSent(uint32 opcode, char const* name)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    OpcodeStats& stats = m_opcodes[opcode];
+    if (stats.name.empty())
+        stats.name = name;
+    ++stats.sent;
+}
+
+void LatencyStats::CountError(char const* what)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    ++m_errors[what];
+}
+
+void LatencyStats::Report(bool verbose) const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    printf("clients in world: %d\n", m_inWorld.load());
+    printf("%-28s %10s %10s %10s %10s %10s %10s %10s\n", "opcode", "sent", "answered", "avg(us)", "p50(us)", "p95(us)", "p99(us)", "max(us)");
+    for (auto const& [opcode, stats] : m_opcodes)
+    {
+        LatencyHistogram const& h = stats.latency;
+        printf("%-28s %10lu %10lu %10lu %10lu %10lu %10lu %10lu\n", stats.name.c_str(),
+               (unsigned long)stats.sent, (unsigned long)h.GetCount(), (unsigned long)h.GetAverage(),
+               (unsigned long)h.GetPercentile(50), (unsigned long)h.GetPercentile(95),
+               (unsigned long)h.GetPercentile(99), (unsigned long)h.GetMax());
+    }
+
+    if (verbose)
+    {
+        for (auto const& [opcode, stats] : m_opcodes)
+        {
+            LatencyHistogram const& h = stats.latency;
+            if (!h.GetCount())
+                continue;
+
+            printf("\n%s latency histogram:\n", stats.name.c_str());
+            auto const& buckets = h.GetBuckets();
+            for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i)
+            {
+                if (!buckets[i])
+                    continue;
+
+                uint32 const width = uint32(buckets[i] * 50 / h.GetCount());
+                printf("  ~%10lu us %10lu %s\n", (unsigned long)LatencyHistogram::Buckets::Value(uint32(i)),
+                       (unsigned long)buckets[i], std::string(width, '#').c_str());
+            }
+        }
+    }
+
+    if (m_serverDiff.GetCount())
+        printf("\nserver average diff (World::GetAverageDiff): last %u ms, min %lu ms, avg %lu ms, max %lu ms over %lu samples\n",
+               m_lastServerDiff, (unsigned long)m_serverDiff.GetMin(), (unsigned long)m_serverDiff.GetAverage(),
+               (unsigned long)m_serverDiff.GetMax(), (unsigned long)m_serverDiff.GetCount());
+
+    for (auto const& [what, count] : m_errors)
+        printf("errors: %-40s %lu\n", what.c_str(), (unsigned long)count);
+
+    fflush(stdout);
+}
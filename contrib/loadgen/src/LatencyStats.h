@@ -0,0 +1,89 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOADGEN_LATENCYSTATS_H
+#define LOADGEN_LATENCYSTATS_H
+
+#include "Common.h"
+#include "Util/LogLinearHistogram.h"
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+/// Latency histogram in the log linear layout of the server metrics, 8 buckets per power of two
+class LatencyHistogram
+{
+    public:
+        typedef MaNGOS::LogLinearBuckets<3, 35> Buckets;
+        static constexpr size_t BUCKET_COUNT = Buckets::COUNT;
+
+        LatencyHistogram() : m_buckets(), m_count(0), m_sum(0), m_min(0), m_max(0) {}
+
+        void Add(uint64 micros);
+
+        uint64 GetCount() const { return m_count; }
+        uint64 GetMin() const { return m_min; }
+        uint64 GetMax() const { return m_max; }
+        uint64 GetAverage() const { return m_count ? m_sum / m_count : 0; }
+        // middle of the bucket holding the given percentile, clamped to the real maximum
+        uint64 GetPercentile(uint32 percent) const;
+        std::array<uint64, BUCKET_COUNT> const& GetBuckets() const { return m_buckets; }
+
+    private:
+        std::array<uint64, BUCKET_COUNT> m_buckets;
+        uint64 m_count;
+        uint64 m_sum;
+        uint64 m_min;
+        uint64 m_max;
+};
+
+/// Per opcode latency histograms shared by all clients plus the sampled server update diff
+class LatencyStats
+{
+    public:
+        void AddSample(uint32 opcode, char const* name, uint64 micros);
+        void AddServerDiff(uint32 diff);
+        void CountSent(uint32 opcode, char const* name);
+        void CountError(char const* what);
+        void CountInWorld(int32 change) { m_inWorld += change; }
+
+        // prints a table per opcode, the histograms of all opcodes with samples when verbose is set
+        void Report(bool verbose) const;
+
+    private:
+        struct OpcodeStats
+        {
+            OpcodeStats() : sent(0) {}
+
+            std::string name;
+            uint64 sent;
+            LatencyHistogram latency;
+        };
+
+        mutable std::mutex m_lock;
+        std::map<uint32, OpcodeStats> m_opcodes;
+        std::map<std::string, uint64> m_errors;
+        LatencyHistogram m_serverDiff;                      // in ms, not us
+        uint32 m_lastServerDiff = 0;
+        std::atomic<int32> m_inWorld = 0;
+};
+
+#endif
@@ -0,0 +1,689 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "LoadClient.h"
+#include "LatencyStats.h"
+#include "LoadGenOpcodes.h"
+#include "Auth/CryptoHash.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    // realmd commands, see src/realmd/AuthCodes.h
+    enum : uint8
+    {
+        CMD_AUTH_LOGON_CHALLENGE    = 0x00,
+        CMD_AUTH_LOGON_PROOF        = 0x01,
+        CMD_REALM_LIST              = 0x10,
+    };
+
+    constexpr uint16 CLIENT_BUILD = 5875;                   // 1.12.1
+    constexpr float RUN_SPEED = 7.0f;
+    constexpr uint32 MOVE_STEPS_PER_LEG = 6;                // heartbeats before stopping and turning around
+    constexpr size_t MAX_PENDING_REQUESTS = 64;
+    constexpr char const* SERVER_DIFF_PREFIX = "Update diff: ";
+
+    uint32 RandomJitter(uint32 interval)
+    {
+        thread_local std::mt19937 generator(std::random_device{}());
+        return interval ? std::uniform_int_distribution<uint32>(0, interval)(generator) : 0;
+    }
+
+    uint64 ReadPackedGuid(ByteBuffer& packet)
+    {
+        uint8 mask = packet.read<uint8>();
+        uint64 guid = 0;
+        for (uint8 i = 0; i < 8; ++i)
+            if (mask & (1 << i))
+                guid |= uint64(packet.read<uint8>()) << (i * 8);
+        return guid;
+    }
+
+    // compressed addon list of the default interface addons, the server rejects sessions without one
+    std::vector<uint8> const& GetAddonInfo()
+    {
+        static std::vector<uint8> const addonInfo = []()
+        {
+            static char const* const addons[] =
+            {
+                "Blizzard_AuctionUI", "Blizzard_BattlefieldMinimap", "Blizzard_BindingUI", "Blizzard_CombatText",
+                "Blizzard_CraftUI", "Blizzard_GMSurveyUI", "Blizzard_InspectUI", "Blizzard_MacroUI",
+                "Blizzard_RaidUI", "Blizzard_TalentUI", "Blizzard_TradeSkillUI", "Blizzard_TrainerUI"
+            };
+
+            ByteBuffer plain;
+            for (char const* name : addons)
+                plain << std::string(name) << uint32(0x4C1C776D) << uint32(0) << uint8(1);
+
+            uLongf compressedSize = compressBound(uLong(plain.size()));
+            std::vector<uint8> result(4 + compressedSize);
+            compress(result.data() + 4, &compressedSize, plain.contents(), uLong(plain.size()));
+            result.resize(4 + compressedSize);
+
+            uint32 plainSize = uint32(plain.size());
+            EndianConvert(plainSize);
+            memcpy(result.data(), &plainSize, 4);
+            return result;
+        }();
+
+        return addonInfo;
+    }
+}
+
+LoadClient::LoadClient(boost::asio::io_context& context, LoadGenConfig const& config, LatencyStats& stats, uint32 index) :
+    m_context(context), m_socket(context), m_resolver(context), m_config(config), m_stats(stats), m_index(index),
+    m_stopped(false), m_writing(false), m_serverHeader(), m_created(Clock::now()), m_inWorld(false), m_createdCharacter(false),
+    m_guid(0), m_x(0.0f), m_y(0.0f), m_z(0.0f), m_o(0.0f), m_moving(false), m_moveSteps(0), m_pingCounter(0),
+    m_moveTimer(context), m_chatTimer(context), m_castTimer(context), m_auctionTimer(context), m_pingTimer(context), m_statsTimer(context)
+{
+    // accounts are stored upper case and the SRP6 hashes are built from the upper case names
+    m_account = config.accountPrefix + std::to_string(config.firstAccount + index);
+    std::transform(m_account.begin(), m_account.end(), m_account.begin(), ::toupper);
+}
+
+void LoadClient::Start()
+{
+    Connect(m_config.realmHost, std::to_string(m_config.realmPort), [this]() { SendLogonChallenge(); });
+}
+
+void LoadClient::Stop()
+{
+    m_stopped = true;
+    if (m_inWorld)
+        m_stats.CountInWorld(-1);
+    m_inWorld = false;
+
+    m_moveTimer.cancel();
+    m_chatTimer.cancel();
+    m_castTimer.cancel();
+    m_auctionTimer.cancel();
+    m_pingTimer.cancel();
+    m_statsTimer.cancel();
+
+    boost::system::error_code ec;
+    m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    m_socket.close(ec);
+}
+
+void LoadClient::Fail(char const* what)
+{
+    if (m_stopped)
+        return;
+
+    m_stats.CountError(what);
+    printf("client %s: %s\n", m_account.c_str(), what);
+    Stop();
+}
+
+void LoadClient::Connect(std::string const& host, std::string const& port, std::function<void()> onConnected)
+{
+    m_resolver.async_resolve(host, port, [self = shared_from_this(), onConnected](boost::system::error_code const& error, boost::asio::ip::tcp::resolver::results_type results)
+    {
+        if (error)
+            return self->Fail("resolve failed");
+
+        boost::asio::async_connect(self->m_socket, results, [self, onConnected](boost::system::error_code const& error, boost::asio::ip::tcp::endpoint const& /*endpoint*/)
+        {
+            if (error)
+                return self->Fail("connect failed");
+
+            self->m_socket.set_option(boost::asio::ip::tcp::no_delay(true));
+            onConnected();
+        });
+    });
+}
+
+void LoadClient::ReadExact(size_t size, ReadHandler handler)
+{
+    m_readBuffer.resize(size);
+    boost::asio::async_read(m_socket, boost::asio::buffer(m_readBuffer), [self = shared_from_this(), handler = std::move(handler)](boost::system::error_code const& error, std::size_t /*read*/)
+    {
+        if (self->m_stopped)
+            return;
+
+        if (error)
+            return self->Fail(self->m_inWorld ? "disconnected" : "disconnected during login");
+
+        handler();
+    });
+}
+
+void LoadClient::WriteRaw(std::vector<uint8>&& data)
+{
+    m_writeQueue.push_back(std::move(data));
+    if (!m_writing)
+        FlushWrites();
+}
+
+void LoadClient::FlushWrites()
+{
+    if (m_writeQueue.empty() || m_stopped)
+    {
+        m_writing = false;
+        return;
+    }
+
+    m_writing = true;
+    boost::asio::async_write(m_socket, boost::asio::buffer(m_writeQueue.front()), [self = shared_from_this()](boost::system::error_code const& error, std::size_t /*written*/)
+    {
+        if (error)
+            return self->Fail("write failed");
+
+        self->m_writeQueue.pop_front();
+        self->FlushWrites();
+    });
+}
+
+void LoadClient::SendLogonChallenge()
+{
+    ByteBuffer pkt;
+    pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
+    pkt << uint8(3);
+    pkt << uint16(30 + m_account.size());
+    pkt.append("WoW", 4);
+    pkt << uint8(1) << uint8(12) << uint8(1);
+    pkt << uint16(CLIENT_BUILD);
+    pkt.append("68x", 4);                                   // "x86" with reversed byte order
+    pkt.append("niW", 4);                                   // "Win"
+    pkt.append("SUne", 4);                                  // "enUS"
+    pkt << uint32(0);                                       // timezone bias
+    pkt << uint32(0x0100007F);                              // client ip, not checked
+    pkt << uint8(m_account.size());
+    pkt.append(m_account.c_str(), m_account.size());
+
+    WriteRaw(std::vector<uint8>(pkt.contents(), pkt.contents() + pkt.size()));
+    ReadExact(3, [this]() { HandleLogonChallenge(); });
+}
+
+void LoadClient::HandleLogonChallenge()
+{
+    if (m_readBuffer[0] != CMD_AUTH_LOGON_CHALLENGE || m_readBuffer[2] != 0)
+        return Fail("logon challenge rejected (unknown account?)");
+
+    // B[32], g_len, g[1], N_len, N[32], s[32], version challenge[16], security flags
+    ReadExact(32 + 1 + 1 + 1 + 32 + 32 + 16 + 1, [this]()
+    {
+        uint8 const* data = m_readBuffer.data();
+        uint8 const* B = data;
+        uint8 const* s = data + 32 + 1 + 1 + 1 + 32;
+        if (data[32 + 1 + 1 + 1 + 32 + 32 + 16] != 0)
+            return Fail("account requires a PIN or authenticator");
+
+        std::string password = m_config.password;
+        std::transform(password.begin(), password.end(), password.begin(), ::toupper);
+        if (!m_srp.CalculateClientSessionKey(m_account, password, B, s, 32))
+            return Fail("invalid host ephemeral");
+
+        m_srp.CalculateProof(m_account);
+
+        ByteBuffer pkt;
+        pkt << uint8(CMD_AUTH_LOGON_PROOF);
+        pkt.append(m_srp.GetClientPublicEphemeral().AsByteArray(32));
+        pkt.append(m_srp.GetProof().AsByteArray(20));
+        pkt.append(std::vector<uint8>(20, 0));              // version proof, only checked with StrictVersionCheck
+        pkt << uint8(0);                                    // number of keys
+        pkt << uint8(0);                                    // security flags
+
+        WriteRaw(std::vector<uint8>(pkt.contents(), pkt.contents() + pkt.size()));
+        ReadExact(2, [this]() { HandleLogonProof(); });
+    });
+}
+
+void LoadClient::HandleLogonProof()
+{
+    if (m_readBuffer[0] != CMD_AUTH_LOGON_PROOF || m_readBuffer[1] != 0)
+        return Fail("logon proof rejected (wrong password?)");
+
+    // M2[20], login flags
+    ReadExact(20 + 4, [this]()
+    {
+        Sha1Hash sha;
+        m_srp.Finalize(sha);
+        if (memcmp(sha.GetDigest(), m_readBuffer.data(), Sha1Hash::GetLength()) != 0)
+            return Fail("server proof mismatch");
+
+        m_sessionKey = m_srp.GetStrongSessionKey();
+
+        ByteBuffer pkt;
+        pkt << uint8(CMD_REALM_LIST);
+        pkt << uint32(0);
+        WriteRaw(std::vector<uint8>(pkt.contents(), pkt.contents() + pkt.size()));
+
+        ReadExact(3, [this]()
+        {
+            if (m_readBuffer[0] != CMD_REALM_LIST)
+                return Fail("unexpected realm list answer");
+
+            uint16 size = m_readBuffer[1] | (m_readBuffer[2] << 8);
+            ReadExact(size, [this]() { HandleRealmList(); });
+        });
+    });
+}
+
+void LoadClient::HandleRealmList()
+{
+    ByteBuffer list;
+    list.append(m_readBuffer.data(), m_readBuffer.size());
+
+    std::string address;
+    try
+    {
+        list.read_skip<uint32>();
+        uint8 count = list.read<uint8>();
+        for (uint8 i = 0; i < count; ++i)
+        {
+            std::string name, realmAddress;
+            list.read_skip<uint32>();                       // icon
+            list.read_skip<uint8>();                        // flags
+            list >> name >> realmAddress;
+            list.read_skip<float>();                        // population
+            list.read_skip<uint8>();                        // characters
+            list.read_skip<uint8>();                        // category
+            list.read_skip<uint8>();                        // unk
+
+            if (address.empty() && (m_config.realmName.empty() || m_config.realmName == name))
+                address = realmAddress;
+        }
+    }
+    catch (ByteBufferException const&)
+    {
+        return Fail("malformed realm list");
+    }
+
+    if (address.empty())
+        return Fail("realm not found in realm list");
+
+    size_t const colon = address.rfind(':');
+    if (colon == std::string::npos)
+        return Fail("malformed realm address");
+
+    boost::system::error_code ec;
+    m_socket.close(ec);
+    m_socket = boost::asio::ip::tcp::socket(m_context);
+
+    Connect(address.substr(0, colon), address.substr(colon + 1), [this]() { ReadWorldPacket(); });
+}
+
+void LoadClient::ReadWorldPacket()
+{
+    ReadExact(sizeof(m_serverHeader), [this]()
+    {
+        memcpy(m_serverHeader, m_readBuffer.data(), sizeof(m_serverHeader));
+        m_crypt.DecryptRecv(m_serverHeader, sizeof(m_serverHeader));
+
+        uint16 const size = (m_serverHeader[0] << 8) | m_serverHeader[1];
+        uint16 const opcode = m_serverHeader[2] | (m_serverHeader[3] << 8);
+        if (size < 2)
+            return Fail("malformed server packet");
+
+        ReadExact(size - 2, [this, opcode]()
+        {
+            ByteBuffer packet(m_readBuffer.size());
+            packet.append(m_readBuffer.data(), m_readBuffer.size());
+
+            try
+            {
+                HandleWorldPacket(opcode, packet);
+            }
+            catch (ByteBufferException const&)
+            {
+                m_stats.CountError("malformed server packet");
+            }
+
+            if (!m_stopped)
+                ReadWorldPacket();
+        });
+    });
+}
+
+void LoadClient::SendWorldPacket(uint16 opcode, ByteBuffer const& payload, uint16 responseOpcode /*= 0*/)
+{
+    // client header: uint16 size (big endian, includes the opcode), uint32 opcode
+    std::vector<uint8> data(6 + payload.size());
+    uint16 const size = uint16(payload.size() + 4);
+    data[0] = uint8(size >> 8);
+    data[1] = uint8(size);
+    data[2] = uint8(opcode);
+    data[3] = uint8(opcode >> 8);
+    data[4] = 0;
+    data[5] = 0;
+    m_crypt.EncryptSend(data.data(), 6);
+    if (payload.size())
+        memcpy(data.data() + 6, payload.contents(), payload.size());
+
+    m_stats.CountSent(opcode, LookupLoadGenOpcodeName(opcode));
+
+    if (responseOpcode)
+    {
+        std::deque<PendingRequest>& pending = m_pending[responseOpcode];
+        if (pending.size() >= MAX_PENDING_REQUESTS)
+        {
+            m_stats.CountError("request without answer");
+            pending.pop_front();
+        }
+        pending.push_back({ opcode, Clock::now() });
+    }
+
+    WriteRaw(std::move(data));
+}
+
+void LoadClient::CompleteRequest(uint16 responseOpcode)
+{
+    auto itr = m_pending.find(responseOpcode);
+    if (itr == m_pending.end() || itr->second.empty())
+        return;
+
+    PendingRequest const& request = itr->second.front();
+    uint64 const micros = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - request.sent).count();
+    m_stats.AddSample(request.opcode, LookupLoadGenOpcodeName(request.opcode), micros);
+    itr->second.pop_front();
+}
+
+void LoadClient::SendAuthSession(uint32 serverSeed)
+{
+    uint32 const clientSeed = RandomJitter(0xFFFFFFFF);
+    uint32 const zero = 0;
+
+    Sha1Hash sha;
+    sha.UpdateData(m_account);
+    sha.UpdateData((uint8 const*)&zero, 4);
+    sha.UpdateData((uint8 const*)&clientSeed, 4);
+    sha.UpdateData((uint8 const*)&serverSeed, 4);
+    sha.UpdateBigNumbers(&m_sessionKey, nullptr);
+    sha.Finalize();
+
+    ByteBuffer pkt;
+    pkt << uint32(CLIENT_BUILD);
+    pkt << uint32(0);
+    pkt << m_account;
+    pkt << uint32(clientSeed);
+    pkt.append(sha.GetDigest(), Sha1Hash::GetLength());
+    pkt.append(GetAddonInfo());
+
+    SendWorldPacket(CMSG_AUTH_SESSION, pkt, SMSG_AUTH_RESPONSE);
+
+    // everything after the session packet is crypted in both directions
+    m_crypt.Init(&m_sessionKey);
+}
+
+void LoadClient::HandleWorldPacket(uint16 opcode, ByteBuffer& packet)
+{
+    switch (opcode)
+    {
+        case SMSG_AUTH_CHALLENGE:
+            SendAuthSession(packet.read<uint32>());
+            break;
+        case SMSG_AUTH_RESPONSE:
+        {
+            uint8 const result = packet.read<uint8>();
+            if (result == LOADGEN_AUTH_WAIT_QUEUE)
+                break;                                      // answered again once out of the queue
+
+            CompleteRequest(opcode);
+            if (result != LOADGEN_AUTH_OK)
+                return Fail("world authentication rejected");
+
+            SendWorldPacket(CMSG_CHAR_ENUM, ByteBuffer(), SMSG_CHAR_ENUM);
+            break;
+        }
+        case SMSG_CHAR_ENUM:
+            CompleteRequest(opcode);
+            HandleCharEnum(packet);
+            break;
+        case SMSG_CHAR_CREATE:
+            CompleteRequest(opcode);
+            if (packet.read<uint8>() != LOADGEN_CHAR_CREATE_SUCCESS)
+                return Fail("character creation failed");
+
+            SendWorldPacket(CMSG_CHAR_ENUM, ByteBuffer(), SMSG_CHAR_ENUM);
+            break;
+        case SMSG_LOGIN_VERIFY_WORLD:
+            CompleteRequest(opcode);
+            packet.read_skip<uint32>();                     // map
+            packet >> m_x >> m_y >> m_z >> m_o;
+            EnterWorld();
+            break;
+        case SMSG_NEW_WORLD:
+        {
+            packet.read_skip<uint32>();
+            packet >> m_x >> m_y >> m_z >> m_o;
+            m_moving = false;
+            SendWorldPacket(MSG_MOVE_WORLDPORT_ACK, ByteBuffer());
+            break;
+        }
+        case SMSG_MESSAGECHAT:
+            HandleMessageChat(packet);
+            break;
+        case SMSG_CAST_RESULT:
+        case SMSG_PONG:
+        case SMSG_AUCTION_LIST_RESULT:
+            CompleteRequest(opcode);
+            break;
+        default:
+            break;
+    }
+}
+
+void LoadClient::HandleCharEnum(ByteBuffer& packet)
+{
+    uint8 const count = packet.read<uint8>();
+    if (!count)
+    {
+        if (m_createdCharacter)
+            return Fail("created character not listed");
+
+        m_createdCharacter = true;
+
+        ByteBuffer pkt;
+        pkt << GetCharacterName();
+        pkt << uint8(1) << uint8(1);                        // human warrior
+        pkt << uint8(0);                                    // gender
+        pkt << uint8(0) << uint8(0) << uint8(0) << uint8(0) << uint8(0) << uint8(0);
+        SendWorldPacket(CMSG_CHAR_CREATE, pkt, SMSG_CHAR_CREATE);
+        return;
+    }
+
+    // the first character of the account is used
+    packet >> m_guid;
+    std::string name;
+    packet >> name;
+
+    ByteBuffer pkt;
+    pkt << m_guid;
+    SendWorldPacket(CMSG_PLAYER_LOGIN, pkt, SMSG_LOGIN_VERIFY_WORLD);
+}
+
+void LoadClient::HandleMessageChat(ByteBuffer& packet)
+{
+    uint8 const type = packet.read<uint8>();
+    packet.read_skip<uint32>();                             // language
+
+    if (type == LOADGEN_CHAT_MSG_SAY)
+    {
+        uint64 sender;
+        packet >> sender;
+        if (sender == m_guid)
+            CompleteRequest(SMSG_MESSAGECHAT);
+    }
+    else if (type == LOADGEN_CHAT_MSG_SYSTEM)
+    {
+        packet.read_skip<uint64>();
+        packet.read_skip<uint32>();                         // length
+        std::string text;
+        packet >> text;
+
+        if (text.compare(0, strlen(SERVER_DIFF_PREFIX), SERVER_DIFF_PREFIX) == 0)
+            m_stats.AddServerDiff(uint32(strtoul(text.c_str() + strlen(SERVER_DIFF_PREFIX), nullptr, 10)));
+    }
+}
+
+void LoadClient::EnterWorld()
+{
+    if (m_inWorld)
+        return;
+
+    m_inWorld = true;
+    m_stats.CountInWorld(1);
+    m_moving = false;
+    m_moveSteps = 0;
+
+    Schedule(m_moveTimer, m_config.moveInterval, &LoadClient::DoMove);
+    Schedule(m_chatTimer, m_config.chatInterval, &LoadClient::DoChat);
+    Schedule(m_castTimer, m_config.castInterval, &LoadClient::DoCast);
+    if (m_config.auctioneerGuid)
+        Schedule(m_auctionTimer, m_config.auctionInterval, &LoadClient::DoAuctionBrowse);
+    Schedule(m_pingTimer, m_config.pingInterval, &LoadClient::DoPing);
+    if (m_index == 0)
+        Schedule(m_statsTimer, m_config.serverStatsInterval, &LoadClient::DoServerStats);
+}
+
+void LoadClient::Schedule(boost::asio::steady_timer& timer, uint32 interval, void (LoadClient::*action)())
+{
+    if (!interval)
+        return;
+
+    // the first run is spread over one interval so that clients do not act in lockstep
+    timer.expires_after(std::chrono::milliseconds(RandomJitter(interval)));
+    Repeat(timer, interval, action);
+}
+
+void LoadClient::Repeat(boost::asio::steady_timer& timer, uint32 interval, void (LoadClient::*action)())
+{
+    timer.async_wait([self = shared_from_this(), &timer, interval, action](boost::system::error_code const& error)
+    {
+        if (error || !self->m_inWorld)
+            return;
+
+        (self.get()->*action)();
+
+        timer.expires_at(timer.expiry() + std::chrono::milliseconds(interval));
+        self->Repeat(timer, interval, action);
+    });
+}
+
+void LoadClient::SendMovement(uint16 opcode)
+{
+    ByteBuffer pkt;
+    pkt << uint32(m_moving ? LOADGEN_MOVEFLAG_FORWARD : 0);
+    pkt << GetClientTime();
+    pkt << m_x << m_y << m_z << m_o;
+    pkt << uint32(0);                                       // fall time
+    SendWorldPacket(opcode, pkt);
+}
+
+void LoadClient::DoMove()
+{
+    Clock::time_point const now = Clock::now();
+    if (!m_moving)
+    {
+        m_moving = true;
+        m_moveSteps = 0;
+        m_lastMove = now;
+        SendMovement(MSG_MOVE_START_FORWARD);
+        return;
+    }
+
+    float const elapsed = std::chrono::duration<float>(now - m_lastMove).count();
+    m_lastMove = now;
+    m_x += std::cos(m_o) * RUN_SPEED * elapsed;
+    m_y += std::sin(m_o) * RUN_SPEED * elapsed;
+
+    if (++m_moveSteps < MOVE_STEPS_PER_LEG)
+    {
+        SendMovement(MSG_MOVE_HEARTBEAT);
+        return;
+    }
+
+    // walk the same leg back next time
+    m_moving = false;
+    SendMovement(MSG_MOVE_STOP);
+    m_o = std::fmod(m_o + float(M_PI), float(2 * M_PI));
+}
+
+void LoadClient::DoChat()
+{
+    ByteBuffer pkt;
+    pkt << uint32(LOADGEN_CHAT_MSG_SAY);
+    pkt << uint32(LOADGEN_LANG_UNIVERSAL);
+    pkt << std::string("load test message");
+    SendWorldPacket(CMSG_MESSAGECHAT, pkt, SMSG_MESSAGECHAT);
+}
+
+void LoadClient::DoCast()
+{
+    ByteBuffer pkt;
+    pkt << uint32(m_config.spellId);
+    pkt << uint16(0);                                       // TARGET_FLAG_SELF
+    SendWorldPacket(CMSG_CAST_SPELL, pkt, SMSG_CAST_RESULT);
+}
+
+void LoadClient::DoAuctionBrowse()
+{
+    ByteBuffer pkt;
+    pkt << m_config.auctioneerGuid;
+    pkt << uint32(0);                                       // list from
+    pkt << std::string();                                   // name filter
+    pkt << uint8(0) << uint8(0);                            // level range
+    pkt << uint32(0xFFFFFFFF) << uint32(0xFFFFFFFF) << uint32(0xFFFFFFFF) << uint32(0xFFFFFFFF);
+    pkt << uint8(0);                                        // usable only
+    SendWorldPacket(CMSG_AUCTION_LIST_ITEMS, pkt, SMSG_AUCTION_LIST_RESULT);
+}
+
+void LoadClient::DoPing()
+{
+    ByteBuffer pkt;
+    pkt << uint32(++m_pingCounter);
+    pkt << uint32(0);                                       // latency
+    SendWorldPacket(CMSG_PING, pkt, SMSG_PONG);
+}
+
+void LoadClient::DoServerStats()
+{
+    ByteBuffer pkt;
+    pkt << uint32(LOADGEN_CHAT_MSG_SAY);
+    pkt << uint32(LOADGEN_LANG_UNIVERSAL);
+    pkt << std::string(".server info");
+    SendWorldPacket(CMSG_MESSAGECHAT, pkt);
+}
+
+std::string LoadClient::GetCharacterName() const
+{
+    // names may only contain letters, encode the account number in base 26
+    std::string name = "Load";
+    uint32 number = m_config.firstAccount + m_index;
+    std::string suffix;
+    do
+    {
+        suffix.insert(suffix.begin(), char('a' + number % 26));
+        number /= 26;
+    }
+    while (number);
+
+    return name + suffix;
+}
+
+uint32 LoadClient::GetClientTime() const
+{
+    return uint32(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_created).count());
+}
@@ -0,0 +1,156 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOADGEN_LOADCLIENT_H
+#define LOADGEN_LOADCLIENT_H
+
+#include "Common.h"
+#include "Auth/SRP6.h"
+#include "Util/ByteBuffer.h"
+#include "AuthCrypt.h"
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class LatencyStats;
+
+struct LoadGenConfig
+{
+    std::string realmHost = "127.0.0.1";
+    uint16 realmPort = 3724;
+    std::string realmName;                                  // empty: first realm of the list
+    std::string accountPrefix = "LOADGEN";
+    std::string password = "LOADGEN";
+    uint32 firstAccount = 1;
+    uint32 clients = 100;
+    uint32 connectInterval = 20;                            // ms between two client starts
+
+    // action intervals in ms, 0 disables the action
+    uint32 moveInterval = 500;
+    uint32 chatInterval = 5000;
+    uint32 castInterval = 3000;
+    uint32 auctionInterval = 0;
+    uint32 pingInterval = 30000;
+    uint32 serverStatsInterval = 10000;                     // ".server info" sent by the first client
+
+    uint32 spellId = 2457;                                  // Battle Stance, known by every created warrior
+    uint64 auctioneerGuid = 0;                              // auction browsing needs an auctioneer in range
+};
+
+/// One synthetic 1.12 client: realmd SRP6 logon, world authentication, character login and scripted actions
+class LoadClient : public std::enable_shared_from_this<LoadClient>
+{
+    public:
+        LoadClient(boost::asio::io_context& context, LoadGenConfig const& config, LatencyStats& stats, uint32 index);
+
+        void Start();
+        void Stop();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+        typedef std::function<void()> ReadHandler;
+
+        struct PendingRequest
+        {
+            uint16 opcode;
+            Clock::time_point sent;
+        };
+
+        // generic io
+        void Connect(std::string const& host, std::string const& port, std::function<void()> onConnected);
+        void ReadExact(size_t size, ReadHandler handler);
+        void WriteRaw(std::vector<uint8>&& data);
+        void FlushWrites();
+        void Fail(char const* what);
+
+        // realmd
+        void SendLogonChallenge();
+        void HandleLogonChallenge();
+        void HandleLogonProof();
+        void HandleRealmList();
+
+        // world
+        void ReadWorldPacket();
+        void HandleWorldPacket(uint16 opcode, ByteBuffer& packet);
+        void SendWorldPacket(uint16 opcode, ByteBuffer const& payload, uint16 responseOpcode = 0);
+        void SendAuthSession(uint32 serverSeed);
+        void HandleCharEnum(ByteBuffer& packet);
+        void HandleMessageChat(ByteBuffer& packet);
+        void CompleteRequest(uint16 responseOpcode);
+        void EnterWorld();
+
+        // scripted actions
+        void Schedule(boost::asio::steady_timer& timer, uint32 interval, void (LoadClient::*action)());
+        void Repeat(boost::asio::steady_timer& timer, uint32 interval, void (LoadClient::*action)());
+        void DoMove();
+        void DoChat();
+        void DoCast();
+        void DoAuctionBrowse();
+        void DoPing();
+        void DoServerStats();
+        void SendMovement(uint16 opcode);
+
+        std::string GetCharacterName() const;
+        uint32 GetClientTime() const;
+
+        boost::asio::io_context& m_context;
+        boost::asio::ip::tcp::socket m_socket;
+        boost::asio::ip::tcp::resolver m_resolver;
+        LoadGenConfig const& m_config;
+        LatencyStats& m_stats;
+        uint32 m_index;
+        std::string m_account;
+        bool m_stopped;
+
+        std::vector<uint8> m_readBuffer;
+        std::deque<std::vector<uint8>> m_writeQueue;
+        bool m_writing;
+
+        SRP6 m_srp;
+        BigNumber m_sessionKey;
+        AuthCrypt m_crypt;
+        uint8 m_serverHeader[4];
+
+        std::unordered_map<uint16, std::deque<PendingRequest>> m_pending;
+        Clock::time_point m_created;
+
+        bool m_inWorld;
+        bool m_createdCharacter;
+        uint64 m_guid;
+        float m_x, m_y, m_z, m_o;
+        bool m_moving;
+        uint32 m_moveSteps;
+        Clock::time_point m_lastMove;
+        uint32 m_pingCounter;
+
+        boost::asio::steady_timer m_moveTimer;
+        boost::asio::steady_timer m_chatTimer;
+        boost::asio::steady_timer m_castTimer;
+        boost::asio::steady_timer m_auctionTimer;
+        boost::asio::steady_timer m_pingTimer;
+        boost::asio::steady_timer m_statsTimer;
+};
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOADGEN_OPCODES_H
+#define LOADGEN_OPCODES_H
+
+#include "Common.h"
+
+// The subset of the 1.12 protocol spoken by the load generator, values mirror src/game/Server/Opcodes.h.
+// Opcodes.h itself is not used as it drags in the whole game library.
+enum LoadGenOpcodes : uint16
+{
+    CMSG_CHAR_CREATE                = 0x036,
+    CMSG_CHAR_ENUM                  = 0x037,
+    SMSG_CHAR_CREATE                = 0x03A,
+    SMSG_CHAR_ENUM                  = 0x03B,
+    CMSG_PLAYER_LOGIN               = 0x03D,
+    SMSG_NEW_WORLD                  = 0x03E,
+    CMSG_MESSAGECHAT                = 0x095,
+    SMSG_MESSAGECHAT                = 0x096,
+    MSG_MOVE_START_FORWARD          = 0x0B5,
+    MSG_MOVE_STOP                   = 0x0B7,
+    MSG_MOVE_WORLDPORT_ACK          = 0x0DC,
+    MSG_MOVE_HEARTBEAT              = 0x0EE,
+    CMSG_CAST_SPELL                 = 0x12E,
+    SMSG_CAST_RESULT                = 0x130,
+    CMSG_PING                       = 0x1DC,
+    SMSG_PONG                       = 0x1DD,
+    SMSG_AUTH_CHALLENGE             = 0x1EC,
+    CMSG_AUTH_SESSION               = 0x1ED,
+    SMSG_AUTH_RESPONSE              = 0x1EE,
+    SMSG_LOGIN_VERIFY_WORLD         = 0x236,
+    CMSG_AUCTION_LIST_ITEMS         = 0x258,
+    SMSG_AUCTION_LIST_RESULT        = 0x25C,
+};
+
+inline char const* LookupLoadGenOpcodeName(uint16 opcode)
+{
+    switch (opcode)
+    {
+        case CMSG_CHAR_CREATE:          return "CMSG_CHAR_CREATE";
+        case CMSG_CHAR_ENUM:            return "CMSG_CHAR_ENUM";
+        case CMSG_PLAYER_LOGIN:         return "CMSG_PLAYER_LOGIN";
+        case CMSG_MESSAGECHAT:          return "CMSG_MESSAGECHAT";
+        case MSG_MOVE_START_FORWARD:    return "MSG_MOVE_START_FORWARD";
+        case MSG_MOVE_STOP:             return "MSG_MOVE_STOP";
+        case MSG_MOVE_WORLDPORT_ACK:    return "MSG_MOVE_WORLDPORT_ACK";
+        case MSG_MOVE_HEARTBEAT:        return "MSG_MOVE_HEARTBEAT";
+        case CMSG_CAST_SPELL:           return "CMSG_CAST_SPELL";
+        case CMSG_PING:                 return "CMSG_PING";
+        case CMSG_AUTH_SESSION:         return "CMSG_AUTH_SESSION";
+        case CMSG_AUCTION_LIST_ITEMS:   return "CMSG_AUCTION_LIST_ITEMS";
+        default:                        return "UNKNOWN";
+    }
+}
+
+// auth results and chat constants used, see SharedDefines.h
+enum LoadGenConstants
+{
+    LOADGEN_AUTH_OK                 = 0x0C,
+    LOADGEN_AUTH_WAIT_QUEUE         = 0x1B,
+    LOADGEN_CHAR_CREATE_SUCCESS     = 0x2E,
+    LOADGEN_CHAT_MSG_SAY            = 0x00,
+    LOADGEN_CHAT_MSG_SYSTEM         = 0x0A,
+    LOADGEN_LANG_UNIVERSAL          = 0,
+    LOADGEN_MOVEFLAG_FORWARD        = 0x00000001,
+};
+
+#endif
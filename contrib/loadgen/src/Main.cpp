@@ -0,0 +1,167 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Headless load generator: drives synthetic 1.12 clients against realmd and mangosd and reports
+/// per opcode latency histograms together with the server's average update diff.
+
+#include "Common.h"
+#include "LoadClient.h"
+#include "LatencyStats.h"
+
+#include <boost/program_options.hpp>
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    std::atomic<bool> s_stopRequested(false);
+
+    void OnSignal(int /*signal*/)
+    {
+        s_stopRequested = true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    LoadGenConfig config;
+    uint32 threads = 2;
+    uint32 duration = 0;
+    uint32 reportInterval = 10;
+    std::string auctioneer;
+
+    boost::program_options::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "print usage message")
+    ("host", boost::program_options::value<std::string>(&config.realmHost)->default_value(config.realmHost), "realmd host")
+    ("port", boost::program_options::value<uint16>(&config.realmPort)->default_value(config.realmPort), "realmd port")
+    ("realm", boost::program_options::value<std::string>(&config.realmName), "realm name, first listed realm when omitted")
+    ("account-prefix", boost::program_options::value<std::string>(&config.accountPrefix)->default_value(config.accountPrefix), "accounts are named <prefix><number>")
+    ("password", boost::program_options::value<std::string>(&config.password)->default_value(config.password), "password shared by all accounts")
+    ("first-account", boost::program_options::value<uint32>(&config.firstAccount)->default_value(config.firstAccount), "number of the first account")
+    ("clients,n", boost::program_options::value<uint32>(&config.clients)->default_value(config.clients), "number of clients")
+    ("threads,t", boost::program_options::value<uint32>(&threads)->default_value(threads), "network threads")
+    ("connect-interval", boost::program_options::value<uint32>(&config.connectInterval)->default_value(config.connectInterval), "ms between two client logins")
+    ("move-interval", boost::program_options::value<uint32>(&config.moveInterval)->default_value(config.moveInterval), "ms between movement packets, 0 disables")
+    ("chat-interval", boost::program_options::value<uint32>(&config.chatInterval)->default_value(config.chatInterval), "ms between say messages, 0 disables")
+    ("cast-interval", boost::program_options::value<uint32>(&config.castInterval)->default_value(config.castInterval), "ms between spell casts, 0 disables")
+    ("spell", boost::program_options::value<uint32>(&config.spellId)->default_value(config.spellId), "self cast spell id")
+    ("auction-interval", boost::program_options::value<uint32>(&config.auctionInterval)->default_value(config.auctionInterval), "ms between auction house searches, 0 disables")
+    ("auctioneer", boost::program_options::value<std::string>(&auctioneer), "full guid (hex) of an auctioneer in range of the characters")
+    ("ping-interval", boost::program_options::value<uint32>(&config.pingInterval)->default_value(config.pingInterval), "ms between pings, 0 disables")
+    ("server-stats-interval", boost::program_options::value<uint32>(&config.serverStatsInterval)->default_value(config.serverStatsInterval), "ms between server diff samples, 0 disables")
+    ("duration,d", boost::program_options::value<uint32>(&duration)->default_value(duration), "run time in seconds, 0 runs until interrupted")
+    ("report-interval", boost::program_options::value<uint32>(&reportInterval)->default_value(reportInterval), "seconds between intermediate reports, 0 disables");
+
+    boost::program_options::variables_map vm;
+
+    try
+    {
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+    }
+    catch (boost::program_options::error const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    if (!auctioneer.empty())
+        config.auctioneerGuid = std::stoull(auctioneer, nullptr, 16);
+
+    if (!threads)
+        threads = 1;
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    LatencyStats stats;
+
+    std::vector<std::unique_ptr<boost::asio::io_context>> contexts;
+    std::vector<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> workGuards;
+    std::vector<std::thread> workers;
+    for (uint32 i = 0; i < threads; ++i)
+    {
+        contexts.push_back(std::make_unique<boost::asio::io_context>());
+        workGuards.push_back(boost::asio::make_work_guard(*contexts.back()));
+    }
+    for (auto& context : contexts)
+        workers.emplace_back([&context]() { context->run(); });
+
+    printf("Starting %u clients as %s%u..%s%u against %s:%u\n", config.clients, config.accountPrefix.c_str(), config.firstAccount,
+           config.accountPrefix.c_str(), config.firstAccount + config.clients - 1, config.realmHost.c_str(), config.realmPort);
+
+    auto const start = std::chrono::steady_clock::now();
+    auto nextReport = start + std::chrono::seconds(reportInterval);
+
+    std::vector<std::shared_ptr<LoadClient>> clients;
+    clients.reserve(config.clients);
+    for (uint32 i = 0; i < config.clients && !s_stopRequested; ++i)
+    {
+        boost::asio::io_context& context = *contexts[i % threads];
+        std::shared_ptr<LoadClient> client = std::make_shared<LoadClient>(context, config, stats, i);
+        clients.push_back(client);
+        boost::asio::post(context, [client]() { client->Start(); });
+
+        if (config.connectInterval)
+            std::this_thread::sleep_for(std::chrono::milliseconds(config.connectInterval));
+    }
+
+    while (!s_stopRequested)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        auto const now = std::chrono::steady_clock::now();
+        if (duration && now - start >= std::chrono::seconds(duration))
+            break;
+
+        if (reportInterval && now >= nextReport)
+        {
+            nextReport = now + std::chrono::seconds(reportInterval);
+            printf("\n--- %lds ---\n", long(std::chrono::duration_cast<std::chrono::seconds>(now - start).count()));
+            stats.Report(false);
+        }
+    }
+
+    for (uint32 i = 0; i < clients.size(); ++i)
+        boost::asio::post(*contexts[i % threads], [client = clients[i]]() { client->Stop(); });
+
+    // give the clients a moment to close their sockets before the contexts are stopped
+    workGuards.clear();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    for (auto& context : contexts)
+        context->stop();
+    for (auto& worker : workers)
+        worker.join();
+
+    printf("\n--- final report ---\n");
+    stats.Report(true);
+    return 0;
+}
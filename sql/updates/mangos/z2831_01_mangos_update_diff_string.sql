@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_z2830_01_mangos_icon_name required_z2831_01_mangos_update_diff_string bit;
+
+DELETE FROM `mangos_string` WHERE `entry` IN (68);
+INSERT INTO `mangos_string` VALUES
+(68,'Update diff: %u ms average',NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL);
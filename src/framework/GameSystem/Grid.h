@@ -28,6 +28,8 @@
   a subtle difference between dynamic loader and on-demand loader but
   this is implementation specific to the loader class.  From the
   Grid's perspective, the loader meets its API requirement is suffice.
+  Every object entering or leaving the grid is also handed to the
+  CELL_INDEX, which can keep its own flat copy of the cell content.
 */
 
 #include "Platform/Define.h"
@@ -36,18 +38,19 @@
 #include "TypeContainerVisitor.h"
 
 // forward declaration
-template<class A, class T, class O> class GridLoader;
+template<class A, class T, class O, class I> class GridLoader;
 
 template
 <
     class ACTIVE_OBJECT,
     class WORLD_OBJECT_TYPES,
-    class GRID_OBJECT_TYPES
+    class GRID_OBJECT_TYPES,
+    class CELL_INDEX
     >
 class Grid
 {
         // allows the GridLoader to access its internals
-        template<class A, class T, class O> friend class GridLoader;
+        template<class A, class T, class O, class I> friend class GridLoader;
 
     public:
 
@@ -61,6 +64,7 @@ class Grid
         template<class SPECIFIC_OBJECT>
         bool AddWorldObject(SPECIFIC_OBJECT* obj)
         {
+            i_index.Insert(obj);
             return i_objects.template insert<SPECIFIC_OBJECT>(obj);
         }
 
@@ -69,6 +73,7 @@ class Grid
         template<class SPECIFIC_OBJECT>
         bool RemoveWorldObject(SPECIFIC_OBJECT* obj)
         {
+            i_index.Remove(obj);
             return i_objects.template remove<SPECIFIC_OBJECT>(obj);
         }
 
@@ -103,6 +108,7 @@ class Grid
             if (obj->isActiveObject())
                 m_activeGridObjects.insert(obj);
 
+            i_index.Insert(obj);
             return i_container.template insert<SPECIFIC_OBJECT>(obj);
         }
 
@@ -114,15 +120,21 @@ class Grid
             if (obj->isActiveObject())
                 m_activeGridObjects.erase(obj);
 
+            i_index.Remove(obj);
             return i_container.template remove<SPECIFIC_OBJECT>(obj);
         }
 
+        /** Flat index of every object within the grid
+         */
+        const CELL_INDEX& GetIndex() const { return i_index; }
+
     private:
 
         TypeMapContainer<GRID_OBJECT_TYPES> i_container;
         TypeMapContainer<WORLD_OBJECT_TYPES> i_objects;
         typedef std::set<void*> ActiveGridObjects;
         ActiveGridObjects m_activeGridObjects;
+        CELL_INDEX i_index;
 };
 
 #endif
@@ -26,6 +26,7 @@
 #include "GameSystem/GridReference.h"
 #include "Util/Timer.h"
 
+#include <bitset>
 #include <cassert>
 
 class GridInfo
@@ -78,13 +79,14 @@ template
     uint32 N,
     class ACTIVE_OBJECT,
     class WORLD_OBJECT_TYPES,
-    class GRID_OBJECT_TYPES
+    class GRID_OBJECT_TYPES,
+    class CELL_INDEX
     >
 class NGrid
 {
     public:
 
-        typedef Grid<ACTIVE_OBJECT, WORLD_OBJECT_TYPES, GRID_OBJECT_TYPES> GridType;
+        typedef Grid<ACTIVE_OBJECT, WORLD_OBJECT_TYPES, GRID_OBJECT_TYPES, CELL_INDEX> GridType;
 
         NGrid(uint32 id, uint32 x, uint32 y, time_t expiry, bool unload = true)
             : i_gridId(id), i_x(x), i_y(y), i_cellstate(GRID_STATE_INVALID), i_GridObjectDataLoaded(false)
@@ -112,7 +114,7 @@ class NGrid
         uint32 getX() const { return i_x; }
         uint32 getY() const { return i_y; }
 
-        void link(GridRefManager<NGrid<N, ACTIVE_OBJECT, WORLD_OBJECT_TYPES, GRID_OBJECT_TYPES> >* pTo)
+        void link(GridRefManager<NGrid<N, ACTIVE_OBJECT, WORLD_OBJECT_TYPES, GRID_OBJECT_TYPES, CELL_INDEX> >* pTo)
         {
             i_Reference.link(pTo, this);
         }
@@ -120,6 +122,11 @@ class NGrid
         bool isGridObjectDataLoaded() const { return i_GridObjectDataLoaded; }
         void setGridObjectDataLoaded(bool pLoaded) { i_GridObjectDataLoaded = pLoaded; }
 
+        // with staged loading a grid is loading until the objects of every cell were loaded
+        bool isCellObjectDataLoaded(uint32 x, uint32 y) const { return i_loadedCells.test(x * N + y); }
+        void setCellObjectDataLoaded(uint32 x, uint32 y) { i_loadedCells.set(x * N + y); }
+        bool isGridObjectDataComplete() const { return i_loadedCells.all(); }
+
         GridInfo* getGridInfoRef() { return &i_GridInfo; }
         const TimeTracker& getTimeTracker() const { return i_GridInfo.getTimeTracker(); }
         bool getUnloadLock() const { return i_GridInfo.getUnloadLock(); }
@@ -155,6 +162,13 @@ class NGrid
             getGridType(x, y).Visit(visitor);
         }
 
+        const CELL_INDEX& GetIndex(const uint32 x, const uint32 y) const
+        {
+            assert(x < N);
+            assert(y < N);
+            return i_cells[x][y].GetIndex();
+        }
+
         uint32 ActiveObjectsInGrid() const
         {
             uint32 count = 0;
@@ -188,12 +202,13 @@ class NGrid
 
         uint32 i_gridId;
         GridInfo i_GridInfo;
-        GridReference<NGrid<N, ACTIVE_OBJECT, WORLD_OBJECT_TYPES, GRID_OBJECT_TYPES> > i_Reference;
+        GridReference<NGrid<N, ACTIVE_OBJECT, WORLD_OBJECT_TYPES, GRID_OBJECT_TYPES, CELL_INDEX> > i_Reference;
         uint32 i_x;
         uint32 i_y;
         grid_state_t i_cellstate;
         GridType i_cells[N][N];
         bool i_GridObjectDataLoaded;
+        std::bitset<N * N> i_loadedCells;
 };
 
 #endif
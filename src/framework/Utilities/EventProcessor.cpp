@@ -18,9 +18,26 @@
 
 #include "EventProcessor.h"
 
+#include <algorithm>
+
+namespace
+{
+    // std heap functions build a max heap, the earliest event has to compare greatest
+    struct EventOrder
+    {
+        bool operator()(BasicEvent const* left, BasicEvent const* right) const
+        {
+            if (left->m_execTime != right->m_execTime)
+                return left->m_execTime > right->m_execTime;
+            return left->m_sequence > right->m_sequence;
+        }
+    };
+}
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_sequence = 0;
     m_aborting = false;
 }
 
@@ -35,12 +52,12 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (!m_events.empty() && m_events.front()->m_execTime <= m_time)
     {
         // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        std::pop_heap(m_events.begin(), m_events.end(), EventOrder());
+        BasicEvent* Event = m_events.back();
+        m_events.pop_back();
 
         if (!Event->to_Abort)
         {
@@ -63,39 +80,32 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
-    // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    // first, abort all existing events, non deletable ones are kept
+    size_t kept = 0;
+    for (size_t i = 0; i < m_events.size(); ++i)
     {
-        EventList::iterator i_old = i;
-        ++i;
-
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
-        {
-            delete i_old->second;
-
-            if (!force)                                     // need per-element cleanup
-                m_events.erase(i_old);
-        }
+        BasicEvent* Event = m_events[i];
+        Event->to_Abort = true;
+        Event->Abort(m_time);
+        if (force || Event->IsDeletable())
+            delete Event;
+        else
+            m_events[kept++] = Event;
     }
 
-    // fast clear event list (in force case)
-    if (force)
-        m_events.clear();
+    m_events.resize(kept);
+    std::make_heap(m_events.begin(), m_events.end(), EventOrder());
 }
 
 void EventProcessor::KillEvent(BasicEvent* event)
 {
-    for (EventList::iterator iter = m_events.begin(); iter != m_events.end();)
-    {
-        if (iter->second == event)
-        {
-            delete iter->second;
-            iter = m_events.erase(iter);
-        }
-        else ++iter;
-    }
+    auto itr = std::find(m_events.begin(), m_events.end(), event);
+    if (itr == m_events.end())
+        return;
+
+    delete event;
+    m_events.erase(itr);
+    std::make_heap(m_events.begin(), m_events.end(), EventOrder());
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -104,21 +114,27 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
         Event->m_addTime = m_time;
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    PushEvent(Event);
 }
 
-void EventProcessor::ModifyEventTime(BasicEvent* Event, uint64 msTime)
+void EventProcessor::PushEvent(BasicEvent* Event)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end(); ++itr)
-    {
-        if (itr->second != Event)
-            continue;
+    Event->m_sequence = m_sequence++;
+    m_events.push_back(Event);
+    std::push_heap(m_events.begin(), m_events.end(), EventOrder());
+}
 
-        Event->m_execTime = msTime;
-        m_events.erase(itr);
-        m_events.insert(std::pair<uint64, BasicEvent*>(msTime, Event));
-        break;
-    }
+void EventProcessor::ModifyEventTime(BasicEvent* Event, uint64 msTime)
+{
+    auto itr = std::find(m_events.begin(), m_events.end(), Event);
+    if (itr == m_events.end())
+        return;
+
+    // requeued behind the events already planned for the new time
+    m_events.erase(itr);
+    std::make_heap(m_events.begin(), m_events.end(), EventOrder());
+    Event->m_execTime = msTime;
+    PushEvent(Event);
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
@@ -21,7 +21,7 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <vector>
 
 // Note. All times are in milliseconds here.
 
@@ -53,9 +53,11 @@ class BasicEvent
         // these can be used for time offset control
         uint64 m_addTime;                                   // time when the event was added to queue, filled by event handler
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
+        uint64 m_sequence;                                  // keeps events planned for the same time in insertion order, filled by event handler
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+// binary min heap on execution time, the storage is reused so queueing an event does not allocate
+typedef std::vector<BasicEvent*> EventList;
 
 class EventProcessor
 {
@@ -70,11 +72,14 @@ class EventProcessor
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         void ModifyEventTime(BasicEvent* event, uint64 msTime);
         uint64 CalculateTime(uint64 t_offset) const;
-        EventList& GetEvents() { return m_events; }
+        EventList const& GetEvents() const { return m_events; }
 
     protected:
 
+        void PushEvent(BasicEvent* Event);
+
         uint64 m_time;
+        uint64 m_sequence;
         EventList m_events;
         bool m_aborting;
 };
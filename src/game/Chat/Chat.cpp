@@ -228,6 +228,21 @@ ChatCommand* ChatHandler::getCommandTable()
         { nullptr,          0,                  false, nullptr,                                             "", nullptr }
     };
 
+    static ChatCommand debugProfileCommandTable[] =
+    {
+        { "start",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugProfileStartCommand,        "", nullptr },
+        { "stop",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugProfileStopCommand,         "", nullptr },
+        { "",               SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugProfileCommand,             "", nullptr },
+        { nullptr,          0,                  false, nullptr,                                             "", nullptr }
+    };
+
+    static ChatCommand debugOpcodeStatsCommandTable[] =
+    {
+        { "reset",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOpcodeStatsResetCommand,    "", nullptr },
+        { "",               SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOpcodeStatsCommand,         "", nullptr },
+        { nullptr,          0,                  false, nullptr,                                             "", nullptr }
+    };
+
     static ChatCommand debugSpawnsCommandtable[] =
     {
         { "list",           SEC_GAMEMASTER,     false, &ChatHandler::HandleDebugSpawnsList,                 "", nullptr },
@@ -265,10 +280,12 @@ ChatCommand* ChatHandler::getCommandTable()
         { "moveflag",       SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugMoveflags,                  "", nullptr },
         { "visibility",     SEC_MODERATOR,      false, nullptr,                                             "", debugVisibilityCommandTable },
         { "perf",           SEC_ADMINISTRATOR,  false, nullptr,                                             "", debugPerformanceCommandTable },
+        { "profile",        SEC_ADMINISTRATOR,  true,  nullptr,                                             "", debugProfileCommandTable },
         { "utf8overflow",   SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOverflowCommand,            "", nullptr },
         { "chatfreeze",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugChatFreezeCommand,          "", nullptr },
         { "opcodeouthistory",SEC_ADMINISTRATOR, true,  &ChatHandler::HandleDebugOutPacketHistory,           "", nullptr },
         { "opcodeinchistory",SEC_ADMINISTRATOR, true,  &ChatHandler::HandleDebugIncPacketHistory,           "", nullptr },
+        { "opcodestats",    SEC_ADMINISTRATOR,  true,  nullptr,                                             "", debugOpcodeStatsCommandTable },
         { "transports",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugTransports,                 "", nullptr },
         { "spawn",          SEC_GAMEMASTER,     true,  nullptr,                                             "", debugSpawnsCommandtable },
         { "debugflags",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugObjectFlags,                "", nullptr },
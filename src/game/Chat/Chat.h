@@ -288,6 +288,11 @@ class ChatHandler
 
         bool HandleShowTemporarySpawnList(char* args);
         bool HandleGridsLoadedCount(char* args);
+        bool HandleDebugProfileCommand(char* args);
+        bool HandleDebugProfileStartCommand(char* args);
+        bool HandleDebugProfileStopCommand(char* args);
+        bool HandleDebugOpcodeStatsCommand(char* args);
+        bool HandleDebugOpcodeStatsResetCommand(char* args);
 
         bool HandleDebugPlayCinematicCommand(char* args);
         bool HandleDebugPlaySoundCommand(char* args);
@@ -36,6 +36,9 @@
 #include "Maps/InstanceData.h"
 #include "Cinematics/M2Stores.h"
 #include "Entities/Transports.h"
+#include "World/World.h"
+#include "Util/TickProfiler.h"
+#include "Server/OpcodeStats.h"
 #include <string>
 
 bool ChatHandler::HandleDebugSendSpellFailCommand(char* args)
@@ -1418,7 +1421,100 @@ bool ChatHandler::HandleGridsLoadedCount(char* /*args*/)
     if (!player)
         return false;
 
-    PSendSysMessage("There are currently %u loaded grids.", player->GetMap()->GetLoadedGridsCount());
+    PSendSysMessage("There are currently %u loaded grids, %u of them still loading.", player->GetMap()->GetLoadedGridsCount(), player->GetMap()->GetLoadingGridsCount());
+    return true;
+}
+
+bool ChatHandler::HandleDebugProfileCommand(char* /*args*/)
+{
+    if (sTickProfiler.IsCapturing())
+        SendSysMessage("Profiler capture is running, stop it with .debug profile stop");
+    else
+        SendSysMessage("Profiler capture is not running, start it with .debug profile start");
+
+    uint32 threshold = sWorld.getConfig(CONFIG_UINT32_PROFILER_SLOW_TICK_THRESHOLD);
+    if (threshold)
+        PSendSysMessage("Ticks taking %u ms or more are written out automatically.", threshold);
+    return true;
+}
+
+bool ChatHandler::HandleDebugProfileStartCommand(char* /*args*/)
+{
+    if (!sTickProfiler.StartCapture())
+    {
+        SendSysMessage("Profiler capture is already running.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    SendSysMessage("Profiler capture started.");
+    return true;
+}
+
+bool ChatHandler::HandleDebugProfileStopCommand(char* /*args*/)
+{
+    if (!sTickProfiler.IsCapturing())
+    {
+        SendSysMessage("Profiler capture is not running.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    std::string fileName;
+    uint32 eventCount;
+    if (!sTickProfiler.StopCapture(fileName, eventCount))
+    {
+        SendSysMessage("Profiler capture is not running.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Profiler capture stopped, %u zones are being written to %s", eventCount, fileName.c_str());
+    return true;
+}
+
+bool ChatHandler::HandleDebugOpcodeStatsCommand(char* args)
+{
+    uint32 limit;
+    if (!ExtractOptUInt32(&args, limit, 20))
+        return false;
+
+    if (!sOpcodeStats.IsEnabled())
+        SendSysMessage("Opcode stats are disabled, enable Profiler.OpcodeStats to record them.");
+
+    std::vector<OpcodeStatsEntry> entries = sOpcodeStats.Collect();
+    PSendSysMessage("Opcode handler times since %s, reset with .debug opcodestats reset", TimeToTimestampStr(sOpcodeStats.GetResetTime()).c_str());
+
+    uint64 contextCount[MAX_OPCODE_CONTEXT] = {};
+    uint64 contextTime[MAX_OPCODE_CONTEXT] = {};
+    for (OpcodeStatsEntry const& entry : entries)
+    {
+        contextCount[entry.context] += entry.count;
+        contextTime[entry.context] += entry.totalTime;
+    }
+
+    for (uint32 i = 0; i < MAX_OPCODE_CONTEXT; ++i)
+        PSendSysMessage("%s: " UI64FMTD " calls, " UI64FMTD " ms", OpcodeStats::GetContextName(OpcodeStatsContext(i)), contextCount[i], contextTime[i] / 1000);
+
+    std::sort(entries.begin(), entries.end(), [](OpcodeStatsEntry const& left, OpcodeStatsEntry const& right)
+    {
+        return left.totalTime > right.totalTime;
+    });
+
+    if (entries.size() > limit)
+        entries.resize(limit);
+
+    for (OpcodeStatsEntry const& entry : entries)
+        PSendSysMessage("%s [%s] calls " UI64FMTD " bytes " UI64FMTD " total " UI64FMTD " ms p50 " UI64FMTD " us p99 " UI64FMTD " us max " UI64FMTD " us",
+                        opcodeTable[entry.opcode].name, OpcodeStats::GetContextName(entry.context), entry.count, entry.bytes,
+                        entry.totalTime / 1000, entry.p50Time, entry.p99Time, entry.maxTime);
+    return true;
+}
+
+bool ChatHandler::HandleDebugOpcodeStatsResetCommand(char* /*args*/)
+{
+    sOpcodeStats.Reset();
+    SendSysMessage("Opcode handler times reset.");
     return true;
 }
 
@@ -1182,10 +1182,17 @@ WorldObject::WorldObject() :
     m_transport(nullptr), m_isOnEventNotified(false),
     m_visibilityData(this), m_currMap(nullptr),
     m_mapId(0), m_InstanceId(0),
+    m_cellIndex(nullptr), m_cellIndexSlot(0),
     m_isActiveObject(false), m_debugFlags(0), m_castCounter(0)
 {
 }
 
+WorldObject::~WorldObject()
+{
+    if (m_cellIndex)
+        m_cellIndex->RemoveObject(this);
+}
+
 void WorldObject::CleanupsBeforeDelete()
 {
     m_events.KillAllEvents(false);                      // non-delatable (currently casted spells) will not deleted now but it will deleted at call in Map::RemoveAllObjectsInRemoveList
@@ -1216,6 +1223,9 @@ void WorldObject::Relocate(float x, float y, float z, float orientation)
 
     if (isType(TYPEMASK_UNIT))
         m_movementInfo.ChangePosition(x, y, z, orientation);
+
+    if (m_cellIndex)
+        m_cellIndex->Relocate(m_cellIndexSlot, this);
 }
 
 void WorldObject::Relocate(float x, float y, float z)
@@ -1226,6 +1236,9 @@ void WorldObject::Relocate(float x, float y, float z)
 
     if (isType(TYPEMASK_UNIT))
         m_movementInfo.ChangePosition(x, y, z, GetOrientation());
+
+    if (m_cellIndex)
+        m_cellIndex->Relocate(m_cellIndexSlot, this);
 }
 
 void WorldObject::SetOrientation(float orientation)
@@ -200,8 +200,15 @@ class CooldownContainer
         typedef spellIdMap::iterator Iterator;
         typedef std::map<uint32, ConstIterator> categoryMap;
 
+        CooldownContainer() : m_nextExpireTime(TimePoint::max()) {}
+
         void Update(TimePoint const& now)
         {
+            // nothing expires before the earliest expiry time set since the last walk
+            if (now < m_nextExpireTime)
+                return;
+
+            m_nextExpireTime = TimePoint::max();
             auto spellCDItr = m_spellIdMap.begin();
             while (spellCDItr != m_spellIdMap.end())
             {
@@ -215,6 +222,13 @@ class CooldownContainer
                         m_categoryMap.erase(cd->m_category);
                         cd->m_category = 0;
                     }
+                    if (!cd->IsPermanent())
+                    {
+                        if (!cd->IsSpellCDExpired(now))
+                            m_nextExpireTime = std::min(m_nextExpireTime, cd->m_expireTime);
+                        if (cd->m_category)
+                            m_nextExpireTime = std::min(m_nextExpireTime, cd->m_catExpireTime);
+                    }
                     ++spellCDItr;
                 }
             }
@@ -224,6 +238,12 @@ class CooldownContainer
         {
             RemoveBySpellId(spellId);
             auto resultItr = m_spellIdMap.emplace(spellId, std::make_unique<CooldownData>(clockNow, spellId, duration, spellCategory, categoryDuration, itemId, onHold));
+            if (resultItr.second && !onHold)
+            {
+                m_nextExpireTime = std::min(m_nextExpireTime, resultItr.first->second->m_expireTime);
+                if (spellCategory && categoryDuration)
+                    m_nextExpireTime = std::min(m_nextExpireTime, resultItr.first->second->m_catExpireTime);
+            }
             // do not overwrite one permanent category cooldown with another permanent category cooldown
             if (resultItr.second && spellCategory && categoryDuration)
             {
@@ -235,6 +255,8 @@ class CooldownContainer
                     {
                         catItr->second->SetCatCDExpireTime(std::chrono::milliseconds(categoryDuration) + clockNow);
                         catItr->second->m_typePermanent = false;
+                        // the former owner may have been permanent, its spell cooldown has to be checked again too
+                        m_nextExpireTime = TimePoint();
                         resultItr.first->second->m_category = 0;
                     }
                     else
@@ -303,6 +325,7 @@ class CooldownContainer
     private:
         spellIdMap m_spellIdMap;
         categoryMap m_categoryMap;
+        TimePoint m_nextExpireTime;                         // earliest expiry of any non permanent cooldown
 };
 
 struct Position
@@ -877,7 +900,7 @@ class WorldObject : public Object
         friend struct WorldObjectChangeAccumulator;
 
     public:
-        virtual ~WorldObject() {}
+        virtual ~WorldObject();
 
         virtual void Update(const uint32 /*diff*/);
         virtual void Heartbeat() {}
@@ -888,6 +911,11 @@ class WorldObject : public Object
         void Relocate(float x, float y, float z, float orientation);
         void Relocate(float x, float y, float z);
 
+        // cell index slot, maintained by CellObjectIndex
+        CellObjectIndex* GetCellIndex() const { return m_cellIndex; }
+        uint32 GetCellIndexSlot() const { return m_cellIndexSlot; }
+        void SetCellIndex(CellObjectIndex* index, uint32 slot) { m_cellIndex = index; m_cellIndexSlot = slot; }
+
         void SetOrientation(float orientation);
 
         float GetPositionX() const { return m_position.x; }
@@ -1220,6 +1248,8 @@ class WorldObject : public Object
         uint32 m_InstanceId;                                // in map copy with instance id
 
         Position m_position;
+        CellObjectIndex* m_cellIndex;                       // index of the cell the object is stored in, mirrors its position
+        uint32 m_cellIndexSlot;
         ViewPoint m_viewPoint;
         bool m_isActiveObject;
         uint64 m_debugFlags;
@@ -21,6 +21,7 @@
 
 #include "Common.h"
 #include "Util/ByteBuffer.h"
+#include <algorithm>
 #include <atomic>
 
 enum TypeID
@@ -195,6 +196,54 @@ typedef std::set<ObjectGuid> GuidSet;
 typedef std::list<ObjectGuid> GuidList;
 typedef std::vector<ObjectGuid> GuidVector;
 
+// Sorted vector with the part of the set interface used by client visibility lists,
+// cheap to copy and to walk compared to GuidSet nodes
+class GuidFlatSet
+{
+    public:
+        typedef GuidVector::const_iterator const_iterator;
+        typedef const_iterator iterator;
+
+        bool insert(ObjectGuid guid)
+        {
+            GuidVector::iterator itr = std::lower_bound(m_guids.begin(), m_guids.end(), guid);
+            if (itr != m_guids.end() && *itr == guid)
+                return false;
+            m_guids.insert(itr, guid);
+            return true;
+        }
+
+        bool erase(ObjectGuid guid)
+        {
+            GuidVector::iterator itr = std::lower_bound(m_guids.begin(), m_guids.end(), guid);
+            if (itr == m_guids.end() || *itr != guid)
+                return false;
+            m_guids.erase(itr);
+            return true;
+        }
+
+        const_iterator find(ObjectGuid guid) const
+        {
+            const_iterator itr = std::lower_bound(m_guids.begin(), m_guids.end(), guid);
+            return (itr != m_guids.end() && *itr == guid) ? itr : m_guids.end();
+        }
+
+        bool contains(ObjectGuid guid) const { return find(guid) != m_guids.end(); }
+
+        // position of guid in iteration order, size() if absent
+        size_t index(ObjectGuid guid) const { return find(guid) - m_guids.begin(); }
+
+        const_iterator begin() const { return m_guids.begin(); }
+        const_iterator end() const { return m_guids.end(); }
+        ObjectGuid const& operator[](size_t index) const { return m_guids[index]; }
+        size_t size() const { return m_guids.size(); }
+        bool empty() const { return m_guids.empty(); }
+        void clear() { m_guids.clear(); }
+
+    private:
+        GuidVector m_guids;
+};
+
 // minimum buffer size for packed guid is 9 bytes
 #define PACKED_GUID_MIN_BUFFER_SIZE 9
 
@@ -467,7 +467,7 @@ void TradeData::SetAccepted(bool state, bool crosssend /*= false*/)
 
 //== Player ====================================================
 
-Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(this), m_camera(this), m_reputationMgr(this), m_launched(false)
+Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(this), m_camera(this), m_reputationMgr(this), m_launched(false), m_nearHiddenUnits(false)
 {
 #if defined(BUILD_DEPRECATED_PLAYERBOT) || defined(ENABLE_PLAYERBOTS)
     m_playerbotAI = nullptr;
@@ -17834,6 +17834,9 @@ void Player::BeforeVisibilityDestroy(Creature* creature)
 
 void Player::UpdateVisibilityOf(WorldObject const* viewPoint, WorldObject* target)
 {
+    if (target->isType(TYPEMASK_UNIT) && static_cast<Unit const*>(target)->IsStealthedOrInvisible())
+        m_nearHiddenUnits = true;
+
     if (HasAtClient(target))
     {
         if (!target->isVisibleForInState(this, viewPoint, true))
@@ -17878,6 +17881,9 @@ inline void UpdateVisibilityOf_helper(GuidSet& s64, GameObject* target)
 template<class T>
 void Player::UpdateVisibilityOf(WorldObject const* viewPoint, T* target, UpdateData& data, WorldObjectSet& visibleNow)
 {
+    if (target->isType(TYPEMASK_UNIT) && static_cast<Unit const*>(static_cast<WorldObject const*>(target))->IsStealthedOrInvisible())
+        m_nearHiddenUnits = true;
+
     if (HasAtClient(target))
     {
         if (!target->isVisibleForInState(this, viewPoint, true))
@@ -358,6 +358,7 @@ Unit::Unit() :
 
     m_Visibility = VISIBILITY_ON;
     m_AINotifyEvent = nullptr;
+    m_last_notified_cell = CellPair(TOTAL_NUMBER_OF_CELLS_PER_MAP, TOTAL_NUMBER_OF_CELLS_PER_MAP);
 
     m_transform = 0;
     m_canModifyStats = false;
@@ -465,13 +466,8 @@ void Unit::Update(const uint32 diff)
     if (!IsInWorld())
         return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.update", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-    }, 1000);
+    static metric::series_id const series = metric::register_series("unit.update", metric::series_type::histogram);
+    metric::timer<std::chrono::microseconds> meas(series, 1000, metric::outlier_tags(this));
 #endif
 
     /*if(p_time > m_AurasCheck)
@@ -516,13 +512,8 @@ void Unit::Update(const uint32 diff)
     if (AI() && IsAlive())
     {
 #ifdef BUILD_METRICS
-        metric::duration<std::chrono::microseconds> meas_ai("unit.update.ai", {
-            { "entry", std::to_string(GetEntry()) },
-            { "guid", std::to_string(GetGUIDLow()) },
-            { "unit_type", std::to_string(GetGUIDHigh()) },
-            { "map_id", std::to_string(GetMapId()) },
-            { "instance_id", std::to_string(GetInstanceId()) }
-        }, 1000);
+        static metric::series_id const series = metric::register_series("unit.update.ai", metric::series_type::histogram);
+        metric::timer<std::chrono::microseconds> meas_ai(series, 1000, metric::outlier_tags(this));
 #endif
 
         AI()->UpdateAI(diff);   // AI not react good at real update delays (while freeze in non-active part of map)
@@ -4063,15 +4054,17 @@ uint32 Unit::GetWeaponSkillValue(WeaponAttackType attType, Unit const* target) c
 void Unit::_UpdateSpells(uint32 time)
 {
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.update.spells", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-        }, 1000);
-
+    // declared first, the timer reads it when destroyed
     std::vector<uint32> updatedSpellIds;
+    static metric::series_id const series = metric::register_series("unit.update.spells", metric::series_type::histogram);
+    metric::timer<std::chrono::microseconds> meas(series, 1000, [this, &updatedSpellIds](metric::measurement& outlier)
+    {
+        metric::outlier_tags(this)(outlier);
+        std::string logging;
+        for (uint32 spellId : updatedSpellIds)
+            logging += std::to_string(spellId) + ",";
+        outlier.add_field("spells", "\"" + logging + "\"");
+    });
 #endif
 
     if (m_currentSpells[CURRENT_AUTOREPEAT_SPELL])
@@ -4100,24 +4093,19 @@ void Unit::_UpdateSpells(uint32 time)
     }
 
     // remove expired auras
-    for (SpellAuraHolderMap::iterator iter = m_spellAuraHolders.begin(); iter != m_spellAuraHolders.end();)
+    // removing one can remove others with it, collect them first instead of restarting the walk after every removal
+    std::vector<SpellAuraHolder*> expiredHolders;
+    for (auto& holderPair : m_spellAuraHolders)
     {
-        SpellAuraHolder* holder = iter->second;
-
+        SpellAuraHolder* holder = holderPair.second;
         if (!(holder->IsPermanent() || holder->IsPassive()) && holder->GetAuraDuration() == 0)
-        {
-            RemoveSpellAuraHolder(holder, AURA_REMOVE_BY_EXPIRE);
-            iter = m_spellAuraHolders.begin();
-        }
-        else
-            ++iter;
+            expiredHolders.push_back(holder);
     }
-#ifdef BUILD_METRICS
-    std::string logging;
-    for (uint32 spellId : updatedSpellIds)
-        logging += std::to_string(spellId) + ",";
-    meas.add_field("spells", "\"" + logging + "\"");
-#endif
+
+    // removed holders are only deleted in CleanupDeletedAuras
+    for (SpellAuraHolder* holder : expiredHolders)
+        if (!holder->IsDeleted() && holder->GetAuraDuration() == 0)
+            RemoveSpellAuraHolder(holder, AURA_REMOVE_BY_EXPIRE);
 }
 
 void Unit::_UpdateAutoRepeatSpell()
@@ -10245,6 +10233,15 @@ void Unit::RestoreDisplayId()
     SetDisplayId(GetNativeDisplayId());
 }
 
+void Unit::SetCombatReach(float combatReach)
+{
+    SetFloatValue(UNIT_FIELD_COMBATREACH, combatReach);
+
+    // range searches of the cell index widen their prefilter by the cached reach
+    if (CellObjectIndex* cellIndex = GetCellIndex())
+        cellIndex->Relocate(GetCellIndexSlot(), this);
+}
+
 void Unit::UpdateModelData()
 {
     if (CreatureModelInfo const* modelInfo = sObjectMgr.GetCreatureModelInfo(GetDisplayId()))
@@ -10255,7 +10252,7 @@ void Unit::UpdateModelData()
         // vanilla only - values need to be relative to either DBC scale for players or DB scale for creatures
         SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, normalizedScale * modelInfo->bounding_radius);
 
-        SetFloatValue(UNIT_FIELD_COMBATREACH, normalizedScale * modelInfo->combat_reach);
+        SetCombatReach(normalizedScale * modelInfo->combat_reach);
 
         SetBaseWalkSpeed(modelInfo->SpeedWalk);
         SetModelRunSpeed(modelInfo->SpeedRun);
@@ -10351,8 +10348,8 @@ Unit* Unit::SelectRandomUnfriendlyTarget(Unit* except /*= nullptr*/, float radiu
     UnitList targets;
 
     MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck u_check(this, radius);
-    MaNGOS::UnitListSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
-    Cell::VisitAllObjects(this, searcher, radius);
+    MaNGOS::IndexedUnitListSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
+    Cell::VisitIndexedObjects(this, searcher, radius, TYPEMASK_UNIT, true);
 
     // remove current target
     if (except)
@@ -10979,8 +10976,17 @@ void Unit::OnRelocated()
         m_last_notified_position.y = GetPositionY();
         m_last_notified_position.z = GetPositionZ();
 
-        GetViewPoint().Call_UpdateVisibilityForOwner();
-        UpdateObjectVisibility();
+        // incremental mode only recomputes visibility when a cell border was crossed, except
+        // when stealth or invisibility detection is involved, which depends on the distance
+        bool incremental = World::IsIncrementalVisibility() && !IsStealthedOrInvisible() &&
+                           !(GetTypeId() == TYPEID_PLAYER && static_cast<Player*>(this)->IsNearHiddenUnits());
+        CellPair cell = MaNGOS::ComputeCellPair(GetPositionX(), GetPositionY());
+        if (!incremental || cell != m_last_notified_cell)
+        {
+            m_last_notified_cell = cell;
+            GetViewPoint().Call_UpdateVisibilityForOwner();
+            UpdateObjectVisibility();
+        }
     }
     ScheduleAINotify(World::GetRelocationAINotifyDelay());
 }
@@ -10995,13 +11001,8 @@ void Unit::UpdateSplineMovement(uint32 t_diff)
     if (movespline->Finalized())
         return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.updatesplinemovement", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-    }, 1000);
+    static metric::series_id const series = metric::register_series("unit.updatesplinemovement", metric::series_type::histogram);
+    metric::timer<std::chrono::microseconds> meas(series, 1000, metric::outlier_tags(this));
 #endif
     movespline->updateState(t_diff);
     bool arrived = movespline->Finalized();
@@ -11789,8 +11790,8 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed)
     UnitList targets;
     // Maximum spellInfo range=100m ?
     MaNGOS::AnyUnitInObjectRangeCheck u_check(this, 100.0f);
-    MaNGOS::UnitListSearcher<MaNGOS::AnyUnitInObjectRangeCheck> searcher(targets, u_check);
-    Cell::VisitAllObjects(this, searcher, GetMap()->GetVisibilityDistance());
+    MaNGOS::IndexedUnitListSearcher<MaNGOS::AnyUnitInObjectRangeCheck> searcher(targets, u_check);
+    Cell::VisitIndexedObjects(this, searcher, 100.0f, TYPEMASK_UNIT, true);
     for (auto& target : targets)
     {
         if (!CanAttack(target))
@@ -11803,8 +11804,10 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed)
         if (!killDelayed)
             continue;
         // 2/ Interrupt spells that are not referenced but that still have an event (like delayed spellInfo)
-        for (auto i_events = target->m_events.GetEvents().begin(); i_events != target->m_events.GetEvents().end(); ++i_events)
-            if (SpellEvent* event = dynamic_cast<SpellEvent*>(i_events->second))
+        // cancelling may queue new events, walk a copy
+        EventList events = target->m_events.GetEvents();
+        for (BasicEvent* basicEvent : events)
+            if (SpellEvent* event = dynamic_cast<SpellEvent*>(basicEvent))
                 if (event && event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
                     if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
                         event->GetSpell()->cancel();
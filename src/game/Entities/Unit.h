@@ -1093,6 +1093,7 @@ class Unit : public WorldObject
         float GetCollisionWidth() const override;
         float GetObjectBoundingRadius() const override { return m_floatValues[UNIT_FIELD_BOUNDINGRADIUS]; } // overwrite WorldObject version
         float GetCombatReach() const override { return m_floatValues[UNIT_FIELD_COMBATREACH]; } // overwrite WorldObject version
+        void SetCombatReach(float combatReach);
 
         /**
          * Gets the current DiminishingLevels for the given group
@@ -1692,6 +1693,8 @@ class Unit : public WorldObject
 
         bool HasStealthAura()      const { return HasAuraType(SPELL_AURA_MOD_STEALTH); }
         bool HasInvisibilityAura() const { return HasAuraType(SPELL_AURA_MOD_INVISIBILITY); }
+        // detection of these depends on distance, so they can not wait for a cell border in incremental visibility
+        bool IsStealthedOrInvisible() const { return m_Visibility == VISIBILITY_GROUP_STEALTH || HasInvisibilityAura(); }
         bool isFeared()  const { return HasAuraType(SPELL_AURA_MOD_FEAR); }
         bool isInRoots() const { return HasAuraType(SPELL_AURA_MOD_ROOT); }
         bool IsPolymorphed() const;
@@ -2606,6 +2609,7 @@ class Unit : public WorldObject
 
         UnitVisibility m_Visibility;
         Position m_last_notified_position;
+        CellPair m_last_notified_cell;                      // cell of the last visibility update, used by incremental visibility
         BasicEvent* m_AINotifyEvent;
         ShortTimeTracker m_movesplineTimer;
 
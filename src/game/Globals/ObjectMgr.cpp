@@ -140,12 +140,15 @@ ObjectMgr::ObjectMgr() :
     m_FirstTemporaryCreatureGuid(1),
     m_FirstTemporaryGameObjectGuid(1),
     m_Dbc2StorageLocaleIndex(DEFAULT_LOCALE),
+    m_localeStorageIndexCount(0),
     m_unitConditionMgr(std::make_unique<UnitConditionMgr>()),
     m_worldStateExpressionMgr(std::make_unique<WorldStateExpressionMgr>()),
     m_combatConditionMgr(std::make_unique<CombatConditionMgr>(*m_unitConditionMgr, *m_worldStateExpressionMgr)),
     m_maxGoDbGuid(0),
     m_maxCreatureDbGuid(0)
 {
+    for (auto& index : m_localeStorageIndex)
+        index = -1;
 }
 
 ObjectMgr::~ObjectMgr()
@@ -8189,27 +8192,29 @@ PetNameInvalidReason ObjectMgr::CheckPetName(const std::string& name)
 
 int ObjectMgr::GetStorageLocaleIndexFor(LocaleConstant loc)
 {
-    if (loc == DEFAULT_LOCALE)
+    if (loc == DEFAULT_LOCALE || loc >= MAX_LOCALE)
         return -1;
 
-    for (size_t i = 0; i < m_LocalForIndex.size(); ++i)
-        if (m_LocalForIndex[i] == loc)
-            return i;
-
-    return -1;
+    return m_localeStorageIndex[loc].load(std::memory_order_acquire);
 }
 
 int ObjectMgr::GetOrNewStorageLocaleIndexFor(LocaleConstant loc)
 {
-    if (loc == DEFAULT_LOCALE)
+    if (loc == DEFAULT_LOCALE || loc >= MAX_LOCALE)
         return -1;
 
-    for (size_t i = 0; i < m_LocalForIndex.size(); ++i)
-        if (m_LocalForIndex[i] == loc)
-            return i;
+    int index = m_localeStorageIndex[loc].load(std::memory_order_acquire);
+    if (index >= 0)
+        return index;
 
-    m_LocalForIndex.push_back(loc);
-    return m_LocalForIndex.size() - 1;
+    std::lock_guard<std::mutex> guard(m_localeStorageIndexMutex);
+    index = m_localeStorageIndex[loc].load(std::memory_order_relaxed);
+    if (index < 0)
+    {
+        index = m_localeStorageIndexCount++;
+        m_localeStorageIndex[loc].store(index, std::memory_order_release);
+    }
+    return index;
 }
 
 bool ObjectMgr::IsEncounter(uint32 creditEntry, uint32 mapId) const
@@ -35,9 +35,11 @@
 #include "Maps/SpawnGroupDefines.h"
 #include "Util/UniqueTrackablePtr.h"
 
+#include <atomic>
 #include <map>
 #include <climits>
 #include <memory>
+#include <mutex>
 #include <tuple>
 #include <optional>
 
@@ -1290,8 +1292,9 @@ class ObjectMgr
 
         ItemRequiredTargetMap m_ItemRequiredTarget;
 
-        typedef             std::vector<LocaleConstant> LocalForIndex;
-        LocalForIndex        m_LocalForIndex;
+        std::atomic<int>     m_localeStorageIndex[MAX_LOCALE];  // -1 until a loader meets the locale, read without locking
+        int                  m_localeStorageIndexCount;
+        std::mutex           m_localeStorageIndexMutex;    // startup loaders add locales in parallel
 
         ExclusiveQuestGroupsMap m_ExclusiveQuestGroups;
 
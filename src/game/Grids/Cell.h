@@ -117,6 +117,9 @@ struct Cell
         template<class T> static void VisitWorldObjects(float x, float y, Map* map, T& visitor, float radius, bool dont_load = true);
         template<class T> static void VisitAllObjects(float x, float y, Map* map, T& visitor, float radius, bool dont_load = true);
 
+        // walks the flat cell indexes of loaded grids only, worker is called with every WorldObject* of typeMask in range
+        template<class T> static void VisitIndexedObjects(const WorldObject* obj, T& worker, float radius, uint8 typeMask, bool is3D = false);
+
     private:
         template<class T, class CONTAINER> void VisitCircle(TypeContainerVisitor<T, CONTAINER>&, Map&, const CellPair&, const CellPair&) const;
 };
@@ -244,4 +244,27 @@ inline void Cell::VisitAllObjects(float x, float y, Map* map, T& visitor, float
     cell.Visit(p, wnotifier, *map, x, y, radius);
 }
 
+template<class T>
+inline void Cell::VisitIndexedObjects(const WorldObject* center_obj, T& worker, float radius, uint8 typeMask, bool is3D)
+{
+    MANGOS_ASSERT(center_obj != nullptr);
+    Map& map = *center_obj->GetMap();
+    float x = center_obj->GetPositionX();
+    float y = center_obj->GetPositionY();
+    float z = center_obj->GetPositionZ();
+    radius += center_obj->GetCombatReach();
+
+    CellArea area = Cell::CalculateCellArea(x, y, std::min(radius, MAX_VISIBILITY_DISTANCE));
+    for (uint32 i = area.low_bound.x_coord; i <= area.high_bound.x_coord; ++i)
+    {
+        for (uint32 j = area.low_bound.y_coord; j <= area.high_bound.y_coord; ++j)
+        {
+            CellPair cell_pair(i, j);
+            Cell cell(cell_pair);
+            if (CellObjectIndex const* index = map.GetCellObjectIndex(cell))
+                index->VisitInRange(x, y, z, is3D, radius, typeMask, worker);
+        }
+    }
+}
+
 #endif
@@ -0,0 +1,79 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Grids/CellObjectIndex.h"
+#include "Entities/Object.h"
+
+CellObjectIndex::~CellObjectIndex()
+{
+    for (WorldObject* obj : m_objects)
+        obj->SetCellIndex(nullptr, 0);
+}
+
+void CellObjectIndex::InsertObject(WorldObject* obj)
+{
+    if (obj->GetCellIndex())
+        obj->GetCellIndex()->RemoveObject(obj);
+
+    uint32 slot = uint32(m_objects.size());
+    m_objects.push_back(obj);
+    m_x.push_back(obj->GetPositionX());
+    m_y.push_back(obj->GetPositionY());
+    m_z.push_back(obj->GetPositionZ());
+    m_combatReach.push_back(obj->GetCombatReach());
+    m_typeMask.push_back(obj->GetTypeMask());
+
+    obj->SetCellIndex(this, slot);
+}
+
+void CellObjectIndex::RemoveObject(WorldObject* obj)
+{
+    if (obj->GetCellIndex() != this)
+        return;
+
+    // swap the last slot into the hole to keep the arrays dense
+    uint32 slot = obj->GetCellIndexSlot();
+    uint32 last = uint32(m_objects.size()) - 1;
+    if (slot != last)
+    {
+        m_objects[slot] = m_objects[last];
+        m_x[slot] = m_x[last];
+        m_y[slot] = m_y[last];
+        m_z[slot] = m_z[last];
+        m_combatReach[slot] = m_combatReach[last];
+        m_typeMask[slot] = m_typeMask[last];
+        m_objects[slot]->SetCellIndex(this, slot);
+    }
+
+    m_objects.pop_back();
+    m_x.pop_back();
+    m_y.pop_back();
+    m_z.pop_back();
+    m_combatReach.pop_back();
+    m_typeMask.pop_back();
+
+    obj->SetCellIndex(nullptr, 0);
+}
+
+void CellObjectIndex::Relocate(uint32 slot, WorldObject const* obj)
+{
+    m_x[slot] = obj->GetPositionX();
+    m_y[slot] = obj->GetPositionY();
+    m_z[slot] = obj->GetPositionZ();
+    m_combatReach[slot] = obj->GetCombatReach();
+}
@@ -0,0 +1,97 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_CELLOBJECTINDEX_H
+#define MANGOS_CELLOBJECTINDEX_H
+
+#include "Common.h"
+#include "Util/DistanceFilter.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+class WorldObject;
+class Camera;
+
+/*
+ * Flat copy of the hot fields of every object in a grid cell.
+ * The grid reference lists stay the authority on what a cell holds, the
+ * index only mirrors them in contiguous arrays so that range searches can
+ * scan positions without chasing every object through the heap.
+ * Positions are refreshed by WorldObject::Relocate, combat reach by
+ * Unit::SetCombatReach.
+ */
+class CellObjectIndex
+{
+    public:
+        CellObjectIndex() {}
+        ~CellObjectIndex();
+
+        CellObjectIndex(CellObjectIndex const&) = delete;
+        CellObjectIndex& operator=(CellObjectIndex const&) = delete;
+
+        template<class SPECIFIC_OBJECT> void Insert(SPECIFIC_OBJECT* obj) { InsertObject(obj); }
+        template<class SPECIFIC_OBJECT> void Remove(SPECIFIC_OBJECT* obj) { RemoveObject(obj); }
+
+        // cameras only follow their owner, which is indexed itself
+        void Insert(Camera* /*camera*/) {}
+        void Remove(Camera* /*camera*/) {}
+
+        void InsertObject(WorldObject* obj);
+        void RemoveObject(WorldObject* obj);
+        void Relocate(uint32 slot, WorldObject const* obj);
+
+        uint32 Size() const { return uint32(m_objects.size()); }
+
+        // calls worker for every object matching typeMask whose distance to x, y (and z when is3D) is within radius plus its combat reach
+        // positions are tested a batch at a time by the vectorized distance filter, worker must not add or remove objects of this cell
+        template<class WORKER>
+        void VisitInRange(float x, float y, float z, bool is3D, float radius, uint8 typeMask, WORKER& worker) const
+        {
+            uint32 const size = uint32(m_objects.size());
+            for (uint32 begin = 0; begin < size; begin += MaNGOS::DistanceFilter::BATCH_SIZE)
+            {
+                uint32 count = std::min(size - begin, MaNGOS::DistanceFilter::BATCH_SIZE);
+                uint64 survivors = MaNGOS::DistanceFilter::InRange(&m_x[begin], &m_y[begin], is3D ? &m_z[begin] : nullptr, &m_combatReach[begin], count, x, y, z, radius);
+                while (survivors)
+                {
+                    uint32 i = begin + uint32(std::countr_zero(survivors));
+                    survivors &= survivors - 1;
+                    if (m_typeMask[i] & typeMask)
+                        worker(m_objects[i]);
+                }
+            }
+        }
+
+        WorldObject* GetObject(uint32 slot) const { return m_objects[slot]; }
+        float GetPositionX(uint32 slot) const { return m_x[slot]; }
+        float GetPositionY(uint32 slot) const { return m_y[slot]; }
+        float GetPositionZ(uint32 slot) const { return m_z[slot]; }
+        uint8 GetTypeMask(uint32 slot) const { return m_typeMask[slot]; }
+
+    private:
+        std::vector<WorldObject*> m_objects;
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_z;
+        std::vector<float> m_combatReach;
+        std::vector<uint8> m_typeMask;
+};
+
+#endif
@@ -46,41 +46,46 @@ void VisibleNotifier::Notify()
         return;
 #endif
 
-    // at this moment i_clientGUIDs have guids that not iterate at grid level checks
+    // at this moment unvisited i_clientGUIDs have guids that not iterate at grid level checks
     // but exist one case when this possible and object not out of range: transports
     if (GenericTransport* transport = player.GetTransport())
     {
         for (auto itr : transport->GetPassengers())
         {
-            if (i_clientGUIDs.find(itr->GetObjectGuid()) != i_clientGUIDs.end())
+            if (MarkVisited(itr->GetObjectGuid()))
             {
                 // ignore far sight case
                 if (itr->IsPlayer())
                     static_cast<Player*>(itr)->UpdateVisibilityOf(static_cast<Player*>(itr), &player);
                 player.UpdateVisibilityOf(&player, itr, i_data, i_visibleNow);
-                i_clientGUIDs.erase(itr->GetObjectGuid());
             }
         }
     }
 
     // Far objects update on player notify
-    for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end();)
+    for (size_t i = 0; i < i_clientGUIDs.size(); ++i)
     {
-        GuidSet::iterator current = itr++;
-        if (WorldObject* obj = player.GetMap()->GetWorldObject(*current))
+        if (i_visited[i])
+            continue;
+
+        if (WorldObject* obj = player.GetMap()->GetWorldObject(i_clientGUIDs[i]))
         {
             if (!obj->GetVisibilityData().IsVisibilityOverridden())
                 continue;
 
             player.UpdateVisibilityOf(&player, obj);
-            i_clientGUIDs.erase(current);
+            i_visited[i] = true;
         }
     }
 
     // generate outOfRange for not iterate objects
-    i_data.AddOutOfRangeGUID(i_clientGUIDs);
-    for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end(); ++itr)
+    for (size_t i = 0; i < i_clientGUIDs.size(); ++i)
     {
+        if (i_visited[i])
+            continue;
+
+        GuidFlatSet::const_iterator itr = i_clientGUIDs.begin() + i;
+        i_data.AddOutOfRangeGUID(*itr);
         if (WorldObject* target = player.GetMap()->GetWorldObject(*itr))
         {
             if (target->GetTypeId() == TYPEID_UNIT)
@@ -126,7 +131,7 @@ void MessageDeliverer::Visit(CameraMapType& m)
         if (i_toSelf || owner != &i_player)
         {
             if (WorldSession* session = owner->GetSession())
-                session->SendPacket(i_message);
+                session->SendPacket(i_message.Get());
         }
     }
 }
@@ -141,7 +146,7 @@ void MessageDelivererExcept::Visit(CameraMapType& m)
             continue;
 
         if (WorldSession* session = owner->GetSession())
-            session->SendPacket(i_message);
+            session->SendPacket(i_message.Get());
     }
 }
 
@@ -150,7 +155,7 @@ void ObjectMessageDeliverer::Visit(CameraMapType& m)
     for (auto& iter : m)
     {
         if (WorldSession* session = iter.getSource()->GetOwner()->GetSession())
-            session->SendPacket(i_message);
+            session->SendPacket(i_message.Get());
     }
 }
 
@@ -165,7 +170,7 @@ void MessageDistDeliverer::Visit(CameraMapType& m)
                 (!i_dist || iter.getSource()->GetBody()->IsWithinDist(&i_player, i_dist)))
         {
             if (WorldSession* session = owner->GetSession())
-                session->SendPacket(i_message);
+                session->SendPacket(i_message.Get());
         }
     }
 }
@@ -177,7 +182,7 @@ void ObjectMessageDistDeliverer::Visit(CameraMapType& m)
         if (!i_dist || iter.getSource()->GetBody()->IsWithinDist(&i_object, i_dist))
         {
             if (WorldSession* session = iter.getSource()->GetOwner()->GetSession())
-                session->SendPacket(i_message);
+                session->SendPacket(i_message.Get());
         }
     }
 }
@@ -36,13 +36,24 @@ namespace MaNGOS
     {
         Camera& i_camera;
         UpdateData i_data;
-        GuidSet i_clientGUIDs;
+        GuidFlatSet i_clientGUIDs;                          // snapshot of the client list taken before the visit
+        std::vector<bool> i_visited;                        // per i_clientGUIDs entry, seen at grid level
         WorldObjectSet i_visibleNow;
 
-        explicit VisibleNotifier(Camera& c) : i_camera(c), i_clientGUIDs(c.GetOwner()->GetClientGuids()) {}
+        explicit VisibleNotifier(Camera& c) : i_camera(c), i_clientGUIDs(c.GetOwner()->GetClientGuids()), i_visited(i_clientGUIDs.size(), false) {}
         template<class T> void Visit(GridRefManager<T>& m);
         void Visit(CameraMapType& /*m*/) {}
         void Notify(void);
+
+        // returns false when guid was not at client or already visited
+        bool MarkVisited(ObjectGuid guid)
+        {
+            size_t index = i_clientGUIDs.index(guid);
+            if (index == i_clientGUIDs.size() || i_visited[index])
+                return false;
+            i_visited[index] = true;
+            return true;
+        }
     };
 
     struct VisibleChangesNotifier
@@ -58,10 +69,25 @@ namespace MaNGOS
         GuidSet m_unvisitedGuids;
     };
 
+    // packet handed to many receivers, copied once into a shared immutable packet on first delivery
+    struct SharedMessage
+    {
+        WorldPacket const& i_message;
+        std::shared_ptr<WorldPacket const> i_shared;
+
+        explicit SharedMessage(WorldPacket const& msg) : i_message(msg) {}
+        std::shared_ptr<WorldPacket const> const& Get()
+        {
+            if (!i_shared)
+                i_shared = std::make_shared<WorldPacket const>(i_message);
+            return i_shared;
+        }
+    };
+
     struct MessageDeliverer
     {
         Player const& i_player;
-        WorldPacket const& i_message;
+        SharedMessage i_message;
         bool i_toSelf;
         MessageDeliverer(Player const& pl, WorldPacket const& msg, bool to_self) : i_player(pl), i_message(msg), i_toSelf(to_self) {}
         void Visit(CameraMapType& m);
@@ -70,7 +96,7 @@ namespace MaNGOS
 
     struct MessageDelivererExcept
     {
-        WorldPacket const&  i_message;
+        SharedMessage i_message;
         Player const* i_skipped_receiver;
 
         MessageDelivererExcept(WorldPacket const& msg, Player const* skipped)
@@ -82,7 +108,7 @@ namespace MaNGOS
 
     struct ObjectMessageDeliverer
     {
-        WorldPacket const& i_message;
+        SharedMessage i_message;
         explicit ObjectMessageDeliverer(WorldPacket const& msg) : i_message(msg) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
@@ -91,7 +117,7 @@ namespace MaNGOS
     struct MessageDistDeliverer
     {
         Player const& i_player;
-        WorldPacket const& i_message;
+        SharedMessage i_message;
         bool i_toSelf;
         bool i_ownTeamOnly;
         float i_dist;
@@ -105,7 +131,7 @@ namespace MaNGOS
     struct ObjectMessageDistDeliverer
     {
         WorldObject const& i_object;
-        WorldPacket const& i_message;
+        SharedMessage i_message;
         float i_dist;
         ObjectMessageDistDeliverer(WorldObject const& obj, WorldPacket const& msg, float dist) : i_object(obj), i_message(msg), i_dist(dist) {}
         void Visit(CameraMapType& m);
@@ -379,6 +405,23 @@ namespace MaNGOS
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
+    // adapter running a unit list search over the flat cell indexes, see Cell::VisitIndexedObjects with TYPEMASK_UNIT
+    template<class Check>
+    struct IndexedUnitListSearcher
+    {
+        UnitList& i_objects;
+        Check& i_check;
+
+        IndexedUnitListSearcher(UnitList& objects, Check& check) : i_objects(objects), i_check(check) {}
+
+        void operator()(WorldObject* obj)
+        {
+            Unit* unit = static_cast<Unit*>(obj);
+            if (i_check(unit))
+                i_objects.push_back(unit);
+        }
+    };
+
     // Creature searchers
 
     template<class Check>
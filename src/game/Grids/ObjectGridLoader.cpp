@@ -26,6 +26,7 @@
 #include "World/World.h"
 #include "Grids/CellImpl.h"
 #include "Maps/GridDefines.h"
+#include "Util/TickProfiler.h"
 
 class ObjectGridRespawnMover
 {
@@ -249,7 +250,15 @@ ObjectGridLoader::Load(GridType& grid)
 
 void ObjectGridLoader::LoadN(void)
 {
+    PROFILE_ZONE("ObjectGridLoader::LoadN");
+
     i_gameObjects = 0; i_creatures = 0; i_corpses = 0;
+
+    // the whole grid counts as loaded while its objects are loaded, as the grid itself does
+    for (unsigned int x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
+        for (unsigned int y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
+            i_grid.setCellObjectDataLoaded(x, y);
+
     i_cell.data.Part.cell_y = 0;
     for (unsigned int x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
     {
@@ -257,13 +266,28 @@ void ObjectGridLoader::LoadN(void)
         for (unsigned int y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
         {
             i_cell.data.Part.cell_y = y;
-            GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes> loader;
+            GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes, CellObjectIndex> loader;
             loader.Load(i_grid(x, y), *this);
         }
     }
     DETAIL_FILTER_LOG(LOG_FILTER_MAP_LOADING, "%u GameObjects, %u Creatures, and %u Corpses/Bones loaded for grid %u on map %u", i_gameObjects, i_creatures, i_corpses, i_grid.GetGridId(), i_map->GetId());
 }
 
+void ObjectGridLoader::LoadCell(uint32 x, uint32 y)
+{
+    PROFILE_ZONE("ObjectGridLoader::LoadCell");
+
+    i_gameObjects = 0; i_creatures = 0; i_corpses = 0;
+    i_cell.data.Part.cell_x = x;
+    i_cell.data.Part.cell_y = y;
+
+    // set first, loading objects can visit the cell again
+    i_grid.setCellObjectDataLoaded(x, y);
+
+    GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes, CellObjectIndex> loader;
+    loader.Load(i_grid(x, y), *this);
+}
+
 void ObjectGridUnloader::MoveToRespawnN()
 {
     for (unsigned int x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
@@ -44,6 +44,8 @@ class ObjectGridLoader
         void Visit(DynamicObjectMapType&) { }
 
         void LoadN(void);
+        /// loads the objects of one cell only, staged grid loading spreads the cells over several ticks
+        void LoadCell(uint32 x, uint32 y);
 
     private:
         Cell i_cell;
@@ -66,7 +68,7 @@ class ObjectGridUnloader
             {
                 for (unsigned int y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
                 {
-                    GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes> loader;
+                    GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes, CellObjectIndex> loader;
                     loader.Unload(i_grid(x, y), *this);
                 }
             }
@@ -89,7 +91,7 @@ class ObjectGridStoper
             {
                 for (unsigned int y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
                 {
-                    GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes> loader;
+                    GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes, CellObjectIndex> loader;
                     loader.Stop(i_grid(x, y), *this);
                 }
             }
@@ -103,6 +105,6 @@ class ObjectGridStoper
         NGridType& i_grid;
 };
 
-typedef GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes> GridLoaderType;
+typedef GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes, CellObjectIndex> GridLoaderType;
 
 #endif
@@ -25,9 +25,12 @@
 #include "Entities/ObjectDefines.h"
 
 #include "Maps/GridMapDefines.h"
+#include "Util/MappedFile.h"
 
 #include <atomic>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 class Creature;
 class Unit;
@@ -84,10 +87,17 @@ class GridMap
         // For fast check
         bool m_fullyLoaded;
 
-        bool loadAreaData(FILE* in, uint32 offset, uint32 size);
-        bool loadHeightData(FILE* in, uint32 offset, uint32 size);
-        bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
-        bool loadHolesData(FILE* in, uint32 offset, uint32 size);
+        // data arrays point into the mapped file, shared by every map using this terrain
+        MaNGOS::MappedFile m_file;
+        std::vector<std::unique_ptr<char[]>> m_unalignedData;
+
+        template<class T> bool readFileData(size_t offset, T& dst) const;
+        template<class T> T* mapFileData(size_t offset, size_t count);
+
+        bool loadAreaData(uint32 offset, uint32 size);
+        bool loadHeightData(uint32 offset, uint32 size);
+        bool loadGridMapLiquidData(uint32 offset, uint32 size);
+        bool loadHolesData(uint32 offset, uint32 size);
         bool isHole(int row, int col) const;
 
         // Get height functions and pointers
@@ -18,6 +18,7 @@
 
 #include "Maps/Map.h"
 #include "Maps/MapManager.h"
+#include "Maps/MapWorkers.h"
 #include "Entities/Player.h"
 #include "Grids/GridNotifiers.h"
 #include "Log/Log.h"
@@ -40,6 +41,8 @@
 #include "Weather/Weather.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 #include "BattleGround/BattleGroundMgr.h"
+#include "Maps/TerrainPrefetcher.h"
+#include "Util/TickProfiler.h"
 
 #ifdef BUILD_METRICS
  #include "Metric/Metric.h"
@@ -148,8 +151,101 @@ void Map::LoadMapAndVMap(int gx, int gy)
     if (m_bLoadedGrids[gx][gy])
         return;
 
+#ifdef BUILD_METRICS
+    auto loadStart = std::chrono::steady_clock::now();
+#endif
     if (m_TerrainData->Load(gx, gy))
         m_bLoadedGrids[gx][gy] = true;
+#ifdef BUILD_METRICS
+    TerrainPrefetcher::AddBlockedLoad(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - loadStart).count());
+#endif
+}
+
+void Map::PrefetchTerrainAhead(float oldX, float oldY, float x, float y)
+{
+    // only steady movement says where the player is heading, teleports and turns in place do not
+    float const dx = x - oldX;
+    float const dy = y - oldY;
+    float const dist = sqrt(dx * dx + dy * dy);
+    if (dist < 0.1f || dist > SIZE_OF_GRID_CELL)
+        return;
+
+    float const distance = sWorld.getConfig(CONFIG_FLOAT_TERRAIN_PREFETCH_DISTANCE);
+    float const aheadX = x + dx / dist * distance;
+    float const aheadY = y + dy / dist * distance;
+    if (!MaNGOS::IsValidMapCoord(aheadX, aheadY))
+        return;
+
+    GridPair const current = MaNGOS::ComputeGridPair(x, y);
+    GridPair const ahead = MaNGOS::ComputeGridPair(aheadX, aheadY);
+    if (current == ahead)
+        return;
+
+    // terrain grid coordinates, see EnsureGridCreated
+    int gx = (MAX_NUMBER_OF_GRIDS - 1) - ahead.x_coord;
+    int gy = (MAX_NUMBER_OF_GRIDS - 1) - ahead.y_coord;
+    if (!m_bLoadedGrids[gx][gy])
+        sTerrainPrefetcher.Prefetch(i_id, gx, gy);
+}
+
+std::shared_ptr<PathRequest> Map::RequestPath(PathFinder& path, float x, float y, float z)
+{
+    m_pathRequests.push_back(std::make_shared<PathRequest>(path, Vector3(x, y, z)));
+    return m_pathRequests.back();
+}
+
+void Map::SolvePathRequests()
+{
+    PROFILE_ZONE("Map::SolvePathRequests");
+
+    if (m_pathRequests.empty())
+        return;
+
+    // requests given up by their submitter are not worth solving, owners gone from this map cannot be solved here
+    auto end = std::remove_if(m_pathRequests.begin(), m_pathRequests.end(), [this](PathRequestPtr const& request)
+    {
+        if (request.use_count() == 1)
+            return true;
+
+        Unit const* owner = request->GetOwner();
+        if (!owner->IsInWorld() || owner->GetMap() != this)
+        {
+            request->Cancel();
+            return true;
+        }
+        return false;
+    });
+    m_pathRequests.erase(end, m_pathRequests.end());
+
+#ifdef BUILD_METRICS
+    metric::duration<std::chrono::microseconds> meas("map.update.path_requests", {
+        { "map_id", std::to_string(i_id) },
+        { "instance_id", std::to_string(i_InstanceId) }
+    });
+    meas.add_field("count", static_cast<int32>(m_pathRequests.size()));
+#endif
+
+    // the map thread only waits while the batch is solved, every worker uses a navmesh query of its own
+    MapUpdater& updater = sMapMgr.GetUpdater();
+    if (updater.activated() && m_pathRequests.size() > PATH_REQUESTS_PER_JOB)
+    {
+        m_pathSolvers.clear();
+        m_pathSolvers.reserve(m_pathRequests.size() / PATH_REQUESTS_PER_JOB + 1);
+        for (size_t begin = 0; begin < m_pathRequests.size(); begin += PATH_REQUESTS_PER_JOB)
+        {
+            m_pathSolvers.emplace_back(m_pathRequests, begin, std::min(begin + PATH_REQUESTS_PER_JOB, m_pathRequests.size()));
+            updater.schedule_update(m_pathSolvers.back(), m_pathSolveGroup);
+        }
+        updater.wait(m_pathSolveGroup);
+        m_pathSolvers.clear();
+    }
+    else
+    {
+        for (PathRequestPtr const& request : m_pathRequests)
+            request->Solve();
+    }
+
+    m_pathRequests.clear();
 }
 
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
@@ -158,6 +254,7 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(nullptr),
       m_activeNonPlayersIter(m_activeNonPlayers.end()), m_onEventNotifiedIter(m_onEventNotifiedObjects.end()),
       i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
+      m_updateCost(0), m_lastUpdateCost(0), m_pendingUpdateDiff(0), m_pendingUpdateTicks(0),
       i_data(nullptr), i_script_id(0), m_transportsIterator(m_transports.begin()), m_spawnManager(*this),
 #ifdef ENABLE_PLAYERBOTS
       m_activeZonesTimer(0), hasRealPlayers(false),
@@ -392,16 +489,81 @@ bool Map::EnsureGridLoaded(const Cell& cell)
         // summons some active object B, while B added to map grid loading called again and so on..
         setGridObjectDataLoaded(true, cell.GridX(), cell.GridY());
         ObjectGridLoader loader(*grid, this, cell);
-        loader.LoadN();
+        if (sWorld.getConfig(CONFIG_BOOL_GRID_LOADING_STAGED))
+        {
+            // only the cell asked for now, the rest within the tick budget of the next updates
+            loader.LoadCell(cell.CellX(), cell.CellY());
+            m_stagedGrids.push_back(GridPair(cell.GridX(), cell.GridY()));
+        }
+        else
+            loader.LoadN();
 
         // Add resurrectable corpses to world object list in grid
         sObjectAccessor.AddCorpsesToGrid(GridPair(cell.GridX(), cell.GridY()), (*grid)(cell.CellX(), cell.CellY()), this);
         return true;
     }
 
+    // a cell of a grid still loading is loaded at once when asked for explicitly
+    if (!grid->isCellObjectDataLoaded(cell.CellX(), cell.CellY()))
+    {
+        ObjectGridLoader loader(*grid, this, cell);
+        loader.LoadCell(cell.CellX(), cell.CellY());
+    }
+
     return false;
 }
 
+void Map::UpdateStagedGridLoading()
+{
+    PROFILE_ZONE("Map::UpdateStagedGridLoading");
+
+    if (m_stagedGrids.empty())
+        return;
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const budget = std::chrono::milliseconds(sWorld.getConfig(CONFIG_UINT32_GRID_LOADING_TICK_BUDGET));
+
+    while (!m_stagedGrids.empty())
+    {
+        GridPair const p = m_stagedGrids.front();
+        NGridType* grid = getNGrid(p.x_coord, p.y_coord);
+
+        // unloaded, or loaded completely by visits, in the meantime
+        if (!grid || !grid->isGridObjectDataLoaded() || grid->isGridObjectDataComplete())
+        {
+            m_stagedGrids.pop_front();
+            continue;
+        }
+
+        for (uint32 x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
+        {
+            for (uint32 y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
+            {
+                if (grid->isCellObjectDataLoaded(x, y))
+                    continue;
+
+                Cell cell(CellPair(p.x_coord * MAX_NUMBER_OF_CELLS + x, p.y_coord * MAX_NUMBER_OF_CELLS + y));
+                ObjectGridLoader loader(*grid, this, cell);
+                loader.LoadCell(x, y);
+
+                if (std::chrono::steady_clock::now() - start >= budget)
+                    return;
+            }
+        }
+    }
+}
+
+bool Map::IsLoaded(float x, float y) const
+{
+    if (!sWorld.getConfig(CONFIG_BOOL_GRID_LOADING_STAGED))
+        return loaded(MaNGOS::ComputeGridPair(x, y));
+
+    // objects of a staged grid cell not loaded yet are still spawned by the cell load
+    CellPair c = MaNGOS::ComputeCellPair(x, y);
+    GridPair p(c.x_coord / MAX_NUMBER_OF_CELLS, c.y_coord / MAX_NUMBER_OF_CELLS);
+    return loaded(p) && getNGrid(p.x_coord, p.y_coord)->isCellObjectDataLoaded(c.x_coord % MAX_NUMBER_OF_CELLS, c.y_coord % MAX_NUMBER_OF_CELLS);
+}
+
 uint32 Map::GetLoadedGridsCount()
 {
     uint32 count = 0;
@@ -412,6 +574,16 @@ uint32 Map::GetLoadedGridsCount()
     return count;
 }
 
+uint32 Map::GetLoadingGridsCount() const
+{
+    uint32 count = 0;
+    for (uint32 i = 0; i < MAX_NUMBER_OF_GRIDS; ++i)
+        for (uint32 k = 0; k < MAX_NUMBER_OF_GRIDS; ++k)
+            if (i_grids[i][k] && i_grids[i][k]->isGridObjectDataLoaded() && !i_grids[i][k]->isGridObjectDataComplete())
+                ++count;
+    return count;
+}
+
 void Map::ForceLoadGrid(float x, float y)
 {
     if (!IsLoaded(x, y))
@@ -588,25 +760,28 @@ void Map::MessageDistBroadcast(WorldObject const* obj, WorldPacket const& msg, f
 
 void Map::MessageMapBroadcast(WorldObject const* /*obj*/, WorldPacket const& msg)
 {
+    MaNGOS::SharedMessage message(msg);
     Map::PlayerList const& pList = GetPlayers();
     for (const auto& itr : pList)
-        itr.getSource()->SendDirectMessage(msg);
+        itr.getSource()->GetSession()->SendPacket(message.Get());
 }
 
 void Map::MessageMapBroadcastZone(WorldObject const* /*obj*/, WorldPacket const& msg, uint32 zoneId)
 {
+    MaNGOS::SharedMessage message(msg);
     Map::PlayerList const& pList = GetPlayers();
     for (const auto& itr : pList)
         if (itr.getSource()->GetZoneId() == zoneId)
-            itr.getSource()->SendDirectMessage(msg);
+            itr.getSource()->GetSession()->SendPacket(message.Get());
 }
 
 void Map::MessageMapBroadcastArea(WorldObject const* /*obj*/, WorldPacket const& msg, uint32 areaId)
 {
+    MaNGOS::SharedMessage message(msg);
     Map::PlayerList const& pList = GetPlayers();
     for (const auto& itr : pList)
         if (itr.getSource()->GetAreaId() == areaId)
-            itr.getSource()->SendDirectMessage(msg);
+            itr.getSource()->GetSession()->SendPacket(message.Get());
 }
 
 void Map::ExecuteDistWorker(WorldObject const* obj, float dist, std::function<void(Player*)> const& worker)
@@ -685,8 +860,31 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::Obje
     }
 }
 
+void Map::RunUpdate(uint32 diff)
+{
+    auto start = std::chrono::steady_clock::now();
+    Update(diff);
+    m_lastUpdateCost = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+    // moving average, a single hitch should not reorder the schedule for long
+    m_updateCost = (m_updateCost * 7 + m_lastUpdateCost) / 8;
+}
+
+uint32 Map::ConsumeUpdateDiff(uint32 diff, uint32 tickRate)
+{
+    m_pendingUpdateDiff += diff;
+    if (++m_pendingUpdateTicks < tickRate)
+        return 0;
+
+    uint32 result = m_pendingUpdateDiff;
+    m_pendingUpdateDiff = 0;
+    m_pendingUpdateTicks = 0;
+    return result;
+}
+
 void Map::Update(const uint32& t_diff)
 {
+    PROFILE_ZONE("Map::Update");
 
 #ifdef BUILD_METRICS
     metric::duration<std::chrono::milliseconds> meas("map.update", {
@@ -710,6 +908,11 @@ void Map::Update(const uint32& t_diff)
     GetMessager().Execute(this);
     m_spawnManager.Update();
 
+    UpdateStagedGridLoading();
+
+    // paths requested last tick, their submitters pick them up while updating below
+    SolvePathRequests();
+
     /// update active cells around players and active objects
     resetMarkedCells();
 
@@ -728,6 +931,7 @@ void Map::Update(const uint32& t_diff)
     // the player iterator is stored in the map object
     // to make sure calls to Map::Remove don't invalidate it
     {
+        PROFILE_ZONE("Map::UpdateSessions");
 #ifdef BUILD_METRICS
         uint32 updatedSessions = 0;
         metric::duration<std::chrono::milliseconds> sessions_meas("map.update.session", {
@@ -1024,6 +1228,11 @@ void Map::Update(const uint32& t_diff)
         i_data->Update(t_diff);
 
     m_weatherSystem->UpdateWeathers(t_diff);
+
+    // Push out everything this tick queued for the players on this map
+    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        if (Player* player = m_mapRefIter->getSource())
+            player->GetSession()->FlushSocket();
 }
 
 void Map::Remove(Player* player, bool remove)
@@ -1132,6 +1341,9 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
     Cell new_cell(new_val);
     bool same_cell = (new_cell == old_cell);
 
+    if (sWorld.getConfig(CONFIG_BOOL_TERRAIN_PREFETCH))
+        PrefetchTerrainAhead(player->GetPositionX(), player->GetPositionY(), x, y);
+
     player->Relocate(x, y, z, orientation);
 
     if (old_cell.DiffGrid(new_cell) || old_cell.DiffCell(new_cell))
@@ -1141,7 +1353,12 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
         NGridType* oldGrid = getNGrid(old_cell.GridX(), old_cell.GridY());
         RemoveFromGrid(player, oldGrid, old_cell);
         if (!old_cell.DiffGrid(new_cell))
+        {
+            // players never stand in a cell of a loading grid whose objects are not there yet
+            if (sWorld.getConfig(CONFIG_BOOL_GRID_LOADING_STAGED))
+                EnsureGridLoaded(new_cell);
             AddToGrid(player, oldGrid, new_cell);
+        }
         else
             EnsureGridLoadedAtEnter(new_cell, player);
 
@@ -1516,18 +1733,20 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket const& data) const
 {
+    MaNGOS::SharedMessage message(data);
     for (const auto& itr : m_mapRefManager)
-        itr.getSource()->GetSession()->SendPacket(data);
+        itr.getSource()->GetSession()->SendPacket(message.Get());
 }
 
 bool Map::SendToPlayersInZone(WorldPacket const& data, uint32 zoneId) const
 {
+    MaNGOS::SharedMessage message(data);
     bool foundPlayer = false;
     for (const auto& itr : m_mapRefManager)
     {
         if (itr.getSource()->GetZoneId() == zoneId)
         {
-            itr.getSource()->GetSession()->SendPacket(data);
+            itr.getSource()->GetSession()->SendPacket(message.Get());
             foundPlayer = true;
         }
     }
@@ -2240,6 +2459,8 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
 /// Process queued scripts
 void Map::ScriptsProcess()
 {
+    PROFILE_ZONE("Map::ScriptsProcess");
+
     if (m_scriptSchedule.empty())
         return;
 
@@ -2400,6 +2621,8 @@ WorldObject* Map::GetWorldObject(ObjectGuid guid)
 
 void Map::SendObjectUpdates()
 {
+    PROFILE_ZONE("Map::SendObjectUpdates");
+
     UpdateDataMapType update_players;
 
     while (!i_objectsToClientUpdate.empty())
@@ -2409,6 +2632,33 @@ void Map::SendObjectUpdates()
         obj->BuildUpdateData(update_players);
     }
 
+    // serialization and compression of crowded updates is spread over the update threads, sending stays here
+    MapUpdater& updater = sMapMgr.GetUpdater();
+    if (updater.activated() && update_players.size() >= MIN_PLAYERS_FOR_PARALLEL_UPDATE_PACKETS)
+    {
+        UpdatePacketBuilder::UpdateList updates;
+        updates.reserve(update_players.size());
+        for (auto& update_player : update_players)
+            updates.emplace_back(update_player.first, &update_player.second);
+
+        std::vector<std::vector<WorldPacket>> packets(updates.size());
+        std::vector<UpdatePacketBuilder> builders;
+        builders.reserve(updates.size() / UPDATE_PACKET_PLAYERS_PER_JOB + 1);
+
+        MapUpdater::TaskGroup group;
+        for (size_t begin = 0; begin < updates.size(); begin += UPDATE_PACKET_PLAYERS_PER_JOB)
+        {
+            builders.emplace_back(updates, begin, std::min(begin + UPDATE_PACKET_PLAYERS_PER_JOB, updates.size()), packets);
+            updater.schedule_update(builders.back(), group);
+        }
+        updater.wait(group);
+
+        for (size_t i = 0; i < updates.size(); ++i)
+            for (WorldPacket const& packet : packets[i])
+                updates[i].first->GetSession()->SendPacket(packet);
+        return;
+    }
+
     for (auto& update_player : update_players)
     {
         for (size_t i = 0; i < update_player.second.GetPacketCount(); ++i)
@@ -38,10 +38,12 @@
 #include "Globals/GraveyardManager.h"
 #include "Maps/SpawnManager.h"
 #include "Maps/MapDataContainer.h"
+#include "Maps/MapUpdater.h"
 #include "Util/UniqueTrackablePtr.h"
 #include "World/WorldStateVariableManager.h"
 
 #include <bitset>
+#include <deque>
 #include <functional>
 #include <list>
 
@@ -62,6 +64,9 @@ class GameObjectModel;
 class WeatherSystem;
 class GenericTransport;
 namespace MaNGOS { struct ObjectUpdater; }
+class PathRequestSolver;
+class PathRequest;
+class PathFinder;
 class Transport;
 
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
@@ -101,6 +106,10 @@ struct WorldTemplate
 
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
 
+#define MIN_PLAYERS_FOR_PARALLEL_UPDATE_PACKETS 32          // below this building update packets on the map thread is cheaper
+#define UPDATE_PACKET_PLAYERS_PER_JOB           16
+#define PATH_REQUESTS_PER_JOB                   8
+
 class Map : public GridRefManager<NGridType>
 {
         friend class MapReference;
@@ -132,6 +141,10 @@ class Map : public GridRefManager<NGridType>
 
         void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
         virtual void Update(const uint32&);
+        void RunUpdate(uint32 diff);
+        uint32 ConsumeUpdateDiff(uint32 diff, uint32 tickRate);
+        uint32 GetUpdateCost() const { return m_updateCost; }
+        uint32 GetLastUpdateCost() const { return m_lastUpdateCost; }
 
         void MessageBroadcast(Player const*, WorldPacket const&, bool to_self);
         void MessageBroadcast(WorldObject const*, WorldPacket const&);
@@ -156,18 +169,22 @@ class Map : public GridRefManager<NGridType>
 
         template<class T, class CONTAINER> void Visit(const Cell& cell, TypeContainerVisitor<T, CONTAINER>& visitor);
 
-        bool IsRemovalGrid(float x, float y) const
+        // flat object index of the cell, nullptr if its grid is not loaded
+        CellObjectIndex const* GetCellObjectIndex(const Cell& cell) const
         {
-            GridPair p = MaNGOS::ComputeGridPair(x, y);
-            return (!getNGrid(p.x_coord, p.y_coord) || getNGrid(p.x_coord, p.y_coord)->GetGridState() == GRID_STATE_REMOVAL);
+            if (!loaded(GridPair(cell.GridX(), cell.GridY())))
+                return nullptr;
+            return &getNGrid(cell.GridX(), cell.GridY())->GetIndex(cell.CellX(), cell.CellY());
         }
 
-        bool IsLoaded(float x, float y) const
+        bool IsRemovalGrid(float x, float y) const
         {
             GridPair p = MaNGOS::ComputeGridPair(x, y);
-            return loaded(p);
+            return (!getNGrid(p.x_coord, p.y_coord) || getNGrid(p.x_coord, p.y_coord)->GetGridState() == GRID_STATE_REMOVAL);
         }
 
+        bool IsLoaded(float x, float y) const;
+
         bool GetUnloadLock(const GridPair& p) const { return getNGrid(p.x_coord, p.y_coord)->getUnloadLock(); }
         void SetUnloadLock(const GridPair& p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadExplicitLock(on); }
         void ForceLoadGrid(float x, float y);
@@ -354,9 +371,14 @@ class Map : public GridRefManager<NGridType>
         void CreatePlayerOnClient(Player* player);
 
         uint32 GetLoadedGridsCount();
+        // grids whose cells are still loaded by GridLoading.Staged
+        uint32 GetLoadingGridsCount() const;
 
         Messager<Map>& GetMessager() { return m_messager; }
 
+        // path calculation for the owner of path, solved with the other requests at the start of the next update
+        std::shared_ptr<PathRequest> RequestPath(PathFinder& path, float x, float y, float z);
+
         typedef std::set<Transport*> TransportSet;
         GenericTransport* GetTransport(ObjectGuid guid);
         TransportSet const& GetTransports() { return m_transports; }
@@ -388,6 +410,8 @@ class Map : public GridRefManager<NGridType>
 
     private:
         void LoadMapAndVMap(int gx, int gy);
+        // queues the terrain of the grid a player moving from old to new position is heading for
+        void PrefetchTerrainAhead(float oldX, float oldY, float x, float y);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
@@ -403,6 +427,8 @@ class Map : public GridRefManager<NGridType>
         void EnsureGridCreated(const GridPair&);
         bool EnsureGridLoaded(Cell const&);
         void EnsureGridLoadedAtEnter(Cell const&, Player* player = nullptr);
+        void UpdateStagedGridLoading();
+        void SolvePathRequests();
 
         void buildNGridLinkage(NGridType* pNGridType) { pNGridType->link(this); }
 
@@ -458,9 +484,20 @@ class Map : public GridRefManager<NGridType>
         // Shared geodata object with map coord info...
         TerrainInfo* const m_TerrainData;
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        std::deque<GridPair> m_stagedGrids;                 // grids with cells left to load, see GridLoading.Staged
 
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
 
+        std::vector<std::shared_ptr<PathRequest>> m_pathRequests;
+        std::vector<PathRequestSolver> m_pathSolvers;
+        MapUpdater::TaskGroup m_pathSolveGroup;
+
+        // update cost in microseconds, used by MapManager to start the most expensive maps first
+        uint32 m_updateCost;
+        uint32 m_lastUpdateCost;
+        uint32 m_pendingUpdateDiff;
+        uint32 m_pendingUpdateTicks;
+
         WorldObjectSet i_objectsToRemove;
 
         typedef std::multimap<TimePoint, ScriptAction> ScriptScheduleMap;
@@ -600,7 +637,9 @@ Map::Visit(const Cell& cell, TypeContainerVisitor<T, CONTAINER>& visitor)
 
     if (!cell.NoCreate() || loaded(GridPair(x, y)))
     {
-        EnsureGridLoaded(cell);
+        // cells of a grid still loading are visited as they are, only the staged loader and entering players load them
+        if (!loaded(GridPair(x, y)))
+            EnsureGridLoaded(cell);
         getNGrid(x, y)->Visit(cell_x, cell_y, visitor);
     }
 }
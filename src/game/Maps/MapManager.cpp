@@ -28,14 +28,20 @@
 #include "Globals/ObjectMgr.h"
 #include "Maps/MapWorkers.h"
 #include "BattleGround/BattleGroundMgr.h"
+#include "Util/TickProfiler.h"
 #include <future>
+#include <algorithm>
+
+#ifdef BUILD_METRICS
+ #include "Metric/Metric.h"
+#endif
 
 #define CLASS_LOCK MaNGOS::ClassLevelLockable<MapManager, std::recursive_mutex>
 INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(MapManager, std::recursive_mutex);
 
 MapManager::MapManager()
-    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN))
+    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN)), m_lastMakespan(0), m_lastWork(0)
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 }
@@ -55,7 +61,7 @@ void MapManager::Initialize()
 
     int num_threads(sWorld.getConfig(CONFIG_UINT32_NUM_MAP_THREADS));
     if (num_threads > 0)
-        m_updater.activate(num_threads);
+        m_updater.activate(num_threads, sWorld.getConfig(CONFIG_BOOL_MAP_UPDATE_PIN_THREADS));
 }
 
 void MapManager::InitStateMachine()
@@ -192,20 +198,63 @@ void MapManager::DeleteInstance(uint32 mapid, uint32 instanceId)
 
 void MapManager::Update(uint32 diff)
 {
+    PROFILE_ZONE("MapManager::Update");
+
     i_timer.Update(diff);
     if (!i_timer.Passed())
         return;
 
+    uint32 idleInstanceRate = sWorld.getConfig(CONFIG_UINT32_IDLE_INSTANCE_UPDATE_RATE);
+
+    m_scheduledMaps.clear();
     for (auto& map : i_maps)
     {
-        if (m_updater.activated())
-            m_updater.schedule_update(new MapUpdateWorker(*map.second, (uint32)i_timer.GetCurrent(), m_updater));
-        else
-            map.second->Update((uint32)i_timer.GetCurrent());
+        Map* m = map.second.get();
+        uint32 tickRate = (m->Instanceable() && !m->HavePlayers()) ? idleInstanceRate : 1;
+        if (uint32 mapDiff = m->ConsumeUpdateDiff((uint32)i_timer.GetCurrent(), tickRate))
+            m_scheduledMaps.emplace_back(m, mapDiff);
     }
 
+    // cheapest first - update threads start with the newest task of their own queue,
+    // so the most expensive maps begin first and the cheap ones fill the gaps at the end
+    std::sort(m_scheduledMaps.begin(), m_scheduledMaps.end(), [](auto const& left, auto const& right)
+    {
+        return left.first->GetUpdateCost() < right.first->GetUpdateCost();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+
     if (m_updater.activated())
-        m_updater.wait();
+    {
+        // workers are reused between ticks, the reserve keeps references stable while scheduling
+        m_mapWorkers.clear();
+        m_mapWorkers.reserve(m_scheduledMaps.size());
+        for (auto& scheduled : m_scheduledMaps)
+        {
+            m_mapWorkers.emplace_back(*scheduled.first, scheduled.second);
+            m_updater.schedule_update(m_mapWorkers.back(), m_mapUpdateGroup);
+        }
+
+        m_updater.wait(m_mapUpdateGroup);
+        m_mapWorkers.clear();
+    }
+    else
+    {
+        for (auto& scheduled : m_scheduledMaps)
+            scheduled.first->RunUpdate(scheduled.second);
+    }
+
+    m_lastMakespan = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    m_lastWork = 0;
+    for (auto& scheduled : m_scheduledMaps)
+        m_lastWork += scheduled.first->GetLastUpdateCost();
+
+#ifdef BUILD_METRICS
+    metric::measurement meas("map.manager.update");
+    meas.add_field("makespan", static_cast<int64>(m_lastMakespan));
+    meas.add_field("work", static_cast<int64>(m_lastWork));
+    meas.add_field("maps", static_cast<int32>(m_scheduledMaps.size()));
+#endif
 
     // remove all maps which can be unloaded
     MapMapType::iterator iter = i_maps.begin();
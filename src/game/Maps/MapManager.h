@@ -30,6 +30,7 @@
 
 class Transport;
 class BattleGround;
+class MapUpdateWorker;
 struct TransportTemplate;
 
 struct MapID
@@ -75,6 +76,13 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         void Initialize();
         void Update(uint32);
 
+        // shared job scheduler of map updates and intra-map jobs
+        MapUpdater& GetUpdater() { return m_updater; }
+
+        // wall time of the last parallel map update and the sum of all map update costs in it, in microseconds
+        uint32 GetLastUpdateMakespan() const { return m_lastMakespan; }
+        uint32 GetLastUpdateWork() const { return m_lastWork; }
+
         void SetGridCleanUpDelay(uint32 t)
         {
             if (t < MIN_GRID_DELAY)
@@ -181,6 +189,11 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
 
         std::atomic<uint32> i_MaxInstanceId;
         MapUpdater m_updater;
+        MapUpdater::TaskGroup m_mapUpdateGroup;
+        std::vector<MapUpdateWorker> m_mapWorkers;
+        std::vector<std::pair<Map*, uint32>> m_scheduledMaps;
+        uint32 m_lastMakespan;
+        uint32 m_lastWork;
 };
 
 template<typename Check>
@@ -24,6 +24,7 @@
 #include "Grids/CellImpl.h"
 #include "Maps/Map.h"
 #include "Maps/MapManager.h"
+#include "Maps/SpawnGroup.h"
 #include "Util/Timer.h"
 #include "Grids/GridNotifiersImpl.h"
 #include "Globals/ObjectMgr.h"
@@ -72,6 +73,7 @@ bool MapPersistentState::UnloadIfEmpty()
 
 void MapPersistentState::SaveCreatureRespawnTime(uint32 loguid, time_t t)
 {
+    WakeSpawnGroup(TYPEID_UNIT, loguid, t);
     SetCreatureRespawnTime(loguid, t);
 
     // BGs/Arenas always reset at server restart/unload, so no reason store in DB
@@ -97,6 +99,7 @@ void MapPersistentState::SaveCreatureRespawnTime(uint32 loguid, time_t t)
 
 void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
 {
+    WakeSpawnGroup(TYPEID_GAMEOBJECT, loguid, t);
     SetGORespawnTime(loguid, t);
 
     // BGs/Arenas always reset at server restart/unload, so no reason store in DB
@@ -133,6 +136,18 @@ void MapPersistentState::SaveObjectRespawnTime(uint32 typeId, uint32 loguid, tim
         SaveGORespawnTime(loguid, t);
 }
 
+void MapPersistentState::WakeSpawnGroup(uint32 typeId, uint32 loguid, time_t t)
+{
+    // a spawn group skips its members until the earliest respawn time it saw, .respawn and scripts may move one before it
+    Map* map = GetMap();
+    if (!map)
+        return;
+
+    if (SpawnGroupEntry* entry = map->GetMapDataContainer().GetSpawnGroupByGuid(loguid, typeId))
+        if (SpawnGroup* group = map->GetSpawnManager().GetSpawnGroup(entry->Id))
+            group->LowerDueTime(t);
+}
+
 void MapPersistentState::SetCreatureRespawnTime(uint32 loguid, time_t t)
 {
     if (t > sWorld.GetGameTime())
@@ -119,6 +119,7 @@ class MapPersistentState
         bool HasRespawnTimes() const { return !m_creatureRespawnTimes.empty() || !m_goRespawnTimes.empty(); }
 
     private:
+        void WakeSpawnGroup(uint32 typeId, uint32 loguid, time_t t);
         void SetCreatureRespawnTime(uint32 loguid, time_t t);
         void SetGORespawnTime(uint32 loguid, time_t t);
 
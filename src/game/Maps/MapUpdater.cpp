@@ -17,39 +17,180 @@
  */
 
 #include "MapUpdater.h"
-#include "MapWorkers.h"
 
-MapUpdater::MapUpdater(size_t num_threads) : _cancelationToken(false), pending_requests(0)
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace
 {
-    for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+    // scheduler and deque index owned by the current thread, if it is a worker thread
+    thread_local MapUpdater const* t_updater = nullptr;
+    thread_local size_t t_queueIndex = 0;
+
+    void PinCurrentThread(size_t index)
+    {
+        uint32 cores = std::thread::hardware_concurrency();
+        if (!cores)
+            return;
+
+        uint32 core = index % cores;
+#ifdef __linux__
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(core, &cpuset);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#elif defined(_WIN32)
+        if (core < sizeof(DWORD_PTR) * 8)
+            SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core);
+#endif
+    }
+}
+
+void MapUpdater::TaskQueue::PushBack(Task const& task)
+{
+    if (m_size == m_tasks.size())
+    {
+        std::vector<Task> grown(m_tasks.size() * 2);
+        for (size_t i = 0; i < m_size; ++i)
+            grown[i] = m_tasks[(m_head + i) % m_tasks.size()];
+        m_tasks.swap(grown);
+        m_head = 0;
+    }
+
+    m_tasks[(m_head + m_size) % m_tasks.size()] = task;
+    ++m_size;
+}
+
+bool MapUpdater::TaskQueue::PopBack(Task& task)
+{
+    if (!m_size)
+        return false;
+
+    --m_size;
+    task = m_tasks[(m_head + m_size) % m_tasks.size()];
+    return true;
+}
+
+bool MapUpdater::TaskQueue::PopFront(Task& task)
+{
+    if (!m_size)
+        return false;
+
+    task = m_tasks[m_head];
+    m_head = (m_head + 1) % m_tasks.size();
+    --m_size;
+    return true;
 }
 
-void MapUpdater::activate(size_t num_threads)
+// newest task of the group, the tasks behind it move up one slot
+bool MapUpdater::TaskQueue::PopGroup(TaskGroup const* group, Task& task)
+{
+    for (size_t i = m_size; i > 0; --i)
+    {
+        if (m_tasks[(m_head + i - 1) % m_tasks.size()].group != group)
+            continue;
+
+        task = m_tasks[(m_head + i - 1) % m_tasks.size()];
+        for (size_t j = i; j < m_size; ++j)
+            m_tasks[(m_head + j - 1) % m_tasks.size()] = m_tasks[(m_head + j) % m_tasks.size()];
+        --m_size;
+        return true;
+    }
+    return false;
+}
+
+MapUpdater::MapUpdater(size_t num_threads) : MapUpdater()
+{
+    activate(num_threads);
+}
+
+MapUpdater::~MapUpdater()
 {
     if (activated())
+        deactivate();
+}
+
+void MapUpdater::activate(size_t num_threads, bool pinThreads)
+{
+    if (activated() || !num_threads)
         return;
 
+    _cancelationToken = false;
+
+    for (size_t i = 0; i < num_threads; ++i)
+        _queues.push_back(std::make_unique<TaskQueue>());
+
     for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i, pinThreads));
 }
 
 void MapUpdater::deactivate()
 {
-    _cancelationToken = true;
-
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _cancelationToken = true;
+        _workCondition.notify_all();
+        _doneCondition.notify_all();
+    }
 
     for (auto& thread : _workerThreads)
         thread.join();
+
+    _workerThreads.clear();
+
+    // drop whatever was never started
+    for (auto& queue : _queues)
+    {
+        Task task;
+        while (queue->PopFront(task))
+            if (!task.group)
+                delete task.worker;
+    }
+
+    _queues.clear();
+    _pending = 0;
+    _queued = 0;
 }
 
 void MapUpdater::wait()
 {
-    std::unique_lock<std::mutex> lock(_lock);
+    // blocks without running anything, a caller that should help waits on its TaskGroup instead
+    ++_waiting;
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _doneCondition.wait(lock, [this] { return _pending.load() == 0 || _cancelationToken; });
+    }
+
+    --_waiting;
+}
+
+void MapUpdater::wait(TaskGroup& group)
+{
+    ++_waiting;
+
+    // only worker threads help, the world thread waiting for the map updates blocks like wait() so
+    // map updates never run on more than the configured number of threads
+    bool const helping = t_updater == this;
+    while (!group.done() && !_cancelationToken)
+    {
+        // help with the group only, tasks of other groups or whole map updates are left to the workers
+        Task task;
+        if (helping && popGroup(t_queueIndex, group, task))
+        {
+            run(task);
+            continue;
+        }
 
-    while (pending_requests > 0)
-        _condition.wait(lock);
+        std::unique_lock<std::mutex> lock(_lock);
+        _doneCondition.wait(lock, [&group, helping, this] { return group.done() || (helping && group.m_queued.load() > 0) || _cancelationToken; });
+    }
+
+    --_waiting;
 }
 
 void MapUpdater::join()
@@ -63,38 +204,153 @@ bool MapUpdater::activated()
     return _workerThreads.size() > 0;
 }
 
-void MapUpdater::update_finished()
+void MapUpdater::schedule_update(Worker* worker)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    push({ worker, nullptr });
+}
 
-    --pending_requests;
-    _condition.notify_all();
+void MapUpdater::schedule_update(Worker& worker, TaskGroup& group)
+{
+    group.m_pending.fetch_add(1, std::memory_order_relaxed);
+    push({ &worker, &group });
 }
 
-void MapUpdater::schedule_update(Worker* worker)
+void MapUpdater::push(Task const& task)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    ++_pending;
+
+    // nothing to hand the task to, run it in place
+    if (_queues.empty())
+    {
+        run(task);
+        return;
+    }
+
+    // worker threads keep what they schedule local, others spread round robin
+    size_t index = t_updater == this ? t_queueIndex : _nextQueue++ % _queues.size();
+    {
+        // counted only once the task can be popped, a thread woken by the count always finds it
+        TaskQueue& queue = *_queues[index];
+        std::lock_guard<std::mutex> lock(queue.m_lock);
+        queue.PushBack(task);
+        ++_queued;
+        if (task.group)
+            task.group->m_queued.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    ++pending_requests;
-    _queue.Push(std::move(worker));
+    if (_sleeping.load() > 0 || _waiting.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _workCondition.notify_one();
+        _doneCondition.notify_all();
+    }
 }
 
-void MapUpdater::WorkerThread()
+bool MapUpdater::pop(size_t index, Task& task)
 {
-    while (true)
+    if (_queued.load() == 0)
+        return false;
+
+    // own deque first, newest task is the one with the warmest cache
+    {
+        TaskQueue& queue = *_queues[index];
+        std::lock_guard<std::mutex> lock(queue.m_lock);
+        if (queue.PopBack(task))
+        {
+            --_queued;
+            if (task.group)
+                task.group->m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // steal the oldest task of the others
+    for (size_t i = 1; i < _queues.size(); ++i)
     {
-        Worker* request = nullptr;
+        TaskQueue& queue = *_queues[(index + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.m_lock);
+        if (queue.PopFront(task))
+        {
+            --_queued;
+            if (task.group)
+                task.group->m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
 
-        _queue.WaitAndPop(request);
+    return false;
+}
 
-        if (_cancelationToken)
+bool MapUpdater::popGroup(size_t index, TaskGroup& group, Task& task)
+{
+    if (group.m_queued.load() == 0)
+        return false;
+
+    // own deque first, the group was most likely scheduled from this thread
+    for (size_t i = 0; i < _queues.size(); ++i)
+    {
+        TaskQueue& queue = *_queues[(index + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.m_lock);
+        if (queue.PopGroup(&group, task))
         {
-            delete request;
-            return;
+            --_queued;
+            group.m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
         }
+    }
 
-        request->execute();
+    return false;
+}
+
+void MapUpdater::run(Task const& task)
+{
+    task.worker->execute();
 
-        delete request;
+    if (task.group)
+    {
+        // seq_cst like the _waiting check in notifyDone and the waiter's increment before done(),
+        // otherwise both sides may miss the other's store and the waiter its only wakeup
+        if (task.group->m_pending.fetch_sub(1, std::memory_order_seq_cst) == 1)
+            notifyDone();
     }
-}
\ No newline at end of file
+    else
+        delete task.worker;
+
+    if (--_pending == 0)
+        notifyDone();
+}
+
+void MapUpdater::notifyDone()
+{
+    if (_waiting.load() == 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _doneCondition.notify_all();
+}
+
+void MapUpdater::WorkerThread(size_t index, bool pinThread)
+{
+    t_updater = this;
+    t_queueIndex = index;
+
+    if (pinThread)
+        PinCurrentThread(index);
+
+    while (!_cancelationToken)
+    {
+        Task task;
+        if (pop(index, task))
+        {
+            run(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_lock);
+        ++_sleeping;
+        _workCondition.wait(lock, [this] { return _queued.load() > 0 || _cancelationToken; });
+        --_sleeping;
+    }
+
+    t_updater = nullptr;
+}
@@ -20,42 +20,113 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Platform/Define.h"
-#include "Util/ProducerConsumerQueue.h"
 
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <memory>
 #include <vector>
 #include <condition_variable>
 
-class Worker;
+// task run by MapUpdater, the map jobs deriving from it are in MapWorkers.h
+class Worker
+{
+    public:
+        Worker() = default;
+        virtual ~Worker() = default;
+        virtual void execute() {};
+};
 
+/**
+ * Work stealing scheduler used for map, battleground/instance and intra-map jobs.
+ *
+ * Every thread owns a deque: it pops its own tasks from the back and steals from the
+ * front of the other deques when it runs dry. A worker thread waiting for a task group
+ * executes queued tasks of that group only, so a task may safely wait for tasks it scheduled
+ * itself without a whole other map update running nested inside its wait. Other threads only
+ * block while they wait, all tasks run on the worker threads.
+ */
 class MapUpdater
 {
     public:
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
+        // Completion counter for a set of tasks scheduled with schedule_update(Worker&, TaskGroup&)
+        class TaskGroup
+        {
+            public:
+                TaskGroup() : m_pending(0), m_queued(0) {}
+                TaskGroup(const TaskGroup&) = delete;
+
+                bool done() const { return m_pending.load(std::memory_order_seq_cst) == 0; }
+
+            private:
+                friend class MapUpdater;
+                std::atomic<uint32> m_pending;              // scheduled and not yet finished
+                std::atomic<uint32> m_queued;               // scheduled and not yet started
+        };
+
+        MapUpdater() : _cancelationToken(false), _pending(0), _queued(0), _sleeping(0), _waiting(0), _nextQueue(0) {}
         MapUpdater(size_t num_threads);
         MapUpdater(const MapUpdater&) = delete;
-        
-        void activate(size_t num_threads);
+        ~MapUpdater();
+
+        void activate(size_t num_threads, bool pinThreads = false);
         void deactivate();
         void wait();
+        void wait(TaskGroup& group);
         void join();
         bool activated();
-        void update_finished();
+
+        // queue a heap allocated worker, the updater deletes it after execution
         void schedule_update(Worker* worker);
+        // queue a worker owned by the caller, no allocation happens on this path
+        void schedule_update(Worker& worker, TaskGroup& group);
 
     private:
-        ProducerConsumerQueue<Worker *> _queue;
+        struct Task
+        {
+            Worker* worker;
+            TaskGroup* group;
+        };
+
+        // ring buffer deque, only grows so steady state submission does not allocate
+        class TaskQueue
+        {
+            public:
+                TaskQueue() : m_head(0), m_size(0) { m_tasks.resize(64); }
+
+                void PushBack(Task const& task);
+                bool PopBack(Task& task);
+                bool PopFront(Task& task);
+                bool PopGroup(TaskGroup const* group, Task& task);
 
+                std::mutex m_lock;
+
+            private:
+                std::vector<Task> m_tasks;
+                size_t m_head;
+                size_t m_size;
+        };
+
+        std::vector<std::unique_ptr<TaskQueue>> _queues;
         std::vector<std::thread> _workerThreads;
         std::atomic<bool> _cancelationToken;
 
+        std::atomic<size_t> _pending;                       // scheduled and not yet finished
+        std::atomic<size_t> _queued;                        // scheduled and not yet started
+        std::atomic<uint32> _sleeping;
+        std::atomic<uint32> _waiting;
+        std::atomic<size_t> _nextQueue;
+
         std::mutex _lock;
-        std::condition_variable _condition;
-        size_t pending_requests;
+        std::condition_variable _workCondition;
+        std::condition_variable _doneCondition;
 
-        void WorkerThread();
+        void push(Task const& task);
+        bool pop(size_t index, Task& task);
+        bool popGroup(size_t index, TaskGroup& group, Task& task);
+        void run(Task const& task);
+        void notifyDone();
+        void WorkerThread(size_t index, bool pinThread);
 };
 
-#endif //_MAP_UPDATER_H_INCLUDED
\ No newline at end of file
+#endif //_MAP_UPDATER_H_INCLUDED
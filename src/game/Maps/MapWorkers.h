@@ -23,34 +23,20 @@
 #include "Grids/GridNotifiersImpl.h"
 #include "MapUpdater.h"
 #include "MotionGenerators/MovementGenerator.h"
+#include "MotionGenerators/PathFinder.h"
 #include "Entities/Object.h"
+#include "Entities/UpdateData.h"
+#include "Server/WorldPacket.h"
 #include "Platform/Define.h"
 
-class Worker
-{
-    public:
-        Worker(MapUpdater& updater) : m_updater(updater) {}
-        virtual ~Worker() = default;
-        virtual void execute() {};
-
-    protected:
-        MapUpdater& GetWorker() { return m_updater; }
-
-    private:
-        MapUpdater& m_updater;
-};
-
 class MapUpdateWorker : public Worker
 {
     public:
-        MapUpdateWorker(Map& map, uint32 diff, MapUpdater& updater) :
-            Worker(updater), m_map(map), m_diff(diff)
-        {}
+        MapUpdateWorker(Map& map, uint32 diff) : m_map(map), m_diff(diff) {}
 
         void execute() override
         {
-            m_map.Update(m_diff);
-            GetWorker().update_finished();
+            m_map.RunUpdate(m_diff);
         }
 
     private:
@@ -61,8 +47,8 @@ class MapUpdateWorker : public Worker
 class GridCrawler : public Worker
 {
     public:
-        GridCrawler(Map& map, std::vector<Cell> &cells, uint32 diff, MapUpdater& updater) :
-            Worker(updater), m_map(map), m_cells(cells), m_diff(diff)
+        GridCrawler(Map& map, std::vector<Cell> &cells, uint32 diff) :
+            m_map(map), m_cells(cells), m_diff(diff)
         {}
 
         void execute() override
@@ -77,8 +63,6 @@ class GridCrawler : public Worker
                 m_map.Visit(cell, grid_object_update);
                 m_map.Visit(cell, world_object_update);
             }
-
-            GetWorker().update_finished();
         }
 
     private:
@@ -87,20 +71,62 @@ class GridCrawler : public Worker
         uint32 m_diff;
 };
 
+class UpdatePacketBuilder : public Worker
+{
+    public:
+        typedef std::vector<std::pair<Player*, UpdateData*>> UpdateList;
+
+        UpdatePacketBuilder(UpdateList const& updates, size_t begin, size_t end, std::vector<std::vector<WorldPacket>>& packets) :
+            m_updates(updates), m_begin(begin), m_end(end), m_packets(packets)
+        {}
+
+        void execute() override
+        {
+            for (size_t i = m_begin; i < m_end; ++i)
+            {
+                UpdateData& data = *m_updates[i].second;
+                for (size_t index = 0; index < data.GetPacketCount(); ++index)
+                    m_packets[i].push_back(data.BuildPacket(index));
+            }
+        }
+
+    private:
+        UpdateList const& m_updates;
+        size_t m_begin;
+        size_t m_end;
+        std::vector<std::vector<WorldPacket>>& m_packets;
+};
+
+class PathRequestSolver : public Worker
+{
+    public:
+        PathRequestSolver(std::vector<PathRequestPtr>& requests, size_t begin, size_t end) :
+            m_requests(requests), m_begin(begin), m_end(end)
+        {}
+
+        void execute() override
+        {
+            for (size_t i = m_begin; i < m_end; ++i)
+                m_requests[i]->Solve();
+        }
+
+    private:
+        std::vector<PathRequestPtr>& m_requests;
+        size_t m_begin;
+        size_t m_end;
+};
 
 class ObjectUpdateWorker : public Worker
 {
     public:
-        ObjectUpdateWorker(std::unordered_set<WorldObject*>& objects, uint32 diff, MapUpdater& updater) :
-            Worker(updater), m_objects(objects), m_diff(diff)
+        ObjectUpdateWorker(std::unordered_set<WorldObject*>& objects, uint32 diff) :
+            m_objects(objects), m_diff(diff)
         {}
 
         void execute() override
         {
             for (WorldObject* const &object : m_objects)
                 object->Update(m_diff);
-
-            GetWorker().update_finished();
         }
 
     private:
@@ -62,7 +62,7 @@ namespace
     }
 }
 
-SpawnGroup::SpawnGroup(SpawnGroupEntry const& entry, Map& map, uint32 typeId) : m_entry(entry), m_map(map), m_chosenSquad(-1), m_objectTypeId(typeId), m_enabled(m_entry.EnabledByDefault)
+SpawnGroup::SpawnGroup(SpawnGroupEntry const& entry, Map& map, uint32 typeId) : m_entry(entry), m_map(map), m_chosenSquad(-1), m_objectTypeId(typeId), m_enabled(m_entry.EnabledByDefault), m_nextDueTime(0)
 {
 }
 
@@ -74,6 +74,7 @@ void SpawnGroup::AddObject(uint32 dbGuid, uint32 entry)
 void SpawnGroup::RemoveObject(WorldObject* wo)
 {
     m_objects.erase(wo->GetDbGuid());
+    m_nextDueTime = 0;
 
     if (!m_map.IsDungeon() && m_objects.empty())
     {
@@ -184,6 +185,11 @@ void SpawnGroup::Spawn(bool force)
     if (!m_entry.Squads.empty() && m_chosenSquad != -1 && m_entry.Squads[m_chosenSquad].GuidToEntry.size() == m_objects.size())
         return;
 
+    // squads are rerolled on every attempt so only plain groups can sleep until a member is due
+    time_t now = time(nullptr);
+    if (!force && m_entry.Squads.empty() && now < m_nextDueTime)
+        return;
+
     std::vector<SpawnGroupDbGuids const*> eligibleGuids;
     std::map<uint32, uint32> validEntries;
     std::map<uint32, uint32> minEntries;
@@ -278,13 +284,15 @@ void SpawnGroup::Spawn(bool force)
                 eligibleGuids.push_back(&guid);
     }
 
-    time_t now = time(nullptr);
+    m_nextDueTime = std::numeric_limits<time_t>::max();
     for (auto itr = eligibleGuids.begin(); itr != eligibleGuids.end();)
     {
-        if (m_map.GetPersistentState()->GetObjectRespawnTime(GetObjectTypeId(), (*itr)->DbGuid) > now)
+        time_t respawnTime = m_map.GetPersistentState()->GetObjectRespawnTime(GetObjectTypeId(), (*itr)->DbGuid);
+        if (respawnTime > now)
         {
             if (!force)
             {
+                m_nextDueTime = std::min(m_nextDueTime, respawnTime);
                 if (m_entry.MaxCount == 1) // rare mob case - prevent respawn until all are off CD
                     return;
                 itr = eligibleGuids.erase(itr);
@@ -459,6 +467,7 @@ void SpawnGroup::RespawnIfInVicinity(Position pos, float range)
 
     for (auto& dbGuid : m_entry.DbGuids)
         m_map.GetPersistentState()->SaveObjectRespawnTime(GetObjectTypeId(), dbGuid.DbGuid, now);
+    m_nextDueTime = 0;
 }
 
 bool SpawnGroup::IsRespawnOverriden() const
@@ -641,6 +650,7 @@ void CreatureGroup::Despawn(uint32 timeMSToDespawn, bool onlyAlive, uint32 force
     }
     if (timeMSToDespawn == 0) // only when instant - clears grid unloaded cases
         m_objects.clear();
+    m_nextDueTime = 0;
 }
 
 bool CreatureGroup::IsOutOfCombat()
@@ -685,6 +695,7 @@ void CreatureGroup::ClearRespawnTimes()
     time_t now = time(nullptr);
     for (auto& data : m_entry.DbGuids)
         m_map.GetPersistentState()->SaveObjectRespawnTime(GetObjectTypeId(), data.DbGuid, now);
+    m_nextDueTime = 0;
 }
 
 GameObjectGroup::GameObjectGroup(SpawnGroupEntry const& entry, Map& map) : SpawnGroup(entry, map, uint32(TYPEID_GAMEOBJECT))
@@ -721,6 +732,7 @@ void GameObjectGroup::Despawn(uint32 timeMSToDespawn /*= 0*/, uint32 forcedDespa
     }
     if (timeMSToDespawn == 0) // only when instant - clears grid unloaded cases
         m_objects.clear();
+    m_nextDueTime = 0;
 }
 
 ////////////////////
@@ -50,7 +50,8 @@ class SpawnGroup
         virtual void Despawn(uint32 timeMSToDespawn = 0, uint32 forcedDespawnTime = 0) = 0;
         std::string to_string() const;
         uint32 GetObjectTypeId() const { return m_objectTypeId; }
-        void SetEnabled(bool enabled) { m_enabled = enabled; }
+        void SetEnabled(bool enabled) { m_enabled = enabled; m_nextDueTime = 0; }
+        void LowerDueTime(time_t respawnTime) { m_nextDueTime = std::min(m_nextDueTime, respawnTime); }
         SpawnGroupEntry const& GetGroupEntry() const { return m_entry; }
         uint32 GetGroupId() const { return m_entry.Id; }
 
@@ -73,6 +74,7 @@ class SpawnGroup
         uint32 m_objectTypeId;
         bool m_enabled;
         TimePoint m_cooldown; // used for full wipe scenario only - data is still saved per spawn to db
+        time_t m_nextDueTime; // no missing member leaves its respawn cooldown before this - reset when members change, lowered by MapPersistentState when a respawn time is saved
 };
 
 class CreatureGroup : public SpawnGroup
@@ -21,6 +21,7 @@
 #include "Maps/Map.h"
 #include "Maps/SpawnGroupDefines.h"
 #include "Maps/MapPersistentStateMgr.h"
+#include "Util/TickProfiler.h"
 
 bool operator<(SpawnInfo const& lhs, SpawnInfo const& rhs)
 {
@@ -110,104 +111,116 @@ void SpawnManager::Initialize()
 void SpawnManager::AddCreature(uint32 dbguid)
 {
     time_t respawnTime = m_map.GetPersistentState()->GetCreatureRespawnTime(dbguid);
+    TimePoint when = TimePoint(std::chrono::seconds(respawnTime));
     if (m_updated)
-        m_deferredSpawns.emplace_back(TimePoint(std::chrono::seconds(respawnTime)), dbguid, HIGHGUID_UNIT);
+        m_deferredSpawns.emplace_back(when, dbguid, HIGHGUID_UNIT);
     else
-        m_spawns.emplace_back(TimePoint(std::chrono::seconds(respawnTime)), dbguid, HIGHGUID_UNIT);
+        m_spawns.emplace(when, SpawnInfo(when, dbguid, HIGHGUID_UNIT));
 }
 
 void SpawnManager::AddGameObject(uint32 dbguid)
 {
     time_t respawnTime = m_map.GetPersistentState()->GetGORespawnTime(dbguid);
+    TimePoint when = TimePoint(std::chrono::seconds(respawnTime));
     if (m_updated)
-        m_deferredSpawns.emplace_back(TimePoint(std::chrono::seconds(respawnTime)), dbguid, HIGHGUID_GAMEOBJECT);
+        m_deferredSpawns.emplace_back(when, dbguid, HIGHGUID_GAMEOBJECT);
     else
-        m_spawns.emplace_back(TimePoint(std::chrono::seconds(respawnTime)), dbguid, HIGHGUID_GAMEOBJECT);
+        m_spawns.emplace(when, SpawnInfo(when, dbguid, HIGHGUID_GAMEOBJECT));
 }
 
 void SpawnManager::RespawnCreature(uint32 dbguid, uint32 respawnDelay)
 {
-    bool found = false;
-    auto itr = m_spawns.begin();
-    for (; itr != m_spawns.end(); )
-    {
-        auto& spawnInfo = *itr;
-        if (!spawnInfo.IsUsed() && spawnInfo.GetDbGuid() == dbguid && spawnInfo.GetHighGuid() == HIGHGUID_UNIT)
-        {
-            found = true;
-            m_map.GetPersistentState()->SaveCreatureRespawnTime(dbguid, time(nullptr) + respawnDelay);
-            if (respawnDelay > 0)
-                spawnInfo.SetRespawnTime(m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay));
-            break;
-        }
-        ++itr;
-    }
-    if (!found)
-    {
-        m_map.GetPersistentState()->SaveCreatureRespawnTime(dbguid, time(nullptr) + respawnDelay);
+    m_map.GetPersistentState()->SaveCreatureRespawnTime(dbguid, time(nullptr) + respawnDelay);
+    auto itr = FindSpawn(dbguid, HIGHGUID_UNIT, true);
+    if (itr == m_spawns.end())
         AddCreature(dbguid);
-    }
-    else if (respawnDelay == 0)
-        (*itr).ConstructForMap(m_map);
+    else if (respawnDelay > 0)
+        Reschedule(itr, m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay));
+    else if ((*itr).second.ConstructForMap(m_map))
+        Reschedule(itr, TimePoint()); // erased on next manager update
 }
 
 void SpawnManager::RespawnGameObject(uint32 dbguid, uint32 respawnDelay)
 {
-    bool found = false;
-    auto itr = m_spawns.begin();
-    for (; itr != m_spawns.end(); )
-    {
-        auto& spawnInfo = *itr;
-        if (!spawnInfo.IsUsed() && spawnInfo.GetDbGuid() == dbguid && spawnInfo.GetHighGuid() == HIGHGUID_GAMEOBJECT)
-        {
-            found = true;
-            m_map.GetPersistentState()->SaveGORespawnTime(dbguid, time(nullptr) + respawnDelay);
-            if (respawnDelay > 0)
-                spawnInfo.SetRespawnTime(m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay));
-            break;
-        }
-        ++itr;
-    }
-    if (!found)
-    {
-        m_map.GetPersistentState()->SaveGORespawnTime(dbguid, time(nullptr) + respawnDelay);
+    m_map.GetPersistentState()->SaveGORespawnTime(dbguid, time(nullptr) + respawnDelay);
+    auto itr = FindSpawn(dbguid, HIGHGUID_GAMEOBJECT, true);
+    if (itr == m_spawns.end())
         AddGameObject(dbguid);
-    }
-    else if (respawnDelay == 0)
-        (*itr).ConstructForMap(m_map);
+    else if (respawnDelay > 0)
+        Reschedule(itr, m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay));
+    else if ((*itr).second.ConstructForMap(m_map))
+        Reschedule(itr, TimePoint()); // erased on next manager update
 }
 
 void SpawnManager::RemoveSpawns(std::vector<uint32> const& creatureDbGuids, std::vector<uint32> const& goDbGuids)
 {
-    for (auto& spawnInfo : m_spawns)
+    std::vector<SpawnQueue::iterator> removed;
+    for (auto itr = m_spawns.begin(); itr != m_spawns.end(); ++itr)
     {
+        auto& spawnInfo = (*itr).second;
+        if (spawnInfo.IsUsed())
+            continue;
         switch (spawnInfo.GetHighGuid())
         {
             case HIGHGUID_GAMEOBJECT:
                 if (std::find(goDbGuids.begin(), goDbGuids.end(), spawnInfo.GetDbGuid()) != goDbGuids.end())
-                    spawnInfo.SetUsed(); // will be erased on next manager update
+                    removed.push_back(itr);
                 break;
             case HIGHGUID_UNIT:
                 if (std::find(creatureDbGuids.begin(), creatureDbGuids.end(), spawnInfo.GetDbGuid()) != creatureDbGuids.end())
-                    spawnInfo.SetUsed(); // will be erased on next manager update
+                    removed.push_back(itr);
                 break;
             default: break;
         }
     }
+
+    for (auto itr : removed)
+    {
+        (*itr).second.SetUsed();
+        Reschedule(itr, TimePoint()); // will be erased on next manager update
+    }
 }
 
 void SpawnManager::RemoveSpawn(uint32 dbguid, HighGuid high)
 {
-    for (auto& spawnInfo : m_spawns)
+    for (auto itr = m_spawns.begin(); itr != m_spawns.end(); ++itr)
     {
+        auto& spawnInfo = (*itr).second;
         if (spawnInfo.GetHighGuid() == high && spawnInfo.GetDbGuid() == dbguid)
         {
-            spawnInfo.SetUsed(); // will be erased on next manager update
+            // one being constructed right now is erased by its caller
+            if (!spawnInfo.IsUsed())
+            {
+                spawnInfo.SetUsed();
+                Reschedule(itr, TimePoint()); // will be erased on next manager update
+            }
             break;
         }
     }
 }
 
+SpawnManager::SpawnQueue::iterator SpawnManager::Reschedule(SpawnQueue::iterator itr, TimePoint const& when)
+{
+    // node is moved without reallocation
+    auto node = m_spawns.extract(itr);
+    node.key() = when;
+    node.mapped().SetRespawnTime(when);
+    return m_spawns.insert(std::move(node));
+}
+
+SpawnManager::SpawnQueue::iterator SpawnManager::FindSpawn(uint32 dbguid, HighGuid high, bool unusedOnly)
+{
+    for (auto itr = m_spawns.begin(); itr != m_spawns.end(); ++itr)
+    {
+        auto& spawnInfo = (*itr).second;
+        if (unusedOnly && spawnInfo.IsUsed())
+            continue;
+        if (spawnInfo.GetDbGuid() == dbguid && spawnInfo.GetHighGuid() == high)
+            return itr;
+    }
+    return m_spawns.end();
+}
+
 void SpawnManager::AddEventGuid(uint32 dbguid, HighGuid high)
 {
     switch (high)
@@ -243,7 +256,7 @@ void SpawnManager::RespawnAll()
 {
     for (auto itr = m_spawns.begin(); itr != m_spawns.end(); )
     {
-        auto& spawnInfo = *itr;
+        auto& spawnInfo = (*itr).second;
         if (spawnInfo.GetHighGuid() == HIGHGUID_GAMEOBJECT)
             m_map.GetPersistentState()->SaveGORespawnTime(spawnInfo.GetDbGuid(), 0);
         if (spawnInfo.GetHighGuid() == HIGHGUID_UNIT)
@@ -257,19 +270,21 @@ void SpawnManager::RespawnAll()
 
 void SpawnManager::Update()
 {
+    PROFILE_ZONE("SpawnManager::Update");
+
     m_updated = true;
     if (!m_deferredSpawns.empty()) // cannot insert during update
     {
-        m_spawns.reserve(m_spawns.size() + m_deferredSpawns.size());
-        std::move(std::begin(m_deferredSpawns), std::end(m_deferredSpawns), std::back_inserter(m_spawns));
+        for (auto& spawnInfo : m_deferredSpawns)
+            m_spawns.emplace(spawnInfo.GetRespawnTime(), std::move(spawnInfo));
         m_deferredSpawns.clear();
     }
+    // removed spawns are rescheduled to the front, everything past the first one not due is left alone
     auto now = m_map.GetCurrentClockTime();
-    for (auto itr = m_spawns.begin(); itr != m_spawns.end();)
+    for (auto itr = m_spawns.begin(); itr != m_spawns.end() && (*itr).first <= now;)
     {
-        auto& spawnInfo = *itr;
-        if (spawnInfo.IsUsed() ||
-            (spawnInfo.GetRespawnTime() <= now && spawnInfo.ConstructForMap(m_map)))
+        auto& spawnInfo = (*itr).second;
+        if (spawnInfo.IsUsed() || spawnInfo.ConstructForMap(m_map))
             itr = m_spawns.erase(itr);
         else
             ++itr;
@@ -284,8 +299,9 @@ void SpawnManager::Update()
 std::string SpawnManager::GetRespawnList()
 {
     std::string output = "";
-    for (auto& data : m_spawns)
+    for (auto& spawnData : m_spawns)
     {
+        auto& data = spawnData.second;
         output += "DBGuid: " + std::to_string(data.GetDbGuid()) + "HighGuid: " + (data.GetHighGuid() == HIGHGUID_UNIT ? "Creature" : "GameObject") + "Respawn Time ";
         auto diff = (data.GetRespawnTime() - m_map.GetCurrentClockTime()).count();
         if (auto hours = diff / (HOUR * IN_MILLISECONDS))
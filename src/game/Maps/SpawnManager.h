@@ -23,6 +23,7 @@
 #include "Entities/ObjectGuid.h"
 #include "Maps/SpawnGroup.h"
 
+#include <map>
 #include <string>
 
 class Map;
@@ -51,6 +52,9 @@ bool operator<(SpawnInfo const& lhs, SpawnInfo const& rhs);
 class SpawnManager
 {
     public:
+        // keyed by respawn time so nothing past the first not yet due spawn is visited on update
+        typedef std::multimap<TimePoint, SpawnInfo> SpawnQueue;
+
         SpawnManager(Map& map) : m_map(map), m_updated(false) {}
         ~SpawnManager();
         void Initialize();
@@ -79,10 +83,13 @@ class SpawnManager
 
         void RespawnSpawnGroupsInVicinity(Position pos, float range);
     private:
+        SpawnQueue::iterator Reschedule(SpawnQueue::iterator itr, TimePoint const& when);
+        SpawnQueue::iterator FindSpawn(uint32 dbguid, HighGuid high, bool unusedOnly);
+
         Map& m_map;
 
         std::vector<SpawnInfo> m_deferredSpawns;
-        std::vector<SpawnInfo> m_spawns; // must only be erased from in Update
+        SpawnQueue m_spawns; // must only be erased from in Update
         std::map<uint32, SpawnGroup*> m_spawnGroups;
         bool m_updated;
 
@@ -0,0 +1,137 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/TerrainPrefetcher.h"
+#include "Util/MappedFile.h"
+#include "Util/Timer.h"
+#include "Log/Log.h"
+
+#include <cstdio>
+
+INSTANTIATE_SINGLETON_1(TerrainPrefetcher);
+
+// pending grids beyond this are dropped, the map thread loads them itself then
+static constexpr size_t TERRAIN_PREFETCH_QUEUE_SIZE = 256;
+// the page cache is assumed to still hold a grid read this recently
+static constexpr uint32 TERRAIN_PREFETCH_REPEAT_DELAY = 5 * MINUTE * IN_MILLISECONDS;
+
+std::atomic<uint64> TerrainPrefetcher::s_blockedLoads(0);
+std::atomic<uint64> TerrainPrefetcher::s_blockedLoadTime(0);
+
+void TerrainPrefetcher::Start(std::string const& dataPath)
+{
+    Stop();
+
+    m_dataPath = dataPath;
+    m_running = true;
+    m_thread = std::thread(&TerrainPrefetcher::Run, this);
+}
+
+void TerrainPrefetcher::Stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_running = false;
+        m_queue.clear();
+    }
+    m_condition.notify_one();
+
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void TerrainPrefetcher::Prefetch(uint32 mapId, uint32 gx, uint32 gy)
+{
+    uint32 const key = (mapId << 16) | (gx << 8) | gy;
+    uint32 const now = WorldTimer::getMSTime();
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (!m_running || m_queue.size() >= TERRAIN_PREFETCH_QUEUE_SIZE)
+            return;
+
+        auto itr = m_recent.find(key);
+        if (itr != m_recent.end() && WorldTimer::getMSTimeDiff(itr->second, now) < TERRAIN_PREFETCH_REPEAT_DELAY)
+            return;
+
+        m_recent[key] = now;
+        m_queue.push_back(key);
+    }
+    m_condition.notify_one();
+}
+
+void TerrainPrefetcher::Run()
+{
+    char fileName[64];
+    while (true)
+    {
+        uint32 key;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return !m_running || !m_queue.empty(); });
+            if (!m_running)
+                return;
+
+            key = m_queue.front();
+            m_queue.pop_front();
+
+            if (m_queue.empty() && m_recent.size() > 4 * TERRAIN_PREFETCH_QUEUE_SIZE)
+            {
+                uint32 const now = WorldTimer::getMSTime();
+                for (auto itr = m_recent.begin(); itr != m_recent.end();)
+                {
+                    if (WorldTimer::getMSTimeDiff(itr->second, now) >= TERRAIN_PREFETCH_REPEAT_DELAY)
+                        itr = m_recent.erase(itr);
+                    else
+                        ++itr;
+                }
+            }
+        }
+
+        uint32 const mapId = key >> 16;
+        uint32 const gx = (key >> 8) & 0xFF;
+        uint32 const gy = key & 0xFF;
+
+        // same names as GridMap, StaticMapTree and MMapManager use
+        snprintf(fileName, sizeof(fileName), "maps/%03u%02u%02u.map", mapId, gx, gy);
+        PrefetchFile(m_dataPath + fileName);
+        snprintf(fileName, sizeof(fileName), "vmaps/%03u_%02u_%02u.vmtile", mapId, gy, gx);
+        PrefetchFile(m_dataPath + fileName);
+        snprintf(fileName, sizeof(fileName), "mmaps/%03u%02u%02u.mmtile", mapId, gx, gy);
+        PrefetchFile(m_dataPath + fileName);
+    }
+}
+
+void TerrainPrefetcher::PrefetchFile(std::string const& fileName) const
+{
+    // the readahead started here outlives the mapping
+    MaNGOS::MappedFile file;
+    if (file.Open(fileName.c_str()))
+        file.Prefetch(0, file.GetSize());
+}
+
+void TerrainPrefetcher::AddBlockedLoad(uint64 microseconds)
+{
+    ++s_blockedLoads;
+    s_blockedLoadTime += microseconds;
+}
+
+void TerrainPrefetcher::ConsumeBlockedLoadMetrics(uint64& loads, uint64& microseconds)
+{
+    loads = s_blockedLoads.exchange(0);
+    microseconds = s_blockedLoadTime.exchange(0);
+}
@@ -0,0 +1,73 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TERRAIN_PREFETCHER_H
+#define MANGOS_TERRAIN_PREFETCHER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * Background thread reading the terrain, vmap and navmesh tiles of grids
+ * players are heading for into the page cache, so the map thread later
+ * maps them without waiting on the disk. It only touches files, never
+ * the TerrainInfo state.
+ */
+class TerrainPrefetcher
+{
+    public:
+        TerrainPrefetcher() : m_running(false) {}
+        ~TerrainPrefetcher() { Stop(); }
+
+        void Start(std::string const& dataPath);
+        void Stop();
+
+        /// queues the tiles of terrain grid gx, gy, grids read recently are skipped
+        void Prefetch(uint32 mapId, uint32 gx, uint32 gy);
+
+        /// map thread time spent loading tiles, reported by the metrics
+        static void AddBlockedLoad(uint64 microseconds);
+        static void ConsumeBlockedLoadMetrics(uint64& loads, uint64& microseconds);
+
+    private:
+        void Run();
+        void PrefetchFile(std::string const& fileName) const;
+
+        std::string m_dataPath;
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<uint32> m_queue;
+        std::unordered_map<uint32, uint32> m_recent;        // grid key -> time of the last prefetch
+        bool m_running;
+
+        static std::atomic<uint64> s_blockedLoads;
+        static std::atomic<uint64> s_blockedLoadTime;
+};
+
+#define sTerrainPrefetcher MaNGOS::Singleton<TerrainPrefetcher>::Instance()
+
+#endif
@@ -57,13 +57,8 @@ inline bool isStatic(MovementGenerator* mv)
 void MotionMaster::Initialize()
 {
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("motionmaster.initialize", {
-        { "entry", std::to_string(m_owner->GetEntry()) },
-        { "guid", std::to_string(m_owner->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_owner->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_owner->GetMapId()) },
-        { "instance_id", std::to_string(m_owner->GetInstanceId()) }
-    }, 1000);
+    static metric::series_id const series = metric::register_series("motionmaster.initialize", metric::series_type::histogram);
+    metric::timer<std::chrono::microseconds> meas(series, 1000, metric::outlier_tags(m_owner));
 #endif
     // stop current move
     m_owner->StopMoving();
@@ -115,13 +110,8 @@ void MotionMaster::UpdateMotion(uint32 diff)
     if (m_owner->hasUnitState(UNIT_STAT_CAN_NOT_MOVE))
         return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("motionmaster.updatemotion", {
-        { "entry", std::to_string(m_owner->GetEntry()) },
-        { "guid", std::to_string(m_owner->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_owner->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_owner->GetMapId()) },
-        { "instance_id", std::to_string(m_owner->GetInstanceId()) }
-    }, 1000);
+    static metric::series_id const series = metric::register_series("motionmaster.updatemotion", metric::series_type::histogram);
+    metric::timer<std::chrono::microseconds> meas(series, 1000, metric::outlier_tags(m_owner));
 #endif
 
     MANGOS_ASSERT(!empty());
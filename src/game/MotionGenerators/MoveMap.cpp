@@ -138,8 +138,10 @@ namespace MMAP
 
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMapData: Loaded %03i.mmap", mapId);
 
-        // store inside our map list
-        loadedMMaps.emplace(mapId, std::make_unique<MMapData>(mesh));
+        // store inside our map list, a new generation keeps a reloaded mesh from matching old cached paths
+        auto mmapData = std::make_unique<MMapData>(mesh);
+        mmapData->generation = ++m_generation;
+        loadedMMaps.emplace(mapId, std::move(mmapData));
         return true;
     }
 
@@ -273,6 +275,7 @@ namespace MMAP
         }
 
         mmapData->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+        mmapData->generation = ++m_generation;
         ++loadedTiles;
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
         return true;
@@ -415,6 +418,7 @@ namespace MMAP
         else
         {
             mmapData->mmapLoadedTiles.erase(packedGridPos);
+            mmapData->generation = ++m_generation;
             --loadedTiles;
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded mmtile %03i[%02i,%02i] from %03i", mapId, x, y, mapId);
             return true;
@@ -540,4 +544,41 @@ namespace MMAP
 
         return mmapGOData->navMeshGOQueries[threadId];
     }
+
+    dtNavMeshQuery const* MMapManager::GetThreadNavMeshQuery(uint32 mapId)
+    {
+        auto itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
+            return nullptr;
+
+        auto threadId = std::this_thread::get_id();
+        const auto& mmapData = itr->second;
+        std::lock_guard<std::mutex> guard(m_threadQueriesMutex);
+        auto queryItr = mmapData->navMeshThreadQueries.find(threadId);
+        if (queryItr != mmapData->navMeshThreadQueries.end())
+            return queryItr->second;
+
+        // allocate mesh query
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        MANGOS_ASSERT(query);
+        if (dtStatusFailed(query->init(mmapData->navMesh, 1024)))
+        {
+            dtFreeNavMeshQuery(query);
+            sLog.outError("MMAP:GetThreadNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u", mapId);
+            return nullptr;
+        }
+
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetThreadNavMeshQuery: created dtNavMeshQuery for mapId %03u", mapId);
+        mmapData->navMeshThreadQueries.emplace(threadId, query);
+        return query;
+    }
+
+    uint32 MMapManager::GetNavMeshGeneration(uint32 mapId) const
+    {
+        auto itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
+            return 0;
+
+        return itr->second->generation.load(std::memory_order_relaxed);
+    }
 }
@@ -24,6 +24,7 @@
 #include <Detour/Include/DetourNavMesh.h>
 #include <Detour/Include/DetourNavMeshQuery.h>
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 
@@ -50,12 +51,15 @@ namespace MMAP
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh), fullLoaded(false) {}
+        MMapData(dtNavMesh* mesh) : navMesh(mesh), fullLoaded(false), generation(0) {}
         ~MMapData()
         {
             for (auto& navMeshQuerie : navMeshQueries)
                 dtFreeNavMeshQuery(navMeshQuerie.second);
 
+            for (auto& navMeshQuerie : navMeshThreadQueries)
+                dtFreeNavMeshQuery(navMeshQuerie.second);
+
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
@@ -66,7 +70,13 @@ namespace MMAP
         NavMeshQuerySet navMeshQueries;     // instanceId to query
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
 
+        // queries of the path request workers, those solve requests of several instances at once
+        NavMeshGOQuerySet navMeshThreadQueries;
+
         bool fullLoaded;
+
+        // changes whenever a tile is added or removed, cached poly paths of an older generation are stale
+        std::atomic<uint32> generation;
     };
 
     struct MMapGOData
@@ -93,7 +103,7 @@ namespace MMAP
     class MMapManager
     {
         public:
-            MMapManager() : loadedTiles(0), m_enabled(true) {}
+            MMapManager() : loadedTiles(0), m_generation(0), m_enabled(true) {}
             ~MMapManager();
 
             void loadAllMapTiles(std::string const& basePath, uint32 mapId);
@@ -110,6 +120,9 @@ namespace MMAP
             // the returned [dtNavMeshQuery const*] is NOT threadsafe
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
             dtNavMeshQuery const* GetModelNavMeshQuery(uint32 displayId);
+            // query owned by the calling thread, usable while the instance query is in use elsewhere
+            dtNavMeshQuery const* GetThreadNavMeshQuery(uint32 mapId);
+            uint32 GetNavMeshGeneration(uint32 mapId) const;
             dtNavMesh const* GetNavMesh(uint32 mapId);
             dtNavMesh const* GetGONavMesh(uint32 displayId);
 
@@ -124,9 +137,11 @@ namespace MMAP
 
             std::unordered_map<uint32, std::unique_ptr<MMapData>> loadedMMaps;
             std::atomic<uint32> loadedTiles;
+            std::atomic<uint32> m_generation;
 
             std::unordered_map<uint32, std::unique_ptr<MMapGOData>> m_loadedModels;
             std::mutex m_modelsMutex;
+            std::mutex m_threadQueriesMutex;
 
             bool m_enabled;
     };
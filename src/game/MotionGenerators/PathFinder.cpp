@@ -20,9 +20,11 @@
 #include "Maps/GridMap.h"
 #include "Entities/Creature.h"
 #include "PathFinder.h"
+#include "PolyPathCache.h"
 #include "Log/Log.h"
 #include "World/World.h"
 #include "Entities/Transports.h"
+#include "Util/TickProfiler.h"
 #include <Detour/Include/DetourCommon.h>
 #include <Detour/Include/DetourMath.h>
 
@@ -84,13 +86,18 @@ void PathFinder::SetCurrentNavMesh()
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
         if (GenericTransport* transport = m_sourceUnit->GetTransport())
+        {
+            // model meshes never change and their queries are per thread already
             m_navMeshQuery = mmap->GetModelNavMeshQuery(transport->GetDisplayId());
+            m_navMeshGeneration = 0;
+        }
         else
         {
             if (m_defaultMapId != m_sourceUnit->GetMapId())
                 m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
 
-            m_navMeshQuery = m_defaultNavMeshQuery;
+            m_navMeshQuery = m_useThreadQuery ? mmap->GetThreadNavMeshQuery(m_sourceUnit->GetMapId()) : m_defaultNavMeshQuery;
+            m_navMeshGeneration = mmap->GetNavMeshGeneration(m_sourceUnit->GetMapId());
         }
 
         if (m_navMeshQuery)
@@ -102,6 +109,7 @@ void PathFinder::SetCurrentNavMesh()
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
         m_navMeshQuery = m_defaultNavMeshQuery;
+        m_navMeshGeneration = mmap->GetNavMeshGeneration(m_defaultMapId);
 
         if (m_navMeshQuery)
             m_navMesh = m_navMeshQuery->getAttachedNavMesh();
@@ -132,14 +140,11 @@ bool PathFinder::calculate(Vector3 const& start, Vector3 const& dest, bool force
         return false;
 #endif
 
+    PROFILE_ZONE("PathFinder::calculate");
+
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("pathfinder.calculate", {
-        { "entry", std::to_string(m_sourceUnit->GetEntry()) },
-        { "guid", std::to_string(m_sourceUnit->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_sourceUnit->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_sourceUnit->GetMapId()) },
-        { "instance_id", std::to_string(m_sourceUnit->GetInstanceId()) }
-    }, 1000);
+    static metric::series_id const series = metric::register_series("pathfinder.calculate", metric::series_type::histogram);
+    metric::timer<std::chrono::microseconds> meas(series, 1000, metric::outlier_tags(m_sourceUnit));
 #endif
 
     //if (GenericTransport* transport = m_sourceUnit->GetTransport())
@@ -519,6 +524,17 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         return;
     }
 
+#ifdef ENABLE_PLAYERBOTS
+    uint32 maxPolyLength = m_pointPathLimit / 2;
+#else
+    uint32 maxPolyLength = m_pointPathLimit;
+#endif
+
+    // the corridor is rebuilt from every path searched below, failed searches leave it invalid
+    bool canPatchCorridor = m_useCorridor && m_corridorValid && !m_straightLine;
+    if (!m_straightLine)
+        m_corridorValid = false;
+
     // look for startPoly/endPoly in current path
     // TODO: we can merge it with getPathPolyByPosition() loop
     bool startPolyFound = false;
@@ -571,97 +587,15 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         m_polyLength = pathEndIndex - pathStartIndex + 1;
         memmove(m_pathPolyRefs.data(), m_pathPolyRefs.data() + pathStartIndex, m_polyLength * sizeof(dtPolyRef));
     }
-    //else if (startPolyFound && !endPolyFound)
-    //{
-    //    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (startPolyFound && !endPolyFound)\n");
-
-    //    // we are moving on the old path but target moved out
-    //    // so we have atleast part of poly-path ready
-
-    //    m_polyLength -= pathStartIndex;
-
-    //    // try to adjust the suffix of the path instead of recalculating entire length
-    //    // at given interval the target cannot get too far from its last location
-    //    // thus we have less poly to cover
-    //    // sub-path of optimal path is optimal
-
-    //    // take ~80% of the original length
-    //    // TODO : play with the values here
-    //    uint32 prefixPolyLength = uint32(m_polyLength * 0.8f + 0.5f);
-    //    memmove(m_pathPolyRefs.data(), m_pathPolyRefs.data() + pathStartIndex, prefixPolyLength * sizeof(dtPolyRef));
-
-    //    dtPolyRef suffixStartPoly = m_pathPolyRefs[prefixPolyLength - 1];
-
-    //    // we need any point on our suffix start poly to generate poly-path, so we need last poly in prefix data
-    //    float suffixEndPoint[VERTEX_SIZE];
-    //    if (dtStatusFailed(m_navMeshQuery->closestPointOnPoly(suffixStartPoly, endPoint, suffixEndPoint, nullptr)))
-    //    {
-    //        // we can hit offmesh connection as last poly - closestPointOnPoly() don't like that
-    //        // try to recover by using prev polyref
-    //        --prefixPolyLength;
-    //        suffixStartPoly = m_pathPolyRefs[prefixPolyLength - 1];
-    //        if (dtStatusFailed(m_navMeshQuery->closestPointOnPoly(suffixStartPoly, endPoint, suffixEndPoint, nullptr)))
-    //        {
-    //            // suffixStartPoly is still invalid, error state
-    //            BuildShortcut();
-    //            m_type = PATHFIND_NOPATH;
-    //            return;
-    //        }
-    //    }
-
-    //    // generate suffix
-    //    uint32 suffixPolyLength = 0;
-
-    //    if (!m_straightLine)
-    //    {
-    //        dtResult = m_navMeshQuery->findPath(
-    //                                suffixStartPoly,    // start polygon
-    //                                endPoly,            // end polygon
-    //                                suffixEndPoint,     // start position
-    //                                endPoint,           // end position
-    //                                &m_filter,            // polygon search filter
-    //                                m_pathPolyRefs.data() + prefixPolyLength - 1,    // [out] path
-    //                                (int*)&suffixPolyLength,
-    //                                m_pointPathLimit - prefixPolyLength);   // max number of polygons in output path
-    //    }
-    //    else
-    //    {
-    //        float hit = 0.0f;
-    //        float hitNormal[3] = {0.0f, 0.0f, 0.0f};
-
-    //        dtResult = m_navMeshQuery->raycast(
-    //                        suffixStartPoly,
-    //                        suffixEndPoint,
-    //                        endPoint,
-    //                        &m_filter,
-    //                        &hit,
-    //                        hitNormal,
-    //                        m_pathPolyRefs.data() + prefixPolyLength - 1,
-    //                        (int*)&suffixPolyLength,
-    //                        m_pointPathLimit - prefixPolyLength);
-
-    //        // raycast() sets hit to FLT_MAX if there is a ray between start and end
-    //        if (hit != FLT_MAX)
-    //        {
-    //            // the ray hit something, return no path instead of the incomplete one
-    //            m_type = PATHFIND_NOPATH;
-    //            return;
-    //        }
-    //    }
-
-    //    if (!suffixPolyLength || dtStatusFailed(dtResult))
-    //    {
-    //        // this is probably an error state, but we'll leave it
-    //        // and hopefully recover on the next Update
-    //        // we still need to copy our preffix
-    //        sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
-    //    }
-
-    //    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++  m_polyLength=%u prefixPolyLength=%u suffixPolyLength=%u \n", m_polyLength, prefixPolyLength, suffixPolyLength);
-
-    //    // new path = prefix + suffix - overlap
-    //    m_polyLength = prefixPolyLength + suffixPolyLength - 1;
-    //}
+    else if (canPatchCorridor && PatchCorridor(startPoint, endPoint, startPoly, endPoly, maxPolyLength))
+    {
+        DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: corridor patched\n");
+
+        // the target moved out of our old poly-path, but not far
+        // the corridor followed both ends along the navmesh surface
+        m_polyLength = m_corridor.getPathCount();
+        memcpy(m_pathPolyRefs.data(), m_corridor.getPath(), m_polyLength * sizeof(dtPolyRef));
+    }
     else
     {
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (!startPolyFound && !endPolyFound)\n");
@@ -675,19 +609,26 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
 
         if (!m_straightLine)
         {
-            dtResult = m_navMeshQuery->findPath(
-                    startPoly,          // start polygon
-                    endPoly,            // end polygon
-                    startPoint,         // start position
-                    endPoint,           // end position
-                    &m_filter,          // polygon search filter
-                    m_pathPolyRefs.data(), // [out] path
-                    (int*)&m_polyLength,
-#ifdef ENABLE_PLAYERBOTS
-                    m_pointPathLimit / 2);
-#else
-                    m_pointPathLimit);  // max number of polygons in output path
-#endif
+            // the corridor between two polygons depends on the filter and barely on the positions on them, reuse it while both ends stay on them
+            PolyPathCache& cache = PolyPathCache::Instance(sWorld.getConfig(CONFIG_UINT32_PATH_FIND_CACHE_SIZE));
+            PolyPathCache::Key key = { m_navMesh, startPoly, endPoly, cache.IsEnabled() ? PolyPathCache::HashFilter(m_filter) : 0 };
+            if (cache.IsEnabled() && cache.Find(key, m_navMeshGeneration, m_pathPolyRefs.data(), m_polyLength, maxPolyLength))
+                dtResult = DT_SUCCESS;
+            else
+            {
+                dtResult = m_navMeshQuery->findPath(
+                        startPoly,          // start polygon
+                        endPoly,            // end polygon
+                        startPoint,         // start position
+                        endPoint,           // end position
+                        &m_filter,          // polygon search filter
+                        m_pathPolyRefs.data(), // [out] path
+                        (int*)&m_polyLength,
+                        maxPolyLength);     // max number of polygons in output path
+
+                if (dtStatusSucceed(dtResult) && m_polyLength)
+                    cache.Insert(key, m_navMeshGeneration, m_pathPolyRefs.data(), m_polyLength);
+            }
         }
         else
         {
@@ -788,10 +729,55 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
     else
         m_type = PATHFIND_INCOMPLETE;
 
+    if (m_useCorridor && !m_straightLine)
+        SetCorridor(startPoint, endPoint);
+
     // generate the point-path out of our up-to-date poly-path
     BuildPointPath(startPoint, endPoint);
 }
 
+void PathFinder::setUseCorridor(bool useCorridor)
+{
+    if (useCorridor && !m_useCorridor)
+        m_corridor.init(MAX_POINT_PATH_LENGTH * 3);
+
+    m_useCorridor = useCorridor;
+    m_corridorValid = false;
+}
+
+void PathFinder::SetCorridor(const float* startPoint, const float* endPoint)
+{
+    m_corridor.reset(m_pathPolyRefs[0], startPoint);
+    m_corridor.setCorridor(endPoint, m_pathPolyRefs.data(), m_polyLength);
+    m_corridorNavMesh = m_navMesh;
+    m_corridorGeneration = m_navMeshGeneration;
+    m_corridorValid = true;
+}
+
+bool PathFinder::PatchCorridor(const float* startPoint, const float* endPoint, dtPolyRef startPoly, dtPolyRef endPoly, uint32 maxPolyLength)
+{
+    // tiles loaded or unloaded since the corridor was built may offer a shorter way or have taken its polygons
+    if (m_corridorNavMesh != m_navMesh || m_corridorGeneration != m_navMeshGeneration)
+        return false;
+
+    // dtPathCorridor takes a mutable query but only calls const members of it
+    dtNavMeshQuery* query = const_cast<dtNavMeshQuery*>(m_navMeshQuery);
+    if (!m_corridor.movePosition(startPoint, query, &m_filter) || !m_corridor.moveTargetPosition(endPoint, query, &m_filter))
+        return false;
+
+    // both ends are moved along the surface and stop at walls, an end that went around one needs a new search
+    if (m_corridor.getFirstPoly() != startPoly || m_corridor.getLastPoly() != endPoly ||
+        dtVdist2DSqr(m_corridor.getPos(), startPoint) > CORRIDOR_PATCH_SLOP * CORRIDOR_PATCH_SLOP ||
+        dtVdist2DSqr(m_corridor.getTarget(), endPoint) > CORRIDOR_PATCH_SLOP * CORRIDOR_PATCH_SLOP)
+        return false;
+
+    uint32 pathCount = uint32(m_corridor.getPathCount());
+    if (pathCount > maxPolyLength || pathCount > m_pathPolyRefs.size())
+        return false;
+
+    return m_corridor.isValid(pathCount, query, &m_filter);
+}
+
 void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
 {
     if (m_pointPathLimit * VERTEX_SIZE > m_cachedPoints.size())
@@ -1453,3 +1439,12 @@ float PathFinder::dist3DSqr(const Vector3& p1, const Vector3& p2) const
 {
     return (p1 - p2).squaredLength();
 }
+
+void PathRequest::Solve()
+{
+    m_path.m_useThreadQuery = true;
+    m_path.calculate(m_dest.x, m_dest.y, m_dest.z);
+    m_path.m_useThreadQuery = false;
+    m_solved = true;
+    m_ready.store(true, std::memory_order_release);
+}
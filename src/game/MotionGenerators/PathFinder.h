@@ -23,9 +23,13 @@
 
 #include <Detour/Include/DetourNavMesh.h>
 #include <Detour/Include/DetourNavMeshQuery.h>
+#include <DetourCrowd/Include/DetourPathCorridor.h>
 
 #include "Movement/MoveSplineInitArgs.h"
 
+#include <atomic>
+#include <memory>
+
 using Movement::Vector3;
 using Movement::PointsArray;
 
@@ -46,6 +50,7 @@ class Unit;
 
 #define SMOOTH_PATH_STEP_SIZE   4.0f
 #define SMOOTH_PATH_SLOP        0.3f
+#define CORRIDOR_PATCH_SLOP     0.5f            // how far a patched corridor end may end up from the requested point
 
 // How many points can be cutted
 // May occupt visual bugs when lenght > 20y
@@ -71,6 +76,8 @@ enum PathType
 
 class PathFinder
 {
+        friend class PathRequest;
+
     public:
         PathFinder(Unit const* owner, bool ignoreNormalization = false);
         ~PathFinder();
@@ -86,6 +93,8 @@ class PathFinder
         // option setters - use optional
         void setUseStrightPath(bool useStraightPath) { m_useStraightPath = useStraightPath; };
         void setPathLengthLimit(float distance) { m_pointPathLimit = std::min<uint32>(uint32(distance / SMOOTH_PATH_STEP_SIZE * 1.25f), MAX_POINT_PATH_LENGTH); };
+        // keep a corridor between calculations, small moves of start or end only patch it instead of searching again
+        void setUseCorridor(bool useCorridor);
 
         // result getters
         Vector3 getStartPosition()      const { return m_startPosition; }
@@ -135,8 +144,17 @@ class PathFinder
 
         bool                    m_ignoreNormalization;
 
+        uint32                  m_navMeshGeneration = 0;   // tile generation of m_navMesh, cached poly paths have to match it
+        bool                    m_useThreadQuery = false;  // solved on a path request worker, use the query of that thread
+
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
 
+        dtPathCorridor m_corridor;                  // last searched poly path, see setUseCorridor
+        bool           m_useCorridor = false;
+        bool           m_corridorValid = false;
+        const dtNavMesh* m_corridorNavMesh = nullptr;
+        uint32         m_corridorGeneration = 0;
+
         void setStartPosition(const Vector3& point) { m_startPosition = point; }
         void setEndPosition(const Vector3& point) { m_actualEndPosition = point; m_endPosition = point; }
         void setActualEndPosition(const Vector3& point) { m_actualEndPosition = point; }
@@ -158,6 +176,8 @@ class PathFinder
         bool HaveTile(const Vector3& p) const;
 
         void BuildPolyPath(const Vector3& startPos, const Vector3& endPos);
+        bool PatchCorridor(const float* startPoint, const float* endPoint, dtPolyRef startPoly, dtPolyRef endPoly, uint32 maxPolyLength);
+        void SetCorridor(const float* startPoint, const float* endPoint);
         void BuildPointPath(const float* startPoint, const float* endPoint);
         void BuildShortcut();
 #ifdef ENABLE_PLAYERBOTS
@@ -179,4 +199,31 @@ class PathFinder
                                 float* smoothPath, int* smoothPathSize, uint32 maxSmoothPathSize);
 };
 
+// Path calculation submitted to the owner's map instead of being done right away. The map solves all requests
+// of a tick together on the update workers and the submitter picks the result up on its next update.
+class PathRequest
+{
+    public:
+        PathRequest(PathFinder& path, Vector3 const& dest) : m_path(path), m_dest(dest), m_solved(false), m_ready(false) {}
+        PathRequest(const PathRequest&) = delete;
+
+        // called on the worker, the map thread waits for the whole batch meanwhile
+        void Solve();
+        // the owner left the map before the request was solved, the path is unchanged
+        void Cancel() { m_ready.store(true, std::memory_order_release); }
+
+        bool IsReady() const { return m_ready.load(std::memory_order_acquire); }
+        bool IsSolved() const { return m_solved; }
+        Unit const* GetOwner() const { return m_path.m_sourceUnit; }
+        Vector3 const& GetDestination() const { return m_dest; }
+
+    private:
+        PathFinder& m_path;                         // owned by the submitter, which drops the request before the path
+        Vector3 m_dest;
+        bool m_solved;
+        std::atomic<bool> m_ready;
+};
+
+typedef std::shared_ptr<PathRequest> PathRequestPtr;
+
 #endif
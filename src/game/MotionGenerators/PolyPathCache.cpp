@@ -0,0 +1,121 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MotionGenerators/PolyPathCache.h"
+#include <Detour/Include/DetourNavMeshQuery.h>
+
+#include <cstring>
+
+std::atomic<uint64> PolyPathCache::s_hits(0);
+std::atomic<uint64> PolyPathCache::s_misses(0);
+
+PolyPathCache& PolyPathCache::Instance(uint32 capacity)
+{
+    static thread_local PolyPathCache cache;
+    cache.SetCapacity(capacity);
+    return cache;
+}
+
+uint32 PolyPathCache::HashFilter(dtQueryFilter const& filter)
+{
+    // FNV-1a over everything findPath takes from the filter
+    uint32 hash = 2166136261u;
+    auto mix = [&hash](uint32 value)
+    {
+        hash = (hash ^ value) * 16777619u;
+    };
+
+    mix(filter.getIncludeFlags());
+    mix(filter.getExcludeFlags());
+    for (int area = 0; area < DT_MAX_AREAS; ++area)
+    {
+        float cost = filter.getAreaCost(area);
+        uint32 bits;
+        memcpy(&bits, &cost, sizeof(bits));
+        mix(bits);
+    }
+    return hash;
+}
+
+size_t PolyPathCache::KeyHash::operator()(Key const& key) const
+{
+    size_t hash = std::hash<dtNavMesh const*>()(key.navMesh);
+    hash = hash * 31 + std::hash<dtPolyRef>()(key.startPoly);
+    hash = hash * 31 + std::hash<dtPolyRef>()(key.endPoly);
+    return hash * 31 + key.filter;
+}
+
+void PolyPathCache::SetCapacity(size_t capacity)
+{
+    m_capacity = capacity;
+    while (m_entries.size() > m_capacity)
+    {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+}
+
+bool PolyPathCache::Find(Key const& key, uint32 generation, dtPolyRef* path, uint32& length, uint32 maxLength)
+{
+    auto itr = m_index.find(key);
+    if (itr == m_index.end() || itr->second->generation != generation || itr->second->path.size() > maxLength)
+    {
+        s_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, itr->second);
+    std::vector<dtPolyRef> const& cached = itr->second->path;
+    std::copy(cached.begin(), cached.end(), path);
+    length = uint32(cached.size());
+    s_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void PolyPathCache::Insert(Key const& key, uint32 generation, dtPolyRef const* path, uint32 length)
+{
+    if (!m_capacity)
+        return;
+
+    auto itr = m_index.find(key);
+    if (itr != m_index.end())
+        m_entries.splice(m_entries.begin(), m_entries, itr->second);
+    else if (m_entries.size() >= m_capacity)
+    {
+        // recycle the least recently used entry, its path buffer is reused as well
+        m_index.erase(m_entries.back().key);
+        m_entries.splice(m_entries.begin(), m_entries, std::prev(m_entries.end()));
+        m_entries.front().key = key;
+        itr = m_index.emplace(key, m_entries.begin()).first;
+    }
+    else
+    {
+        m_entries.push_front(Entry{ key, generation, {} });
+        itr = m_index.emplace(key, m_entries.begin()).first;
+    }
+
+    Entry& entry = *itr->second;
+    entry.generation = generation;
+    entry.path.assign(path, path + length);
+}
+
+void PolyPathCache::ConsumeMetrics(uint64& hits, uint64& misses)
+{
+    hits = s_hits.exchange(0, std::memory_order_relaxed);
+    misses = s_misses.exchange(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,93 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_POLY_PATH_CACHE_H
+#define MANGOS_POLY_PATH_CACHE_H
+
+#include "Common.h"
+#include <Detour/Include/DetourNavMesh.h>
+
+#include <atomic>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+class dtQueryFilter;
+
+/**
+ * Least recently used cache of the poly corridors found by dtNavMeshQuery::findPath,
+ * keyed by the polygons at both ends and the query filter. Chasing and following units
+ * ask for the same corridor again and again while they and their target stay on the
+ * same polygons. Every thread owns its cache, so lookups never lock.
+ */
+class PolyPathCache
+{
+    public:
+        struct Key
+        {
+            dtNavMesh const* navMesh;
+            dtPolyRef startPoly;
+            dtPolyRef endPoly;
+            uint32 filter;
+
+            bool operator==(Key const& other) const
+            {
+                return navMesh == other.navMesh && startPoly == other.startPoly && endPoly == other.endPoly && filter == other.filter;
+            }
+        };
+
+        PolyPathCache() : m_capacity(0) {}
+
+        // cache of the calling thread, resized to capacity (PathFinder.CacheSize)
+        static PolyPathCache& Instance(uint32 capacity);
+        static uint32 HashFilter(dtQueryFilter const& filter);
+
+        // generation is the navmesh tile generation the corridor has to be found in
+        bool Find(Key const& key, uint32 generation, dtPolyRef* path, uint32& length, uint32 maxLength);
+        void Insert(Key const& key, uint32 generation, dtPolyRef const* path, uint32 length);
+
+        bool IsEnabled() const { return m_capacity != 0; }
+
+        static void ConsumeMetrics(uint64& hits, uint64& misses);
+
+    private:
+        struct KeyHash
+        {
+            size_t operator()(Key const& key) const;
+        };
+
+        struct Entry
+        {
+            Key key;
+            uint32 generation;
+            std::vector<dtPolyRef> path;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        void SetCapacity(size_t capacity);
+
+        EntryList m_entries;                                    // most recently used first
+        std::unordered_map<Key, EntryList::iterator, KeyHash> m_index;
+        size_t m_capacity;
+
+        static std::atomic<uint64> s_hits;
+        static std::atomic<uint64> s_misses;
+};
+
+#endif
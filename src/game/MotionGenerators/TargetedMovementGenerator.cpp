@@ -496,7 +496,10 @@ bool ChaseMovementGenerator::DispatchSplineToPosition(Unit& owner, float x, floa
     }
 
     if (!this->i_path)
+    {
         this->i_path = new PathFinder(&owner);
+        this->i_path->setUseCorridor(sWorld.getConfig(CONFIG_BOOL_PATH_FIND_PATCH_CORRIDOR));
+    }
 
     bool gen = false;
     if (owner.IsWithinDist3d(x, y, z, 200.f) && std::abs(owner.GetPositionZ() - z) < 5.f && owner.IsWithinLOS(x, y, z + i_target->GetCollisionHeight()) && !owner.IsInWater() && !i_target->IsInWater())
@@ -824,6 +827,7 @@ void FollowMovementGenerator::Initialize(Unit& owner)
 
 void FollowMovementGenerator::Finalize(Unit& owner)
 {
+    m_pathRequest.reset();
     owner.clearUnitState(UNIT_STAT_FOLLOW | UNIT_STAT_FOLLOW_MOVE);
     if (owner.AI() && i_target.isValid())
         owner.AI()->RelinquishFollow(i_target->GetObjectGuid());
@@ -831,6 +835,7 @@ void FollowMovementGenerator::Finalize(Unit& owner)
 
 void FollowMovementGenerator::Interrupt(Unit& owner)
 {
+    m_pathRequest.reset();
     _clearUnitStateMove(owner);
     owner.InterruptMoving();
 }
@@ -861,11 +866,25 @@ bool FollowMovementGenerator::Move(Unit& owner, float x, float y, float z)
         owner.UpdateSplinePosition(true);
 
     if (!i_path)
+    {
         i_path = new PathFinder(&owner);
+        i_path->setUseCorridor(sWorld.getConfig(CONFIG_BOOL_PATH_FIND_PATCH_CORRIDOR));
+    }
 
-    bool unstuck = false;
+    // creatures start moving once their map solved the path, an older request is dropped unsolved
+    if (owner.GetTypeId() == TYPEID_UNIT && sWorld.getConfig(CONFIG_BOOL_PATH_FIND_BATCH_REQUESTS))
+    {
+        m_pathRequest = owner.GetMap()->RequestPath(*i_path, x, y, z);
+        return true;
+    }
 
     i_path->calculate(x, y, z);
+    return MoveAlongPath(owner, x, y, z);
+}
+
+bool FollowMovementGenerator::MoveAlongPath(Unit& owner, float x, float y, float z)
+{
+    bool unstuck = false;
 
     auto& path = i_path->getPath();
 
@@ -1084,6 +1103,19 @@ void FollowMovementGenerator::HandleTargetedMovement(Unit& owner, const uint32&
     static const MovementFlags detected = MovementFlags(MOVEFLAG_MASK_MOVING_FORWARD | MOVEFLAG_BACKWARD | MOVEFLAG_PITCH_UP | MOVEFLAG_PITCH_DOWN);
     static const MovementFlags ignored = MovementFlags(MOVEFLAG_JUMPING | MOVEFLAG_FALLINGFAR);
 
+    // path requested in an earlier update, solved by the map at the start of this one
+    if (m_pathRequest && m_pathRequest->IsReady())
+    {
+        PathRequestPtr request = std::move(m_pathRequest);
+        if (request->IsSolved())
+        {
+            G3D::Vector3 const& dest = request->GetDestination();
+            i_targetReached = !MoveAlongPath(owner, dest.x, dest.y, dest.z);
+        }
+        else
+            i_recheckDistance.Reset(0);
+    }
+
     const bool followerMoving = owner.m_movementInfo.HasMovementFlag(detected);
 
     // Detect target movement and relocation (ignore jumping in place and long falls)
@@ -1150,6 +1182,10 @@ void FollowMovementGenerator::HandleMovementFailure(Unit& owner)
 
 void FollowMovementGenerator::HandleFinalizedMovement(Unit& owner)
 {
+    // the next spline is on its way
+    if (m_pathRequest)
+        return;
+
     i_targetReached = true;
     _reachTarget(owner);
 }
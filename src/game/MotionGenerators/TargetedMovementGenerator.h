@@ -26,7 +26,10 @@
 #include "Entities/ObjectGuid.h"
 #include "Entities/Object.h"
 
+#include <memory>
+
 class PathFinder;
+class PathRequest;
 
 class TargetedMovementGeneratorBase
 {
@@ -224,6 +227,7 @@ class FollowMovementGenerator : public TargetedMovementGeneratorMedium<Unit, Fol
         virtual bool IsUnstuckAllowed(Unit& owner) const;
 
         virtual bool Move(Unit& owner, float x, float y, float z);
+        bool MoveAlongPath(Unit& owner, float x, float y, float z);
 
     protected:
         virtual bool _getOrientation(Unit& owner, float& o) const;
@@ -242,6 +246,8 @@ class FollowMovementGenerator : public TargetedMovementGeneratorMedium<Unit, Fol
 
         bool m_targetMoving;
         bool m_targetFaced;
+
+        std::shared_ptr<PathRequest> m_pathRequest;         // path being solved by the map, see PathFinder.BatchRequests
 };
 
 // to be able to compute new path before the end of the current path (in milliseconds)
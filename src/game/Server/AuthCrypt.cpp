@@ -25,9 +25,8 @@ AuthCrypt::AuthCrypt() : _initialized(false) {}
 void AuthCrypt::DecryptRecv(uint8* data, size_t len)
 {
     if (!_initialized) return;
-    if (len < CRYPTED_RECV_LEN) return;
 
-    for (size_t t = 0; t < CRYPTED_RECV_LEN; t++)
+    for (size_t t = 0; t < len; t++)
     {
         _recv_i %= _key.size();
         uint8 x = (data[t] - _recv_j) ^ _key[_recv_i];
@@ -40,9 +39,8 @@ void AuthCrypt::DecryptRecv(uint8* data, size_t len)
 void AuthCrypt::EncryptSend(uint8* data, size_t len)
 {
     if (!_initialized) return;
-    if (len < CRYPTED_SEND_LEN) return;
 
-    for (size_t t = 0; t < CRYPTED_SEND_LEN; t++)
+    for (size_t t = 0; t < len; t++)
     {
         _send_i %= _key.size();
         uint8 x = (data[t] ^ _key[_send_i]) + _send_j;
@@ -31,13 +31,12 @@ class AuthCrypt
 
         void Init(BigNumber* K);
 
+        // only packet headers are crypted, callers pass the header size of their direction
+        // (server: 6 bytes received / 4 bytes sent, client: the other way around)
         void DecryptRecv(uint8*, size_t);
         void EncryptSend(uint8*, size_t);
 
     private:
-        const static size_t CRYPTED_SEND_LEN = 4;
-        const static size_t CRYPTED_RECV_LEN = 6;
-
         std::vector<uint8> _key;
         uint8 _send_i, _send_j, _recv_i, _recv_j;
         bool _initialized;
@@ -21,6 +21,7 @@
 #include "Log/Log.h"
 #include "Util/ProgressBar.h"
 #include "Util/Util.h"
+#include "Util/Timer.h"
 #include "Globals/Locales.h"
 #include "Globals/SharedDefines.h"
 #include "Server/SQLStorages.h"
@@ -239,6 +240,7 @@ void LoadDBCStores(const std::string& dataPath)
     }
 
     const uint32 DBCFilesCount = 52;
+    uint32 const startTime = WorldTimer::getMSTime();
 
     BarGoLink bar(DBCFilesCount);
 
@@ -589,7 +591,7 @@ void LoadDBCStores(const std::string& dataPath)
         exit(1);
     }
 
-    sLog.outString(">> Initialized %d data stores", DBCFilesCount);
+    sLog.outString(">> Initialized %d data stores in %u ms", DBCFilesCount, WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()));
     sLog.outString();
 }
 
@@ -0,0 +1,213 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/OpcodeStats.h"
+#include "Policies/Singleton.h"
+
+#include <algorithm>
+#include <ctime>
+
+INSTANTIATE_SINGLETON_1(OpcodeStats);
+
+thread_local OpcodeStats::ThreadCounters* OpcodeStats::s_threadCounters = nullptr;
+
+OpcodeStats::OpcodeStats() : m_resetTime(time(nullptr)), m_enabled(false)
+{
+#ifdef BUILD_METRICS
+    for (uint32 i = 0; i < MAX_OPCODE_CONTEXT; ++i)
+    {
+        char const* context = GetContextName(OpcodeStatsContext(i));
+        m_timeSeries[i] = metric::register_series("world.opcodes.handler", metric::series_type::histogram, { {"context", context} });
+        m_bytesSeries[i] = metric::register_series("world.opcodes.bytes", metric::series_type::counter, { {"context", context} });
+    }
+#endif
+}
+
+OpcodeStatsContext OpcodeStats::GetContext(OpcodeHandler const& opHandle)
+{
+    switch (opHandle.packetProcessing)
+    {
+        case PROCESS_IMMEDIATE:     return OPCODE_CONTEXT_NETWORK;
+        case PROCESS_MAP_THREAD:    return OPCODE_CONTEXT_MAP;
+        case PROCESS_THREADSAFE:    return OPCODE_CONTEXT_WORLD_THREADSAFE;
+        default:                    return OPCODE_CONTEXT_WORLD;
+    }
+}
+
+char const* OpcodeStats::GetContextName(OpcodeStatsContext context)
+{
+    switch (context)
+    {
+        case OPCODE_CONTEXT_WORLD:              return "world";
+        case OPCODE_CONTEXT_WORLD_THREADSAFE:   return "world_threadsafe";
+        case OPCODE_CONTEXT_MAP:                return "map";
+        case OPCODE_CONTEXT_NETWORK:            return "network";
+        default:                                return "unknown";
+    }
+}
+
+OpcodeStats::ThreadCounters& OpcodeStats::GetThreadCounters()
+{
+    if (!s_threadCounters)
+    {
+        auto counters = std::make_unique<ThreadCounters>();
+        s_threadCounters = counters.get();
+        std::lock_guard<std::mutex> guard(m_threadsLock);
+        m_threads.push_back(std::move(counters));
+    }
+    return *s_threadCounters;
+}
+
+void OpcodeStats::Record(uint16 opcode, size_t bytes, uint64 microseconds)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    // only this thread adds to its counters, a reset may still clear them concurrently
+    Counters& counters = GetThreadCounters()[opcode];
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    counters.totalTime.fetch_add(microseconds, std::memory_order_relaxed);
+    counters.buckets[TimeBuckets::Index(microseconds)].fetch_add(1, std::memory_order_relaxed);
+    if (microseconds > counters.maxTime.load(std::memory_order_relaxed))
+        counters.maxTime.store(microseconds, std::memory_order_relaxed);
+
+#ifdef BUILD_METRICS
+    OpcodeStatsContext context = GetContext(opcodeTable[opcode]);
+    metric::record(m_timeSeries[context], microseconds);
+    metric::increment(m_bytesSeries[context], bytes);
+#endif
+}
+
+void OpcodeStats::Sum(uint32 opcode, Totals& totals) const
+{
+    totals.count = 0;
+    totals.bytes = 0;
+    totals.totalTime = 0;
+    totals.maxTime = 0;
+    totals.buckets.fill(0);
+    for (auto const& thread : m_threads)
+    {
+        Counters const& counters = (*thread)[opcode];
+        if (!counters.count.load(std::memory_order_relaxed))
+            continue;
+
+        totals.count += counters.count.load(std::memory_order_relaxed);
+        totals.bytes += counters.bytes.load(std::memory_order_relaxed);
+        totals.totalTime += counters.totalTime.load(std::memory_order_relaxed);
+        totals.maxTime = std::max(totals.maxTime, counters.maxTime.load(std::memory_order_relaxed));
+        for (uint32 i = 0; i < TimeBuckets::COUNT; ++i)
+            totals.buckets[i] += counters.buckets[i].load(std::memory_order_relaxed);
+    }
+}
+
+OpcodeStatsEntry OpcodeStats::MakeEntry(uint32 opcode, Totals const& totals)
+{
+    // calls recorded while summing may be in the buckets but not in the count, or the other way around
+    uint64 bucketCount = 0;
+    for (uint64 bucket : totals.buckets)
+        bucketCount += bucket;
+
+    OpcodeStatsEntry entry;
+    entry.opcode = uint16(opcode);
+    entry.context = GetContext(opcodeTable[opcode]);
+    entry.count = totals.count;
+    entry.bytes = totals.bytes;
+    entry.totalTime = totals.totalTime;
+    entry.maxTime = totals.maxTime;
+    entry.p50Time = std::min(TimeBuckets::Percentile(totals.buckets, bucketCount, 50), totals.maxTime);
+    entry.p99Time = std::min(TimeBuckets::Percentile(totals.buckets, bucketCount, 99), totals.maxTime);
+    return entry;
+}
+
+std::vector<OpcodeStatsEntry> OpcodeStats::Collect()
+{
+    std::vector<OpcodeStatsEntry> entries;
+    Totals totals;
+    std::lock_guard<std::mutex> guard(m_threadsLock);
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        Sum(i, totals);
+        if (totals.count)
+            entries.push_back(MakeEntry(i, totals));
+    }
+    return entries;
+}
+
+void OpcodeStats::Reset()
+{
+    std::lock_guard<std::mutex> guard(m_threadsLock);
+    for (auto const& thread : m_threads)
+    {
+        for (Counters& counters : *thread)
+        {
+            counters.count.store(0, std::memory_order_relaxed);
+            counters.bytes.store(0, std::memory_order_relaxed);
+            counters.totalTime.store(0, std::memory_order_relaxed);
+            counters.maxTime.store(0, std::memory_order_relaxed);
+            for (auto& bucket : counters.buckets)
+                bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+#ifdef BUILD_METRICS
+    m_exported.clear();
+#endif
+    m_resetTime = time(nullptr);
+}
+
+#ifdef BUILD_METRICS
+std::vector<OpcodeStatsEntry> OpcodeStats::CollectInterval(uint32 limit)
+{
+    std::vector<OpcodeStatsEntry> entries;
+    Totals totals;
+    Totals interval;
+    std::lock_guard<std::mutex> guard(m_threadsLock);
+
+    // counters only grow between resets, so the interval is the difference to the totals exported last time
+    if (m_exported.empty())
+        m_exported.resize(NUM_MSG_TYPES, Totals{ 0, 0, 0, 0, {} });
+
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        Sum(i, totals);
+        Totals& exported = m_exported[i];
+        if (totals.count == exported.count)
+            continue;
+
+        interval.count = totals.count - exported.count;
+        interval.bytes = totals.bytes - exported.bytes;
+        interval.totalTime = totals.totalTime - exported.totalTime;
+        interval.maxTime = totals.maxTime;
+        for (uint32 j = 0; j < TimeBuckets::COUNT; ++j)
+            interval.buckets[j] = totals.buckets[j] - exported.buckets[j];
+
+        entries.push_back(MakeEntry(i, interval));
+        exported = totals;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](OpcodeStatsEntry const& left, OpcodeStatsEntry const& right)
+    {
+        return left.totalTime > right.totalTime;
+    });
+
+    if (entries.size() > limit)
+        entries.resize(limit);
+
+    return entries;
+}
+#endif
@@ -0,0 +1,135 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_OPCODESTATS_H
+#define MANGOS_OPCODESTATS_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Server/Opcodes.h"
+#include "Util/LogLinearHistogram.h"
+
+#ifdef BUILD_METRICS
+#include "Metric/Series.h"
+#endif
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+enum OpcodeStatsContext
+{
+    OPCODE_CONTEXT_WORLD,                                   // World::UpdateSessions, thread unsafe and in place opcodes
+    OPCODE_CONTEXT_WORLD_THREADSAFE,                        // World::UpdateSessions, opcodes declared PROCESS_THREADSAFE
+    OPCODE_CONTEXT_MAP,                                     // WorldSession::UpdateMap on a map thread
+    OPCODE_CONTEXT_NETWORK,                                 // WorldSession::QueuePacket on a network thread
+    MAX_OPCODE_CONTEXT
+};
+
+struct OpcodeStatsEntry
+{
+    uint16 opcode;
+    OpcodeStatsContext context;
+    uint64 count;
+    uint64 bytes;
+    uint64 totalTime;                                       // all times in microseconds
+    uint64 p50Time;
+    uint64 p99Time;
+    uint64 maxTime;
+};
+
+/*
+ * Call count, received bytes and handler time of every opcode since the last reset, for .debug opcodestats.
+ * Nothing is timed or recorded unless enabled by Profiler.OpcodeStats.
+ * Every recording thread owns its counters and a small histogram of handler time per opcode,
+ * a reader sums them up and may miss calls being recorded meanwhile.
+ * With metrics enabled handler times and bytes are also recorded into one series per context,
+ * and the most expensive opcodes of every metrics interval are exported on their own.
+ */
+class OpcodeStats
+{
+    public:
+        OpcodeStats();
+
+        static OpcodeStatsContext GetContext(OpcodeHandler const& opHandle);
+        static char const* GetContextName(OpcodeStatsContext context);
+
+        void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+        bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+        void Record(uint16 opcode, size_t bytes, uint64 microseconds);
+
+        // entries with at least one call, unsorted
+        std::vector<OpcodeStatsEntry> Collect();
+        void Reset();
+        time_t GetResetTime() const { return m_resetTime.load(); }
+
+#ifdef BUILD_METRICS
+        // up to limit opcodes with the most handler time since the previous call, sorted, max time is since the last reset
+        std::vector<OpcodeStatsEntry> CollectInterval(uint32 limit);
+#endif
+
+    private:
+        // 4 buckets per power of two keep percentiles within 25%, handler times past ~2 minutes share the last bucket
+        typedef MaNGOS::LogLinearBuckets<2, 26> TimeBuckets;
+
+        struct Counters
+        {
+            std::atomic<uint64> count;
+            std::atomic<uint64> bytes;
+            std::atomic<uint64> totalTime;
+            std::atomic<uint64> maxTime;
+            std::array<std::atomic<uint32>, TimeBuckets::COUNT> buckets;
+        };
+
+        struct Totals
+        {
+            uint64 count;
+            uint64 bytes;
+            uint64 totalTime;
+            uint64 maxTime;
+            std::array<uint64, TimeBuckets::COUNT> buckets;
+        };
+
+        typedef std::array<Counters, NUM_MSG_TYPES> ThreadCounters;
+
+        ThreadCounters& GetThreadCounters();
+        // sums the counters of every thread, m_threadsLock must be held
+        void Sum(uint32 opcode, Totals& totals) const;
+        static OpcodeStatsEntry MakeEntry(uint32 opcode, Totals const& totals);
+
+        static thread_local ThreadCounters* s_threadCounters;
+
+        // counters of exited threads are kept, they are part of the totals until the next reset
+        std::mutex m_threadsLock;
+        std::vector<std::unique_ptr<ThreadCounters>> m_threads;
+        std::atomic<time_t> m_resetTime;
+        std::atomic<bool> m_enabled;
+
+#ifdef BUILD_METRICS
+        std::array<metric::series_id, MAX_OPCODE_CONTEXT> m_timeSeries;
+        std::array<metric::series_id, MAX_OPCODE_CONTEXT> m_bytesSeries;
+        std::vector<Totals> m_exported;                     // totals at the previous CollectInterval
+#endif
+};
+
+#define sOpcodeStats MaNGOS::Singleton<OpcodeStats>::Instance()
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/WorldPacketPool.h"
+#include "Policies/Singleton.h"
+
+INSTANTIATE_SINGLETON_1(WorldPacketPool);
+
+static thread_local std::vector<std::unique_ptr<WorldPacket>> t_packetCache;
+
+std::unique_ptr<WorldPacket> WorldPacketPool::Acquire(Opcodes opcode, size_t reservedSize)
+{
+    if (t_packetCache.empty())
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        size_t count = std::min(m_packets.size(), size_t(WORLD_PACKET_POOL_THREAD_CACHE / 2));
+        for (size_t i = 0; i < count; ++i)
+        {
+            t_packetCache.push_back(std::move(m_packets.back()));
+            m_packets.pop_back();
+        }
+    }
+
+    if (t_packetCache.empty())
+        return std::make_unique<WorldPacket>(opcode, reservedSize);
+
+    std::unique_ptr<WorldPacket> packet = std::move(t_packetCache.back());
+    t_packetCache.pop_back();
+    packet->Initialize(opcode, reservedSize);
+    packet->SetReceivedTime(std::chrono::steady_clock::time_point());
+    return packet;
+}
+
+void WorldPacketPool::Release(std::unique_ptr<WorldPacket> packet)
+{
+    if (!packet || packet->capacity() > WORLD_PACKET_POOL_MAX_CAPACITY)
+        return;
+
+    t_packetCache.push_back(std::move(packet));
+    if (t_packetCache.size() < WORLD_PACKET_POOL_THREAD_CACHE)
+        return;
+
+    // hand half of the cache over to the threads that allocate
+    std::lock_guard<std::mutex> guard(m_lock);
+    while (t_packetCache.size() > WORLD_PACKET_POOL_THREAD_CACHE / 2)
+    {
+        if (m_packets.size() < WORLD_PACKET_POOL_MAX_PACKETS)
+            m_packets.push_back(std::move(t_packetCache.back()));
+        t_packetCache.pop_back();
+    }
+}
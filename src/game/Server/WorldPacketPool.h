@@ -0,0 +1,53 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_WORLDPACKETPOOL_H
+#define MANGOS_WORLDPACKETPOOL_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Server/WorldPacket.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define WORLD_PACKET_POOL_THREAD_CACHE  64                  // packets kept by each thread before spilling to the shared pool
+#define WORLD_PACKET_POOL_MAX_PACKETS   8192                // packets kept by the shared pool
+#define WORLD_PACKET_POOL_MAX_CAPACITY  4096                // larger packets are freed instead of kept
+
+/*
+ * Recycles received packets across sessions.
+ * Network threads take packets and world/map threads give them back, so every
+ * thread keeps a small cache and moves packets in batches through a shared
+ * pool, taking its lock once per batch instead of once per packet.
+ */
+class WorldPacketPool
+{
+    public:
+        std::unique_ptr<WorldPacket> Acquire(Opcodes opcode, size_t reservedSize);
+        void Release(std::unique_ptr<WorldPacket> packet);
+
+    private:
+        std::mutex m_lock;
+        std::vector<std::unique_ptr<WorldPacket>> m_packets;
+};
+
+#define sWorldPacketPool MaNGOS::Singleton<WorldPacketPool>::Instance()
+
+#endif
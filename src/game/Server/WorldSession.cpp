@@ -27,6 +27,8 @@
 #include "Log/Log.h"
 #include "Server/Opcodes.h"
 #include "Server/WorldPacket.h"
+#include "Server/WorldPacketPool.h"
+#include "Server/OpcodeStats.h"
 #include "Server/WorldSession.h"
 #include "Entities/Player.h"
 #include "Globals/ObjectMgr.h"
@@ -40,8 +42,10 @@
 #include "GMTickets/GMTicketMgr.h"
 #include "Loot/LootMgr.h"
 #include "Anticheat/Anticheat.hpp"
+#include "Util/TickProfiler.h"
 
 #include <mutex>
+#include <chrono>
 #include <deque>
 #include <memory>
 #include <cstdarg>
@@ -119,7 +123,10 @@ WorldSession::~WorldSession()
     if (m_socket)
     {
         if (!m_socket->IsClosed())
+        {
+            m_socket->Flush();
             m_socket->Close();
+        }
 
         m_socket->FinalizeSession();
     }
@@ -138,7 +145,10 @@ void WorldSession::SetOffline()
     if (m_socket)
     {
         if (!m_socket->IsClosed())
+        {
+            m_socket->Flush();
             m_socket->Close();
+        }
 
         // unexpected socket close, let it be deleted
         m_socket->FinalizeSession();
@@ -195,6 +205,29 @@ void WorldSession::SetPlayer(Player* plr, uint32 playerGuid)
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const& packet, bool forcedSend /*= false*/) const
+{
+    if (!PrepareSendPacket(packet, forcedSend))
+        return;
+
+    m_socket->SendPacket(packet);
+}
+
+/// Send a shared packet to the client, the packet is referenced by the socket instead of being copied
+void WorldSession::SendPacket(std::shared_ptr<WorldPacket const> const& packet, bool forcedSend /*= false*/) const
+{
+    if (!PrepareSendPacket(*packet, forcedSend))
+        return;
+
+    m_socket->SendPacket(packet);
+}
+
+void WorldSession::FlushSocket() const
+{
+    if (m_socket)
+        m_socket->Flush();
+}
+
+bool WorldSession::PrepareSendPacket(WorldPacket const& packet, bool forcedSend) const
 {
 #if defined(BUILD_DEPRECATED_PLAYERBOT) || defined(ENABLE_PLAYERBOTS)
     // Send packet to bot AI
@@ -210,7 +243,7 @@ void WorldSession::SendPacket(WorldPacket const& packet, bool forcedSend /*= fal
     if (!m_socket || (m_sessionState != WORLD_SESSION_STATE_READY && !forcedSend))
     {
         //sLog.outDebug("Refused to send %s to %s", packet.GetOpcodeName(), _player ? _player->GetName() : "UKNOWN");
-        return;
+        return false;
     }
 
 #ifdef MANGOS_DEBUG
@@ -249,7 +282,7 @@ void WorldSession::SendPacket(WorldPacket const& packet, bool forcedSend /*= fal
 
 #endif                                                  // !MANGOS_DEBUG
 
-    m_socket->SendPacket(packet);
+    return true;
 }
 
 /// Add an incoming packet to the queue
@@ -259,6 +292,10 @@ void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
     OpcodeHandler const& opHandle = opcodeTable[new_packet->GetOpcode()];
     if (opHandle.packetProcessing == PROCESS_IMMEDIATE)
     {
+        bool const recordStats = sOpcodeStats.IsEnabled();
+        std::chrono::steady_clock::time_point start;
+        if (recordStats)
+            start = std::chrono::steady_clock::now();
         try
         {
             (this->*opHandle.handler)(*new_packet);
@@ -267,9 +304,14 @@ void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
         {
             ProcessByteBufferException(*new_packet);
         }
+        if (recordStats)
+            sOpcodeStats.Record(new_packet->GetOpcode(), new_packet->size(),
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
 
         if (new_packet->rpos() < new_packet->wpos() && sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
             LogUnprocessedTail(*new_packet);
+
+        sWorldPacketPool.Release(std::move(new_packet));
         return;
     }
 
@@ -295,6 +337,7 @@ void WorldSession::DeleteMovementPackets()
             case MSG_MOVE_SET_FACING:
             case MSG_MOVE_HEARTBEAT:
             {
+                sWorldPacketPool.Release(std::move(*itr));
                 itr = m_recvQueueMap.erase(itr);
                 break;
             }
@@ -370,7 +413,7 @@ bool WorldSession::Update(uint32 diff)
     {
         // sLog.outError("MOEP: %s (0x%.4X)", packet->GetOpcodeName(), packet->GetOpcode());
 
-        auto const packet = std::move(recvQueueCopy.front());
+        std::unique_ptr<WorldPacket> packet = std::move(recvQueueCopy.front());
         recvQueueCopy.pop_front();
 
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
@@ -440,6 +483,8 @@ bool WorldSession::Update(uint32 diff)
                               packet->GetOpcode());
                 break;
         }
+
+        sWorldPacketPool.Release(std::move(packet));
     }
 
 #ifdef BUILD_DEPRECATED_PLAYERBOT
@@ -456,11 +501,12 @@ bool WorldSession::Update(uint32 diff)
             WorldSession* const pBotWorldSession = botPlayer->GetSession();
             while(!pBotWorldSession->m_recvQueue.empty())
             {
-                auto const botpacket = std::move(pBotWorldSession->m_recvQueue.front());
+                auto botpacket = std::move(pBotWorldSession->m_recvQueue.front());
                 pBotWorldSession->m_recvQueue.pop_front();
 
                 OpcodeHandler const& opHandle = opcodeTable[botpacket->GetOpcode()];
                 pBotWorldSession->ExecuteOpcode(opHandle, *botpacket);
+                sWorldPacketPool.Release(std::move(botpacket));
             }
         }
         GetPlayer()->GetPlayerbotMgr()->RemoveBots();
@@ -569,7 +615,7 @@ void WorldSession::UpdateMap(uint32 diff)
 
     while (m_socket && !m_socket->IsClosed() && recvQueueMapCopy.size())
     {
-        auto const packet = std::move(recvQueueMapCopy.front());
+        std::unique_ptr<WorldPacket> packet = std::move(recvQueueMapCopy.front());
         recvQueueMapCopy.pop_front();
 
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
@@ -578,6 +624,8 @@ void WorldSession::UpdateMap(uint32 diff)
         {
             ExecuteOpcode(opHandle, *packet);
         }
+
+        sWorldPacketPool.Release(std::move(packet));
     }
 }
 
@@ -589,10 +637,11 @@ void WorldSession::HandleBotPackets()
         if (_player)
             _player->SetCanDelayTeleport(true);
 
-        auto const packet = std::move(m_recvQueue.front());
+        auto packet = std::move(m_recvQueue.front());
         m_recvQueue.pop_front();
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
         (this->*opHandle.handler)(*packet);
+        sWorldPacketPool.Release(std::move(packet));
 
         if (_player)
         {
@@ -818,6 +867,7 @@ void WorldSession::LogoutPlayer()
     {
         if (m_socket)
         {
+            m_socket->Flush();
             m_socket->Close();
             m_socket = nullptr;
         }
@@ -1194,11 +1244,17 @@ void WorldSession::SendTransferAborted(TransferAbortReason reason) const
 
 void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet)
 {
+    PROFILE_ZONE(opHandle.name);
+
     // need prevent do internal far teleports in handlers because some handlers do lot steps
     // or call code that can do far teleports in some conditions unexpectedly for generic way work code
     if (_player)
         _player->SetCanDelayTeleport(true);
 
+    bool const recordStats = sOpcodeStats.IsEnabled();
+    std::chrono::steady_clock::time_point start;
+    if (recordStats)
+        start = std::chrono::steady_clock::now();
     try
     {
         (this->*opHandle.handler)(packet);
@@ -1207,6 +1263,9 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& pac
     {
         ProcessByteBufferException(packet);
     }
+    if (recordStats)
+        sOpcodeStats.Record(packet.GetOpcode(), packet.size(),
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
 
     if (_player)
     {
@@ -223,6 +223,9 @@ class WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const& packet, bool forcedSend = false) const;
+        void SendPacket(std::shared_ptr<WorldPacket const> const& packet, bool forcedSend = false) const;
+        /// hands the packets queued on the socket to the network thread, see WorldSocket::Flush
+        void FlushSocket() const;
         void SendExpectedSpamRecords();
         void SendMotd(Player* currChar);
         void SendOfflineNameQueryResponses();
@@ -820,6 +823,9 @@ class WorldSession
 
         void ProcessByteBufferException(WorldPacket const& packet);
 
+        // bot hooks, send state checks and statistics shared by both SendPacket overloads
+        bool PrepareSendPacket(WorldPacket const& packet, bool forcedSend) const;
+
         uint32 m_GUIDLow;                                   // set logged or recently logout player (while m_playerRecentlyLogout set)
         Player* _player;
         std::shared_ptr<WorldSocket> m_socket;              // socket pointer is owned by the network thread which created it
@@ -22,6 +22,7 @@
 #include "Util/Util.h"
 #include "World/World.h"
 #include "Server/WorldPacket.h"
+#include "Server/WorldPacketPool.h"
 #include "Globals/SharedDefines.h"
 #include "Util/ByteBuffer.h"
 #include "Addons/AddonHandler.h"
@@ -43,30 +44,6 @@
 #include <utility>
 #include <vector>
 
-#if defined( __GNUC__ )
-#pragma pack(1)
-#else
-#pragma pack(push,1)
-#endif
-struct ServerPktHeader
-{
-    uint16 size;
-    uint16 cmd;
-
-    const char* data() const {
-        return reinterpret_cast<const char*>(this);
-}
-
-    std::size_t headerSize() const {
-        return sizeof(ServerPktHeader);
-    }
-};
-#if defined( __GNUC__ )
-#pragma pack()
-#else
-#pragma pack(pop)
-#endif
-
 std::vector<uint32> InitOpcodeCooldowns()
 {
     std::vector<uint32> data(NUM_MSG_TYPES, 0);
@@ -80,6 +57,25 @@ std::vector<uint32> InitOpcodeCooldowns()
 
 std::vector<uint32> WorldSocket::m_packetCooldowns = InitOpcodeCooldowns();
 
+#ifdef BUILD_METRICS
+std::atomic<uint64> WorldSocket::s_writeCount(0);
+std::atomic<uint64> WorldSocket::s_writeBytes(0);
+std::atomic<uint64> WorldSocket::s_readCount(0);
+std::atomic<uint64> WorldSocket::s_readPackets(0);
+#endif
+
+// bodies up to this size are copied into the coalescing buffer, larger ones are written from the packet itself
+static constexpr size_t WORLD_SOCKET_COPY_LIMIT = 512;
+// receive buffer size, must hold the largest client packet (6 bytes header and 0x2800 - 4 bytes body)
+static constexpr size_t WORLD_SOCKET_READ_BUFFER = 16 * 1024;
+
+void WorldSocket::OutputBuffer::clear()
+{
+    data.clear();
+    references.clear();
+    bytes = 0;
+}
+
 std::deque<uint32> WorldSocket::GetOutOpcodeHistory()
 {
     std::lock_guard<std::mutex> guard(m_worldSocketMutex);
@@ -93,8 +89,10 @@ std::deque<uint32> WorldSocket::GetIncOpcodeHistory()
 }
 
 WorldSocket::WorldSocket(boost::asio::io_context& context) : AsyncSocket(context), m_lastPingTime(std::chrono::system_clock::time_point::min()), m_overSpeedPings(0),
-    m_session(nullptr), m_seed(urand()), m_loggingPackets(false)
+    m_session(nullptr), m_seed(urand()), m_loggingPackets(false), m_writing(false), m_flushPending(false),
+    m_readBuffer(WORLD_SOCKET_READ_BUFFER), m_readStart(0), m_readEnd(0), m_readHeaderDecrypted(false)
 {
+    m_outBuffer.data.reserve(WORLD_SOCKET_COPY_LIMIT * 4);
 }
 
 void WorldSocket::SendPacket(const WorldPacket& pct)
@@ -102,6 +100,23 @@ void WorldSocket::SendPacket(const WorldPacket& pct)
     if (IsClosed())
         return;
 
+    // small bodies are copied into the output buffer, only large ones need a packet of their own
+    if (pct.size() > WORLD_SOCKET_COPY_LIMIT)
+        QueuePacket(pct, std::make_shared<WorldPacket const>(pct));
+    else
+        QueuePacket(pct, nullptr);
+}
+
+void WorldSocket::SendPacket(std::shared_ptr<WorldPacket const> const& packet)
+{
+    if (IsClosed())
+        return;
+
+    QueuePacket(*packet, packet);
+}
+
+void WorldSocket::QueuePacket(WorldPacket const& pct, std::shared_ptr<WorldPacket const> const& packet)
+{
     if (sPacketLog->CanLogPacket() && IsLoggingPackets())
         sPacketLog->LogPacket(pct, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
 
@@ -127,22 +142,107 @@ void WorldSocket::SendPacket(const WorldPacket& pct)
     if (m_opcodeHistoryOut.size() > 50)
         m_opcodeHistoryOut.resize(30);
 
+    uint8 const* headerBytes = reinterpret_cast<uint8 const*>(&header);
+    m_outBuffer.data.insert(m_outBuffer.data.end(), headerBytes, headerBytes + sizeof(header));
     if (pct.size() > 0)
     {
-        // allocate array for full message
-        std::shared_ptr<std::vector<char>> fullMessage = std::make_shared<std::vector<char>>(header.headerSize() + pct.size());
-        std::memcpy(fullMessage->data(), header.data(), header.headerSize()); // copy header
-        std::memcpy((fullMessage->data() + header.headerSize()), reinterpret_cast<const char*>(pct.contents()), pct.size()); // copy packet
-        auto self(shared_from_this());
-        Write(fullMessage->data(), fullMessage->size(), [self, fullMessage](const boost::system::error_code& /*error*/, std::size_t /*written*/) {});
+        if (pct.size() <= WORLD_SOCKET_COPY_LIMIT)
+            m_outBuffer.data.insert(m_outBuffer.data.end(), pct.contents(), pct.contents() + pct.size());
+        else
+            m_outBuffer.references.emplace_back(m_outBuffer.data.size(), packet);
     }
-    else
+    m_outBuffer.bytes += sizeof(header) + pct.size();
+
+    if (!m_writing && MustWrite())
+        StartWrite();
+}
+
+void WorldSocket::Flush()
+{
+    if (IsClosed())
+        return;
+
+    std::lock_guard<std::mutex> guard(m_worldSocketMutex);
+
+    if (m_writing)
+        m_flushPending = true;
+    else if (!m_outBuffer.empty())
+        StartWrite();
+}
+
+bool WorldSocket::MustWrite() const
+{
+    if (m_outBuffer.empty())
+        return false;
+
+    return !sWorld.getConfig(CONFIG_BOOL_NETWORK_TICK_ALIGNED_FLUSH) || m_outBuffer.bytes >= sWorld.getConfig(CONFIG_UINT32_NETWORK_OUT_BUFFER);
+}
+
+void WorldSocket::StartWrite()
+{
+    std::swap(m_writeBuffer, m_outBuffer);
+    m_flushPending = false;
+
+    // the coalesced bytes are split only where a large body is written from its packet
+    m_writeBuffers.clear();
+    size_t offset = 0;
+    for (auto const& [position, packet] : m_writeBuffer.references)
     {
-        std::shared_ptr<ServerPktHeader> sharedHeader = std::make_shared<ServerPktHeader>(header);
-        auto self(shared_from_this());
-        Write(sharedHeader->data(), sharedHeader->headerSize(), [self, sharedHeader](const boost::system::error_code& /*error*/, std::size_t /*written*/) {});
+        if (position > offset)
+            m_writeBuffers.emplace_back(m_writeBuffer.data.data() + offset, position - offset);
+        m_writeBuffers.emplace_back(packet->contents(), packet->size());
+        offset = position;
     }
+    if (m_writeBuffer.data.size() > offset)
+        m_writeBuffers.emplace_back(m_writeBuffer.data.data() + offset, m_writeBuffer.data.size() - offset);
+
+    m_writing = true;
+
+    auto self(shared_from_this());
+    Write(m_writeBuffers, [self](const boost::system::error_code& error, std::size_t /*written*/)
+    {
+        std::lock_guard<std::mutex> guard(self->m_worldSocketMutex);
+
+#ifdef BUILD_METRICS
+        ++s_writeCount;
+        s_writeBytes += self->m_writeBuffer.bytes;
+#endif
+
+        // keeps its capacity for when it is swapped in again
+        self->m_writeBuffer.clear();
+
+        if (error)
+        {
+            // nothing queued can be delivered anymore, later sends see the socket closed
+            self->m_writing = false;
+            self->m_outBuffer.clear();
+            self->Close();
+            return;
+        }
+
+        if (self->IsClosed() || self->m_outBuffer.empty() || (!self->m_flushPending && !self->MustWrite()))
+        {
+            self->m_writing = false;
+            return;
+        }
+
+        self->StartWrite();
+    });
+}
+
+#ifdef BUILD_METRICS
+void WorldSocket::ConsumeWriteMetrics(uint64& writes, uint64& bytes)
+{
+    writes = s_writeCount.exchange(0);
+    bytes = s_writeBytes.exchange(0);
+}
+
+void WorldSocket::ConsumeReadMetrics(uint64& reads, uint64& packets)
+{
+    reads = s_readCount.exchange(0);
+    packets = s_readPackets.exchange(0);
 }
+#endif
 
 bool WorldSocket::OnOpen()
 {
@@ -151,16 +251,24 @@ bool WorldSocket::OnOpen()
     packet << m_seed;
 
     SendPacket(packet);
+    Flush();
 
     return true;
 }
 
 bool WorldSocket::ProcessIncomingData()
 {
-    std::shared_ptr<ClientPktHeader> header = std::make_shared<ClientPktHeader>();
+    // move the unprocessed tail to the front, a whole packet always fits behind it
+    if (m_readStart > 0)
+    {
+        if (m_readEnd > m_readStart)
+            memmove(m_readBuffer.data(), m_readBuffer.data() + m_readStart, m_readEnd - m_readStart);
+        m_readEnd -= m_readStart;
+        m_readStart = 0;
+    }
 
     auto self(shared_from_this());
-    Read((char*)header.get(), sizeof(ClientPktHeader), [self, header](const boost::system::error_code& error, std::size_t /*read*/) -> void
+    ReadSome(reinterpret_cast<char*>(m_readBuffer.data() + m_readEnd), m_readBuffer.size() - m_readEnd, [self](const boost::system::error_code& error, std::size_t read) -> void
     {
         if (error)
         {
@@ -168,122 +276,161 @@ bool WorldSocket::ProcessIncomingData()
             return;
         }
 
-        // thread safe due to always being called from service context
-        self->m_crypt.DecryptRecv((uint8*)header.get(), sizeof(ClientPktHeader));
+#ifdef BUILD_METRICS
+        ++s_readCount;
+#endif
 
-        EndianConvertReverse(header->size);
-        EndianConvert(header->cmd);
+        self->m_readEnd += read;
+        if (self->ProcessReceivedData())
+            self->ProcessIncomingData();
+    });
 
-        if ((header->size < 4) || (header->size > 0x2800) || (header->cmd >= NUM_MSG_TYPES))
+    return true;
+}
+
+bool WorldSocket::ProcessReceivedData()
+{
+    while (m_readEnd - m_readStart >= sizeof(ClientPktHeader))
+    {
+        ClientPktHeader* header = reinterpret_cast<ClientPktHeader*>(m_readBuffer.data() + m_readStart);
+
+        // the header stays in the buffer until its body arrived, decrypt it only once
+        if (!m_readHeaderDecrypted)
         {
-            sLog.outError("WorldSocket::ProcessIncomingData: client sent malformed packet size = %u , cmd = %u", header->size, header->cmd);
-            return;
+            // thread safe due to always being called from service context
+            m_crypt.DecryptRecv(reinterpret_cast<uint8*>(header), sizeof(ClientPktHeader));
+
+            EndianConvertReverse(header->size);
+            EndianConvert(header->cmd);
+            m_readHeaderDecrypted = true;
+
+            if ((header->size < 4) || (header->size > 0x2800) || (header->cmd >= NUM_MSG_TYPES))
+            {
+                sLog.outError("WorldSocket::ProcessIncomingData: client sent malformed packet size = %u , cmd = %u", header->size, header->cmd);
+                Close();
+                return false;
+            }
         }
 
+        size_t const packetSize = header->size - 4;
+        if (m_readEnd - m_readStart < sizeof(ClientPktHeader) + packetSize)
+            break;
+
         const Opcodes opcode = static_cast<Opcodes>(header->cmd);
 
-        size_t packetSize = header->size - 4;
-        std::shared_ptr<std::vector<uint8>> packetBuffer = std::make_shared<std::vector<uint8>>(packetSize);
+        std::unique_ptr<WorldPacket> pct = sWorldPacketPool.Acquire(opcode, packetSize);
+        pct->append(m_readBuffer.data() + m_readStart + sizeof(ClientPktHeader), packetSize);
 
-        self->Read(reinterpret_cast<char*>(packetBuffer->data()), packetBuffer->size(), [self, packetBuffer, opcode = opcode](const boost::system::error_code& error, std::size_t /*read*/) -> void
-        {
-            if (error)
-            {
-                self->Close();
-                return;
-            }
+        m_readStart += sizeof(ClientPktHeader) + packetSize;
+        m_readHeaderDecrypted = false;
 
-            std::unique_ptr<WorldPacket> pct = std::make_unique<WorldPacket>(opcode, packetBuffer->size());
-            pct->append(*packetBuffer.get());
-            if (sPacketLog->CanLogPacket() && self->IsLoggingPackets())
-                sPacketLog->LogPacket(*pct, CLIENT_TO_SERVER, self->GetRemoteIpAddress(), self->GetRemotePort());
+#ifdef BUILD_METRICS
+        ++s_readPackets;
+#endif
 
-            sLog.outWorldPacketDump(self->GetRemoteEndpoint().c_str(), pct->GetOpcode(), pct->GetOpcodeName(), *pct, true);
+        if (!HandleIncomingPacket(std::move(pct)))
+            return false;
+    }
 
-            if (WorldSocket::m_packetCooldowns.size() <= size_t(opcode))
-            {
-                sLog.outError("WorldSocket::ProcessIncomingData: Received opcode beyond range of opcodes: %u", opcode);
-                self->Close();
-                return;
-            }
+    return !IsClosed();
+}
+
+bool WorldSocket::HandleIncomingPacket(std::unique_ptr<WorldPacket> pct)
+{
+    const Opcodes opcode = pct->GetOpcode();
+
+    if (sPacketLog->CanLogPacket() && IsLoggingPackets())
+        sPacketLog->LogPacket(*pct, CLIENT_TO_SERVER, GetRemoteIpAddress(), GetRemotePort());
 
-            if (WorldSocket::m_packetCooldowns[opcode])
+    sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct->GetOpcode(), pct->GetOpcodeName(), *pct, true);
+
+    if (WorldSocket::m_packetCooldowns.size() <= size_t(opcode))
+    {
+        sLog.outError("WorldSocket::ProcessIncomingData: Received opcode beyond range of opcodes: %u", opcode);
+        Close();
+        return false;
+    }
+
+    if (WorldSocket::m_packetCooldowns[opcode])
+    {
+        auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
+        if (now < m_lastPacket[opcode]) // packet on cooldown
+            return true;
+        else // start cooldown and allow execution
+            m_lastPacket[opcode] = now + std::chrono::milliseconds(WorldSocket::m_packetCooldowns[opcode]);
+    }
+
+    try
+    {
+        switch (opcode)
+        {
+            case CMSG_AUTH_SESSION:
             {
-                auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
-                if (now < self->m_lastPacket[opcode]) // packet on cooldown
+                if (m_session)
                 {
-                    self->ProcessIncomingData();
-                    return;
+                    sLog.outError("WorldSocket::ProcessIncomingData: Player send CMSG_AUTH_SESSION again");
+                    Close();
+                    return false;
                 }
-                else // start cooldown and allow execution
-                    self->m_lastPacket[opcode] = now + std::chrono::milliseconds(WorldSocket::m_packetCooldowns[opcode]);
-            }
 
-            try
-            {
-                switch (opcode)
+                bool const authed = HandleAuthSession(*pct);
+                // answers of the socket itself do not wait for the next tick
+                Flush();
+                if (!authed)
                 {
-                    case CMSG_AUTH_SESSION:
-                        if (self->m_session)
-                        {
-                            sLog.outError("WorldSocket::ProcessIncomingData: Player send CMSG_AUTH_SESSION again");
-                            self->Close();
-                            return;
-                        }
-
-                        if (!self->HandleAuthSession(*pct))
-                        {
-                            self->Close();
-                            return;
-                        }
-                        break;
-                    case CMSG_PING:
-                        if (!self->HandlePing(*pct))
-                        {
-                            self->Close();
-                            return;
-                        }
-                        break;
-                    default:
-                    {
-                        self->m_opcodeHistoryInc.push_front(uint32(pct->GetOpcode()));
-                        if (self->m_opcodeHistoryInc.size() > 50)
-                            self->m_opcodeHistoryInc.resize(30);
-
-                        if (!self->m_session)
-                        {
-                            sLog.outError("WorldSocket::ProcessIncomingData: Client not authed opcode = %u", uint32(opcode));
-                            self->Close();
-                            return;
-                        }
-
-                        self->m_session->QueuePacket(std::move(pct));
-                        break;
-                    }
+                    Close();
+                    return false;
                 }
+                break;
             }
-            catch (ByteBufferException&)
+            case CMSG_PING:
             {
-                sLog.outError("WorldSocket::ProcessIncomingData ByteBufferException occured while parsing an instant handled packet (opcode: %u) from client %s, accountid=%i.",
-                    opcode, self->GetRemoteAddress().c_str(), self->m_session ? self->m_session->GetAccountId() : -1);
-
-                if (sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
+                bool const valid = HandlePing(*pct);
+                Flush();
+                if (!valid)
                 {
-                    DEBUG_LOG("Dumping error-causing packet:");
-                    pct->hexlike();
+                    Close();
+                    return false;
                 }
+                break;
+            }
+            default:
+            {
+                m_opcodeHistoryInc.push_front(uint32(pct->GetOpcode()));
+                if (m_opcodeHistoryInc.size() > 50)
+                    m_opcodeHistoryInc.resize(30);
 
-                if (sWorld.getConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET))
+                if (!m_session)
                 {
-                    DETAIL_LOG("Disconnecting session [account id %i / address %s] for badly formatted packet.",
-                        self->m_session ? self->m_session->GetAccountId() : -1, self->GetRemoteAddress().c_str());
-                    self->Close();
-                    return;
+                    sLog.outError("WorldSocket::ProcessIncomingData: Client not authed opcode = %u", uint32(opcode));
+                    Close();
+                    return false;
                 }
+
+                m_session->QueuePacket(std::move(pct));
+                break;
             }
-            self->ProcessIncomingData();
-        });
-    });
+        }
+    }
+    catch (ByteBufferException&)
+    {
+        sLog.outError("WorldSocket::ProcessIncomingData ByteBufferException occured while parsing an instant handled packet (opcode: %u) from client %s, accountid=%i.",
+            opcode, GetRemoteAddress().c_str(), m_session ? m_session->GetAccountId() : -1);
+
+        if (sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
+        {
+            DEBUG_LOG("Dumping error-causing packet:");
+            pct->hexlike();
+        }
+
+        if (sWorld.getConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET))
+        {
+            DETAIL_LOG("Disconnecting session [account id %i / address %s] for badly formatted packet.",
+                m_session ? m_session->GetAccountId() : -1, GetRemoteAddress().c_str());
+            Close();
+            return false;
+        }
+    }
 
     return true;
 }
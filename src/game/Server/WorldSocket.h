@@ -30,9 +30,12 @@
 #include "Auth/BigNumber.h"
 #include "Network/AsyncSocket.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <deque>
+#include <memory>
+#include <vector>
 
 class WorldPacket;
 class WorldSession;
@@ -45,26 +48,24 @@ class WorldSession;
  * Most methods return -1 on failure.
  * The class uses reference counting.
  *
- * For output the class uses one buffer (64K usually) and
- * a queue where it stores packet if there is no place on
- * the queue. The reason this is done, is because the server
- * does really a lot of small-size writes to it, and it doesn't
- * scale well to allocate memory for every. When something is
- * written to the output buffer the socket is not immediately
- * activated for output (again for the same reason), there
- * is 10ms celling (thats why there is Update() override method).
- * This concept is similar to TCP_CORK, but TCP_CORK
- * uses 200ms celling. As result overhead generated by
- * sending packets from "producer" threads is minimal,
- * and doing a lot of writes with small size is tolerated.
+ * For output the class uses a pair of coalescing buffers, one
+ * being filled while the other is written. Encrypted headers and
+ * small packet bodies are copied into the filling buffer, large
+ * bodies are kept by reference since packets are immutable and
+ * reference counted, so a broadcast packet is shared by all
+ * receiving sockets instead of being copied into each of them.
+ * The buffer is handed to the network thread as one gathered
+ * write at the end of each map and world tick (Flush), or as soon
+ * as Network.OutUBuff bytes are pending. Only one write is
+ * outstanding at a time, everything queued meanwhile goes out
+ * with the next one.
  *
- * The calls to Update () method are managed by WorldSocketMgr
- * and ReactorRunnable.
- *
- * For input ,the class uses one 1024 bytes buffer on stack
- * to which it does recv() calls. And then received data is
- * distributed where its needed. 1024 matches pretty well the
- * traffic generated by client for now.
+ * For input the class keeps one receive buffer per connection,
+ * filled by async_read_some with whatever the kernel has. All
+ * complete packets in it are framed in place, their headers
+ * decrypted there, and copied once into pooled WorldPackets.
+ * A partial packet is moved to the front of the buffer before
+ * the next read, which is large enough for any client packet.
  *
  * The input/output do speculative reads/writes (AKA it tries
  * to read all data available in the kernel buffer or tries to
@@ -87,6 +88,12 @@ class WorldSocket : public MaNGOS::AsyncSocket<WorldSocket>
             uint16 size;
             uint32 cmd;
         };
+
+        struct ServerPktHeader
+        {
+            uint16 size;
+            uint16 cmd;
+        };
 #if defined( __GNUC__ )
 #pragma pack()
 #else
@@ -109,9 +116,15 @@ class WorldSocket : public MaNGOS::AsyncSocket<WorldSocket>
 
         BigNumber m_s;
 
-        /// process one incoming packet.
+        /// reads more data into the receive buffer and processes it
         virtual bool ProcessIncomingData() override;
 
+        /// frames and routes every complete packet in the receive buffer, false once the socket got closed
+        bool ProcessReceivedData();
+
+        /// routes one received packet, false once the socket got closed
+        bool HandleIncomingPacket(std::unique_ptr<WorldPacket> pct);
+
         /// Called by ProcessIncoming() on CMSG_AUTH_SESSION.
         bool HandleAuthSession(WorldPacket& recvPacket);
 
@@ -125,11 +138,63 @@ class WorldSocket : public MaNGOS::AsyncSocket<WorldSocket>
 
         bool m_loggingPackets;
 
+        struct OutputBuffer
+        {
+            OutputBuffer() : bytes(0) {}
+
+            bool empty() const { return bytes == 0; }
+            void clear();
+
+            std::vector<uint8> data;                        // encrypted headers and copied small bodies
+            /// large bodies, written after the first `offset` bytes of data
+            std::vector<std::pair<size_t, std::shared_ptr<WorldPacket const>>> references;
+            size_t bytes;                                   // data plus referenced bodies
+        };
+
+        /// Buffer filled by SendPacket, guarded by m_worldSocketMutex
+        OutputBuffer m_outBuffer;
+        /// Buffer of the write in progress, owned by it until its completion
+        OutputBuffer m_writeBuffer;
+        std::vector<boost::asio::const_buffer> m_writeBuffers;
+        bool m_writing;
+        bool m_flushPending;                                // Flush called while a write was outstanding
+
+        /// appends header and body to m_outBuffer, packet is only used for bodies above WORLD_SOCKET_COPY_LIMIT
+        void QueuePacket(WorldPacket const& pct, std::shared_ptr<WorldPacket const> const& packet);
+        /// starts a gathered write of everything queued, m_worldSocketMutex must be held
+        void StartWrite();
+        /// true when the filled buffer has to go out without waiting for the next Flush
+        bool MustWrite() const;
+
+        /// Receive buffer, only touched from the read completion of this socket
+        std::vector<uint8> m_readBuffer;
+        size_t m_readStart;                                 // first byte not yet framed
+        size_t m_readEnd;                                   // end of received data
+        bool m_readHeaderDecrypted;                         // header at m_readStart waits for its body
+
+#ifdef BUILD_METRICS
+        static std::atomic<uint64> s_writeCount;
+        static std::atomic<uint64> s_writeBytes;
+        static std::atomic<uint64> s_readCount;
+        static std::atomic<uint64> s_readPackets;
+#endif
+
     public:
         WorldSocket(boost::asio::io_context& context);
 
         // send a packet \o/
         void SendPacket(const WorldPacket& pct);
+        // send a shared immutable packet without copying it
+        void SendPacket(std::shared_ptr<WorldPacket const> const& pct);
+        /// hands everything queued to the network thread, called at the end of map and world ticks
+        void Flush();
+
+#ifdef BUILD_METRICS
+        /// returns and resets the number of writes and written bytes of all sockets
+        static void ConsumeWriteMetrics(uint64& writes, uint64& bytes);
+        /// returns and resets the number of reads and received packets of all sockets
+        static void ConsumeReadMetrics(uint64& reads, uint64& packets);
+#endif
 
         void FinalizeSession() { m_session = nullptr; }
 
@@ -91,7 +91,8 @@ enum MangosStrings
     //                                    65, not used
     LANG_USING_SCRIPT_LIB_NONE          = 66,
     LANG_GM_ANNOUNCE_COLOR              = 67,
-    // Room for more level 0              67-99 not used
+    LANG_UPDATE_DIFF                    = 68,
+    // Room for more level 0              69-99 not used
 
     // level 1 chat
     LANG_GLOBAL_NOTIFY                  = 100,
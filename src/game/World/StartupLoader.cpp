@@ -0,0 +1,168 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/StartupLoader.h"
+#include "Database/DatabaseEnv.h"
+#include "Log/Log.h"
+#include "Util/Timer.h"
+#include "Util/ProgressBar.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
+
+void StartupLoader::Add(char const* name, LoadFunction function, std::initializer_list<char const*> dependencies)
+{
+    Node node;
+    node.name = name;
+    node.function = std::move(function);
+
+    for (char const* dependency : dependencies)
+    {
+        size_t index = 0;
+        while (index < m_nodes.size() && strcmp(m_nodes[index].name, dependency) != 0)
+            ++index;
+
+        MANGOS_ASSERT(index < m_nodes.size());              // dependencies have to be added first
+        node.dependencies.push_back(index);
+        m_nodes[index].dependents.push_back(m_nodes.size());
+    }
+
+    m_nodes.push_back(std::move(node));
+}
+
+void StartupLoader::Run(uint32 threads)
+{
+    if (threads <= 1)
+    {
+        for (Node& node : m_nodes)
+        {
+            uint32 start = WorldTimer::getMSTime();
+            node.function();
+            node.duration = WorldTimer::getMSTimeDiff(start, WorldTimer::getMSTime());
+        }
+    }
+    else
+        RunParallel(threads);
+
+    Report();
+}
+
+void StartupLoader::RunParallel(uint32 threads)
+{
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::set<size_t> ready;                                 // lowest index first, keeps the serial order where possible
+    std::vector<size_t> pending(m_nodes.size());
+    size_t remaining = m_nodes.size();
+
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        pending[i] = m_nodes[i].dependencies.size();
+        if (!pending[i])
+            ready.insert(i);
+    }
+
+    // interleaved progress bars of parallel loaders are unreadable
+    bool const showProgress = BarGoLink::GetOutputState();
+    BarGoLink::SetOutputState(false);
+
+    auto worker = [&]()
+    {
+        WorldDatabase.ThreadStart();                        // let thread do safe mySQL requests (one connection call enough)
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            wakeUp.wait(lock, [&]() { return !ready.empty() || !remaining; });
+            if (!remaining)
+                break;
+
+            size_t index = *ready.begin();
+            ready.erase(ready.begin());
+            Node& node = m_nodes[index];
+
+            lock.unlock();
+            uint32 start = WorldTimer::getMSTime();
+            node.function();
+            uint32 duration = WorldTimer::getMSTimeDiff(start, WorldTimer::getMSTime());
+            lock.lock();
+
+            node.duration = duration;
+            --remaining;
+            for (size_t dependent : node.dependents)
+                if (!--pending[dependent])
+                    ready.insert(dependent);
+
+            wakeUp.notify_all();
+        }
+        lock.unlock();
+
+        WorldDatabase.ThreadEnd();
+    };
+
+    std::vector<std::thread> workers;
+    for (uint32 i = 0; i < threads; ++i)
+        workers.emplace_back(worker);
+
+    for (std::thread& thread : workers)
+        thread.join();
+
+    BarGoLink::SetOutputState(showProgress);
+}
+
+void StartupLoader::Report() const
+{
+    // nodes are in a valid serial order, so each dependency already has its path length
+    std::vector<size_t> previous(m_nodes.size(), m_nodes.size());
+    std::vector<uint32> pathDuration(m_nodes.size(), 0);
+    uint32 total = 0;
+    size_t last = 0;
+
+    sLog.outString("Startup loader times:");
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        Node const& node = m_nodes[i];
+        for (size_t dependency : node.dependencies)
+        {
+            if (pathDuration[dependency] >= pathDuration[i])
+            {
+                pathDuration[i] = pathDuration[dependency];
+                previous[i] = dependency;
+            }
+        }
+        pathDuration[i] += node.duration;
+
+        if (pathDuration[i] >= pathDuration[last])
+            last = i;
+        total += node.duration;
+
+        sLog.outString("  %-32s %6u ms", node.name, node.duration);
+    }
+
+    if (m_nodes.empty())
+        return;
+
+    std::string path;
+    for (size_t i = last; i < m_nodes.size(); i = previous[i])
+        path = std::string(m_nodes[i].name) + (path.empty() ? "" : " -> ") + path;
+
+    sLog.outString("Startup loaders took %u ms in total, critical path %u ms: %s", total, pathDuration[last], path.c_str());
+}
@@ -0,0 +1,62 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_STARTUP_LOADER_H
+#define MANGOS_STARTUP_LOADER_H
+
+#include "Platform/Define.h"
+
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+/**
+ * Dependency graph of startup loaders.
+ *
+ * Each loader names the loaders it has to run after, which must have
+ * been added before it, so the declaration order is always a valid
+ * serial order. Run executes loaders whose dependencies finished on
+ * up to the given number of threads and logs the time of every loader
+ * and the critical path through the graph.
+ */
+class StartupLoader
+{
+    public:
+        typedef std::function<void()> LoadFunction;
+
+        void Add(char const* name, LoadFunction function, std::initializer_list<char const*> dependencies = {});
+
+        void Run(uint32 threads);
+
+    private:
+        struct Node
+        {
+            char const* name;
+            LoadFunction function;
+            std::vector<size_t> dependencies;
+            std::vector<size_t> dependents;
+            uint32 duration = 0;                            // ms spent in function
+        };
+
+        void RunParallel(uint32 threads);
+        void Report() const;
+
+        std::vector<Node> m_nodes;
+};
+
+#endif
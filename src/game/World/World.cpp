@@ -21,6 +21,7 @@
 */
 
 #include "World/World.h"
+#include "World/StartupLoader.h"
 #include "Database/DatabaseEnv.h"
 #include "Config/Config.h"
 #include "Platform/Define.h"
@@ -29,6 +30,7 @@
 #include "Server/Opcodes.h"
 #include "Server/WorldSession.h"
 #include "Server/WorldPacket.h"
+#include "Server/OpcodeStats.h"
 #include "Entities/Player.h"
 #include "Accounts/AccountMgr.h"
 #include "AuctionHouse/AuctionHouseMgr.h"
@@ -47,6 +49,7 @@
 #include "DBScripts/ScriptMgr.h"
 #include "AI/CreatureAIRegistry.h"
 #include "Policies/Singleton.h"
+#include "Util/TickProfiler.h"
 #include "BattleGround/BattleGroundMgr.h"
 #include "OutdoorPvP/OutdoorPvP.h"
 #include "VMapFactory.h"
@@ -54,6 +57,7 @@
 #include "GameEvents/GameEventMgr.h"
 #include "Pools/PoolManager.h"
 #include "Database/DatabaseImpl.h"
+#include "Database/SQLStorageCache.h"
 #include "Grids/GridNotifiersImpl.h"
 #include "Grids/CellImpl.h"
 #include "Maps/MapPersistentStateMgr.h"
@@ -69,6 +73,8 @@
 #include "Anticheat/Anticheat.hpp"
 #include "LFG/LFGMgr.h"
 #include "Spells/SpellStacking.h"
+#include "Maps/TerrainPrefetcher.h"
+#include "MotionGenerators/PolyPathCache.h"
 
 #ifdef BUILD_AHBOT
  #include "AuctionHouseBot/AuctionHouseBot.h"
@@ -76,6 +82,7 @@
 
 #ifdef BUILD_METRICS
  #include "Metric/Metric.h"
+ #include "Server/WorldSocket.h"
 #endif
 
 #ifdef ENABLE_PLAYERBOTS
@@ -103,17 +110,16 @@ float World::m_MaxVisibleDistanceInBG         = DEFAULT_VISIBILITY_BG;
 
 float  World::m_relocation_lower_limit_sq = 10.f * 10.f;
 uint32 World::m_relocation_ai_notify_delay = 1000u;
+bool   World::m_incremental_visibility = false;
 
 uint32 World::m_currentMSTime = 0;
 TimePoint World::m_currentTime = TimePoint();
 uint32 World::m_currentDiff = 0;
-#ifdef ENABLE_PLAYERBOTS
 uint32 World::m_currentDiffSum = 0;
 uint32 World::m_currentDiffSumIndex = 0;
 uint32 World::m_averageDiff = 0;
 uint32 World::m_maxDiff = 0;
 std::list<uint32> World::m_histDiff;
-#endif
 
 /// World constructor
 World::World(): mail_timer(0), mail_timer_expires(0), m_NextWeeklyQuestReset(0), m_opcodeCounters(NUM_MSG_TYPES)
@@ -159,6 +165,8 @@ World::~World()
     for (auto const session : m_sessionAddQueue)
         delete session;
 
+    sTerrainPrefetcher.Stop();
+
     VMAP::VMapFactory::clear();
     MMAP::MMapFactory::clear();
 
@@ -480,6 +488,8 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
+    setConfig(CONFIG_BOOL_GRID_LOADING_STAGED, "GridLoading.Staged", false);
+    setConfigMin(CONFIG_UINT32_GRID_LOADING_TICK_BUDGET, "GridLoading.TickBudget", 5, 1);
     setConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS, "MaxWhoListReturns", 49);
 
     std::string forceLoadGridOnMaps = sConfig.GetStringDefault("LoadAllGridsOnMaps");
@@ -623,6 +633,9 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_UINT32_NUM_MAP_THREADS, "MapUpdate.Threads", 3);
+    setConfig(CONFIG_BOOL_MAP_UPDATE_PIN_THREADS, "MapUpdate.PinThreads", false);
+    setConfigMin(CONFIG_UINT32_STARTUP_LOADER_THREADS, "StartupLoader.Threads", 1, 1);
+    setConfigMin(CONFIG_UINT32_IDLE_INSTANCE_UPDATE_RATE, "MapUpdate.IdleInstanceRate", 1, 1);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_ORANGE, "SkillChance.Orange", 100);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_YELLOW, "SkillChance.Yellow", 75);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_GREEN,  "SkillChance.Green",  25);
@@ -715,6 +728,13 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_OUTDOORPVP_EP_ENABLED,                       "OutdoorPvp.EPEnabled", true);
 
     setConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET, "Network.KickOnBadPacket", false);
+    setConfigMin(CONFIG_UINT32_NETWORK_OUT_BUFFER, "Network.OutUBuff", 65536, 1024);
+    setConfig(CONFIG_BOOL_NETWORK_TICK_ALIGNED_FLUSH, "Network.TickAlignedFlush", false);
+
+    setConfig(CONFIG_UINT32_PROFILER_SLOW_TICK_THRESHOLD, "Profiler.SlowTickThreshold", 0);
+    sTickProfiler.SetSlowTickThreshold(getConfig(CONFIG_UINT32_PROFILER_SLOW_TICK_THRESHOLD));
+    setConfig(CONFIG_BOOL_PROFILER_OPCODE_STATS, "Profiler.OpcodeStats", false);
+    sOpcodeStats.SetEnabled(getConfig(CONFIG_BOOL_PROFILER_OPCODE_STATS));
 
     setConfig(CONFIG_BOOL_PLAYER_COMMANDS, "PlayerCommands", true);
 
@@ -742,6 +762,7 @@ void World::LoadConfigSettings(bool reload)
 
     m_relocation_ai_notify_delay = sConfig.GetIntDefault("Visibility.AIRelocationNotifyDelay", 1000u);
     m_relocation_lower_limit_sq = pow(sConfig.GetFloatDefault("Visibility.RelocationLowerLimit", 10), 2);
+    m_incremental_visibility = sConfig.GetBoolDefault("Visibility.Incremental", false);
 
     // Visibility on Continents
     m_MaxVisibleDistanceOnContinents      = sConfig.GetFloatDefault("Visibility.Distance.Continents",     DEFAULT_VISIBILITY_DISTANCE);
@@ -811,6 +832,8 @@ void World::LoadConfigSettings(bool reload)
     {
         m_dataPath = dataPath;
         sLog.outString("Using DataDir %s", m_dataPath.c_str());
+
+        SQLStorageCache::SetDirectory(sConfig.GetStringDefault("WorldDatabaseSnapshotDir"));
     }
 
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
@@ -834,8 +857,14 @@ void World::LoadConfigSettings(bool reload)
     sLog.outString("WORLD: MMap pathfinding %sabled", enabledPathfinding ? "en" : "dis");
     MMAP::MMapFactory::createOrGetMMapManager()->SetEnabled(enabledPathfinding);
 
+    setConfig(CONFIG_BOOL_TERRAIN_PREFETCH, "Terrain.Prefetch", false);
+    setConfigPos(CONFIG_FLOAT_TERRAIN_PREFETCH_DISTANCE, "Terrain.PrefetchDistance", 250.0f);
+
     setConfig(CONFIG_BOOL_PATH_FIND_OPTIMIZE, "PathFinder.OptimizePath", true);
     setConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z, "PathFinder.NormalizeZ", false);
+    setConfig(CONFIG_UINT32_PATH_FIND_CACHE_SIZE, "PathFinder.CacheSize", 1024);
+    setConfig(CONFIG_BOOL_PATH_FIND_BATCH_REQUESTS, "PathFinder.BatchRequests", false);
+    setConfig(CONFIG_BOOL_PATH_FIND_PATCH_CORRIDOR, "PathFinder.PatchCorridor", true);
 
     setConfig(CONFIG_BOOL_REGEN_ZONE_AREA_ON_STARTUP, "Spawns.ZoneArea", false);
 
@@ -870,6 +899,9 @@ void World::SetInitialWorldSettings()
         exit(1);
     }
 
+    if (getConfig(CONFIG_BOOL_TERRAIN_PREFETCH))
+        sTerrainPrefetcher.Start(m_dataPath);
+
     ///- Loading strings. Getting no records means core load has to be canceled because no error message can be output.
     sLog.outString("Loading MaNGOS strings...");
     if (!sObjectMgr.LoadMangosStrings())
@@ -926,6 +958,12 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Script Names...");
     sScriptDevAIMgr.LoadScriptNames();
 
+    // tables storing script names as ids depend on the name list
+    std::string scriptNamesKey;
+    for (uint32 i = 0; i < sScriptDevAIMgr.GetScriptIdsCount(); ++i)
+        scriptNamesKey.append(sScriptDevAIMgr.GetScriptName(i)).append(1, '\n');
+    SQLStorageCache::SetConversionKey(std::to_string(std::hash<std::string>()(scriptNamesKey)));
+
     sLog.outString("Loading WorldTemplate...");
     sObjectMgr.LoadWorldTemplate();
 
@@ -1192,93 +1230,146 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Player Corpses...");
     sObjectMgr.LoadCorpses();
 
-    sLog.outString("Loading Loot Tables...");
+    ///- Static data below only depends on what was loaded above and on the loaders named as dependencies,
+    ///- independent ones run in parallel when StartupLoader.Threads > 1
+    StartupLoader loader;
     LootIdSet ids_set;
-    LoadLootTables(ids_set);
-    sLog.outString(">>> Loot Tables loaded");
-    sLog.outString();
 
-    sLog.outString("Loading Skill Fishing base level requirements...");
-    sObjectMgr.LoadFishingBaseSkillLevel();
-
-    sLog.outString("Loading Instance encounters data...");  // must be after Creature loading
-    sObjectMgr.LoadInstanceEncounters();
-
-    sLog.outString("Loading Npc Text Id...");
-    sObjectMgr.LoadNpcGossips();                            // must be after load Creature and LoadGossipText
-
-    sLog.outString("Loading Scripts random templates...");  // must be before String calls
-    sScriptMgr.LoadDbScriptRandomTemplates();
-    ///- Load and initialize DBScripts Engine
-    sLog.outString("Loading DB-Scripts Engine...");
-    sScriptMgr.LoadScriptMap(SCRIPT_TYPE_RELAY);                // must be first in dbscripts loading
-    sScriptMgr.LoadScriptMap(SCRIPT_TYPE_GOSSIP);               // must be before gossip menu options
-    sScriptMgr.LoadScriptMap(SCRIPT_TYPE_QUEST_START);          // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    sScriptMgr.LoadScriptMap(SCRIPT_TYPE_QUEST_END);            // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    sScriptMgr.LoadScriptMap(SCRIPT_TYPE_SPELL);                // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadScriptMap(SCRIPT_TYPE_GAMEOBJECT);           // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadScriptMap(SCRIPT_TYPE_GAMEOBJECT_TEMPLATE);  // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadScriptMap(SCRIPT_TYPE_EVENT);                // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadScriptMap(SCRIPT_TYPE_CREATURE_DEATH);       // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadScriptMap(SCRIPT_TYPE_CREATURE_MOVEMENT);    // before loading from creature_movement
-    sObjectMgr.LoadAreatriggerLocales();
-    sLog.outString(">>> Scripts loaded");
-    sLog.outString();
+    loader.Add("loot_tables", [&ids_set]()
+    {
+        sLog.outString("Loading Loot Tables...");
+        LoadLootTables(ids_set);
+        sLog.outString(">>> Loot Tables loaded");
+    });
 
-    sLog.outString("Loading Scripts text locales...");      // must be after Load*Scripts calls
-    sScriptMgr.LoadDbScriptStrings();
+    loader.Add("fishing_skill_levels", []()
+    {
+        sLog.outString("Loading Skill Fishing base level requirements...");
+        sObjectMgr.LoadFishingBaseSkillLevel();
+    });
 
-    sLog.outString("Loading Gossip Menus...");
-    sObjectMgr.LoadGossipMenus();
+    loader.Add("instance_encounters", []()
+    {
+        sLog.outString("Loading Instance encounters data...");  // must be after Creature loading
+        sObjectMgr.LoadInstanceEncounters();
+    });
 
-    sLog.outString("Loading Vendors...");
-    sObjectMgr.LoadVendorTemplates();                       // must be after load ItemTemplate
-    sObjectMgr.LoadVendors();                               // must be after load CreatureTemplate, VendorTemplate, and ItemTemplate
+    loader.Add("npc_gossips", []()
+    {
+        sLog.outString("Loading Npc Text Id...");
+        sObjectMgr.LoadNpcGossips();                        // must be after load Creature and LoadGossipText
+    });
 
-    sLog.outString("Loading Trainers...");
-    sObjectMgr.LoadTrainerTemplates();                      // must be after load CreatureTemplate
-    sObjectMgr.LoadTrainers();                              // must be after load CreatureTemplate, TrainerTemplate
+    loader.Add("dbscripts", []()
+    {
+        sLog.outString("Loading Scripts random templates...");  // must be before String calls
+        sScriptMgr.LoadDbScriptRandomTemplates();
+        ///- Load and initialize DBScripts Engine
+        sLog.outString("Loading DB-Scripts Engine...");
+        sScriptMgr.LoadScriptMap(SCRIPT_TYPE_RELAY);                // must be first in dbscripts loading
+        sScriptMgr.LoadScriptMap(SCRIPT_TYPE_GOSSIP);               // must be before gossip menu options
+        sScriptMgr.LoadScriptMap(SCRIPT_TYPE_QUEST_START);          // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
+        sScriptMgr.LoadScriptMap(SCRIPT_TYPE_QUEST_END);            // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
+        sScriptMgr.LoadScriptMap(SCRIPT_TYPE_SPELL);                // must be after load Creature/Gameobject(Template/Data)
+        sScriptMgr.LoadScriptMap(SCRIPT_TYPE_GAMEOBJECT);           // must be after load Creature/Gameobject(Template/Data)
+        sScriptMgr.LoadScriptMap(SCRIPT_TYPE_GAMEOBJECT_TEMPLATE);  // must be after load Creature/Gameobject(Template/Data)
+        sScriptMgr.LoadScriptMap(SCRIPT_TYPE_EVENT);                // must be after load Creature/Gameobject(Template/Data)
+        sScriptMgr.LoadScriptMap(SCRIPT_TYPE_CREATURE_DEATH);       // must be after load Creature/Gameobject(Template/Data)
+        sScriptMgr.LoadScriptMap(SCRIPT_TYPE_CREATURE_MOVEMENT);    // before loading from creature_movement
+        sObjectMgr.LoadAreatriggerLocales();
+        sLog.outString(">>> Scripts loaded");
+    });
 
-    sLog.outString("Loading Waypoint scripts...");
+    loader.Add("dbscript_strings", []()
+    {
+        sLog.outString("Loading Scripts text locales...");  // must be after Load*Scripts calls
+        sScriptMgr.LoadDbScriptStrings();
+    }, { "dbscripts" });
 
-    sLog.outString("Loading Waypoints...");
-    sWaypointMgr.Load();
+    loader.Add("gossip_menus", []()
+    {
+        sLog.outString("Loading Gossip Menus...");
+        sObjectMgr.LoadGossipMenus();
+    }, { "dbscripts" });
 
-    sLog.outString("Loading ReservedNames...");
-    sObjectMgr.LoadReservedPlayersNames();
+    loader.Add("vendors", []()
+    {
+        sLog.outString("Loading Vendors...");
+        sObjectMgr.LoadVendorTemplates();                   // must be after load ItemTemplate
+        sObjectMgr.LoadVendors();                           // must be after load CreatureTemplate, VendorTemplate, and ItemTemplate
+    });
 
-    sLog.outString("Loading GameObjects for quests...");
-    sObjectMgr.LoadGameObjectForQuests();
+    loader.Add("trainers", []()
+    {
+        sLog.outString("Loading Trainers...");
+        sObjectMgr.LoadTrainerTemplates();                  // must be after load CreatureTemplate
+        sObjectMgr.LoadTrainers();                          // must be after load CreatureTemplate, TrainerTemplate
+    });
 
-    sLog.outString("Loading BattleMasters...");
-    sBattleGroundMgr.LoadBattleMastersEntry(false);
+    loader.Add("waypoints", []()
+    {
+        sLog.outString("Loading Waypoints...");
+        sWaypointMgr.Load();
+    }, { "dbscripts" });
 
-    sLog.outString("Loading BattleGround event indexes...");
-    sBattleGroundMgr.LoadBattleEventIndexes(false);
+    loader.Add("reserved_names", []()
+    {
+        sLog.outString("Loading ReservedNames...");
+        sObjectMgr.LoadReservedPlayersNames();
+    });
 
-    sLog.outString("Loading GameTeleports...");
-    sObjectMgr.LoadGameTele();
+    loader.Add("gameobjects_for_quests", []()
+    {
+        sLog.outString("Loading GameObjects for quests...");
+        sObjectMgr.LoadGameObjectForQuests();
+    }, { "loot_tables" });
 
-    sLog.outString("Loading Questgiver Greetings...");
-    sObjectMgr.LoadQuestgiverGreeting();
+    loader.Add("battlemasters", []()
+    {
+        sLog.outString("Loading BattleMasters...");
+        sBattleGroundMgr.LoadBattleMastersEntry(false);
 
-    sLog.outString("Loading Trainer Greetings...");
-    sObjectMgr.LoadTrainerGreetings();
+        sLog.outString("Loading BattleGround event indexes...");
+        sBattleGroundMgr.LoadBattleEventIndexes(false);
+    });
+
+    loader.Add("game_tele", []()
+    {
+        sLog.outString("Loading GameTeleports...");
+        sObjectMgr.LoadGameTele();
+    });
+
+    loader.Add("questgiver_greetings", []()
+    {
+        sLog.outString("Loading Questgiver Greetings...");
+        sObjectMgr.LoadQuestgiverGreeting();
+    });
+
+    loader.Add("trainer_greetings", []()
+    {
+        sLog.outString("Loading Trainer Greetings...");
+        sObjectMgr.LoadTrainerGreetings();
+    });
 
     ///- Loading localization data
-    sLog.outString("Loading Localization strings...");
-    sObjectMgr.LoadCreatureLocales();                       // must be after CreatureInfo loading
-    sObjectMgr.LoadGameObjectLocales();                     // must be after GameobjectInfo loading
-    sObjectMgr.LoadItemLocales();                           // must be after ItemPrototypes loading
-    sObjectMgr.LoadQuestLocales();                          // must be after QuestTemplates loading
-    sObjectMgr.LoadGossipTextLocales();                     // must be after LoadGossipText
-    sObjectMgr.LoadPageTextLocales();                       // must be after PageText loading
-    sObjectMgr.LoadGossipMenuItemsLocales();                // must be after gossip menu items loading
-    sObjectMgr.LoadPointOfInterestLocales();                // must be after POI loading
-    sObjectMgr.LoadQuestgiverGreetingLocales();
-    sObjectMgr.LoadTrainerGreetingLocales();                // must be after CreatureInfo loading
-    sObjectMgr.LoadBroadcastTextLocales();
-    sLog.outString(">>> Localization strings loaded");
+    loader.Add("locales", []()
+    {
+        sLog.outString("Loading Localization strings...");
+        sObjectMgr.LoadCreatureLocales();                   // must be after CreatureInfo loading
+        sObjectMgr.LoadGameObjectLocales();                 // must be after GameobjectInfo loading
+        sObjectMgr.LoadItemLocales();                       // must be after ItemPrototypes loading
+        sObjectMgr.LoadQuestLocales();                      // must be after QuestTemplates loading
+        sObjectMgr.LoadGossipTextLocales();                 // must be after LoadGossipText
+        sObjectMgr.LoadPageTextLocales();                   // must be after PageText loading
+        sObjectMgr.LoadGossipMenuItemsLocales();            // must be after gossip menu items loading
+        sObjectMgr.LoadPointOfInterestLocales();            // must be after POI loading
+        sObjectMgr.LoadQuestgiverGreetingLocales();
+        sObjectMgr.LoadTrainerGreetingLocales();            // must be after CreatureInfo loading
+        sObjectMgr.LoadBroadcastTextLocales();
+        sLog.outString(">>> Localization strings loaded");
+    }, { "gossip_menus", "questgiver_greetings", "trainer_greetings" });
+
+    loader.Run(getConfig(CONFIG_UINT32_STARTUP_LOADER_THREADS));
     sLog.outString();
 
 #ifdef ENABLE_PLAYERBOTS
@@ -1505,11 +1596,14 @@ void World::DetectDBCLang()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    ProfileTick profileTick;
+    PROFILE_ZONE("World::Update");
+
     m_currentMSTime = WorldTimer::getMSTime();
     m_currentTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
     m_currentDiff = diff;
 
-#ifdef ENABLE_PLAYERBOTS
+    // rolling average over the last 600 ticks, reported by .server info
     m_currentDiffSum += diff;
     m_currentDiffSumIndex++;
 
@@ -1524,17 +1618,18 @@ void World::Update(uint32 diff)
 
     m_averageDiff = (uint32)(m_currentDiffSum / m_histDiff.size());
 
+#ifdef ENABLE_PLAYERBOTS
     if (m_currentDiffSumIndex && m_currentDiffSumIndex % 60 == 0)
     {
         sLog.outBasic("Avg Diff: %u. Sessions online: %u.", m_averageDiff, (uint32)GetActiveSessionCount());
         sLog.outBasic("Max Diff: %u.", m_maxDiff);
     }
+#endif
 
     if (m_currentDiffSum % 3000 == 0)
     {
         m_maxDiff = *std::max_element(m_histDiff.begin(), m_histDiff.end());
     }
-#endif
 
     ///- Update the different timers
     for (auto& m_timer : m_timers)
@@ -1695,6 +1790,12 @@ void World::Update(uint32 diff)
     // And last, but not least handle the issued cli commands
     ProcessCliCommands();
 
+    // Push out what the world tick queued for sessions, map ticks flush their own players
+    ExecuteForAllSessions([](WorldSession const& session)
+    {
+        session.FlushSocket();
+    });
+
     // cleanup unused GridMap objects as well as VMaps
     sTerrainMgr.Update(diff);
 #ifdef BUILD_METRICS
@@ -2144,6 +2245,8 @@ void World::ShutdownCancel()
 
 void World::UpdateSessions(uint32 diff)
 {
+    PROFILE_ZONE("World::UpdateSessions");
+
     ///- Add new sessions
     {
         std::deque<WorldSession*> sessionQueueCopy;
@@ -2590,6 +2693,17 @@ void World::GeneratePacketMetrics()
         m_opcodeCounters[i] = 0;
     }
 
+    // only the most expensive opcodes of the interval, one measurement each
+    for (OpcodeStatsEntry const& entry : sOpcodeStats.CollectInterval(20))
+    {
+        metric::measurement meas("world.metrics.opcodes", { {"opcode", opcodeTable[entry.opcode].name}, {"context", OpcodeStats::GetContextName(entry.context)} });
+        meas.add_field("count", std::to_string(entry.count));
+        meas.add_field("bytes", std::to_string(entry.bytes));
+        meas.add_field("total_us", std::to_string(entry.totalTime));
+        meas.add_field("p50_us", std::to_string(entry.p50Time));
+        meas.add_field("p99_us", std::to_string(entry.p99Time));
+    }
+
     metric::measurement meas_players("world.metrics.players");
     meas_players.add_field("online", std::to_string(GetActiveSessionCount()));
     meas_players.add_field("unique", std::to_string(GetUniqueSessionCount()));
@@ -2620,6 +2734,36 @@ void World::GeneratePacketMetrics()
 
     metric::measurement meas_latency("world.metrics.latency");
     meas_latency.add_field("online", std::to_string(GetAverageLatency()));
+
+    // socket writes since the last report, which runs once per second
+    uint64 writes, bytes;
+    WorldSocket::ConsumeWriteMetrics(writes, bytes);
+    metric::measurement meas_network("world.metrics.network");
+    meas_network.add_field("writes", std::to_string(writes));
+    meas_network.add_field("bytes", std::to_string(bytes));
+    meas_network.add_field("writes_per_session", std::to_string(m_sessions.empty() ? 0.0 : double(writes) / m_sessions.size()));
+    meas_network.add_field("bytes_per_write", std::to_string(writes ? bytes / writes : 0));
+
+    uint64 reads, packets;
+    WorldSocket::ConsumeReadMetrics(reads, packets);
+    uint32 networkThreads = std::max(1, sConfig.GetIntDefault("Network.Threads", 1));
+    meas_network.add_field("reads", std::to_string(reads));
+    meas_network.add_field("packets_received", std::to_string(packets));
+    meas_network.add_field("packets_per_thread", std::to_string(packets / networkThreads));
+    meas_network.add_field("packets_per_read", std::to_string(reads ? double(packets) / reads : 0.0));
+
+    // map thread time spent waiting for tile files not prefetched in time
+    uint64 terrainLoads, terrainLoadTime;
+    TerrainPrefetcher::ConsumeBlockedLoadMetrics(terrainLoads, terrainLoadTime);
+    metric::measurement meas_terrain("world.metrics.terrain");
+    meas_terrain.add_field("loads", std::to_string(terrainLoads));
+    meas_terrain.add_field("blocked_us", std::to_string(terrainLoadTime));
+
+    uint64 pathCacheHits, pathCacheMisses;
+    PolyPathCache::ConsumeMetrics(pathCacheHits, pathCacheMisses);
+    metric::measurement meas_pathfinding("world.metrics.pathfinding");
+    meas_pathfinding.add_field("cache_hits", std::to_string(pathCacheHits));
+    meas_pathfinding.add_field("cache_misses", std::to_string(pathCacheMisses));
 }
 
 uint32 World::GetAverageLatency() const
@@ -141,6 +141,10 @@ enum eConfigUInt32Values
     CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK,
     CONFIG_UINT32_UPTIME_UPDATE,
     CONFIG_UINT32_NUM_MAP_THREADS,
+    CONFIG_UINT32_STARTUP_LOADER_THREADS,
+    CONFIG_UINT32_IDLE_INSTANCE_UPDATE_RATE,
+    CONFIG_UINT32_GRID_LOADING_TICK_BUDGET,
+    CONFIG_UINT32_PATH_FIND_CACHE_SIZE,
     CONFIG_UINT32_AUCTION_DEPOSIT_MIN,
     CONFIG_UINT32_SKILL_CHANCE_ORANGE,
     CONFIG_UINT32_SKILL_CHANCE_YELLOW,
@@ -199,6 +203,8 @@ enum eConfigUInt32Values
     CONFIG_UINT32_CREATURE_PICKPOCKET_RESTOCK_DELAY,
     CONFIG_UINT32_CHANNEL_STATIC_AUTO_TRESHOLD,
     CONFIG_UINT32_LFG_MATCHMAKING_TIMER,
+    CONFIG_UINT32_NETWORK_OUT_BUFFER,
+    CONFIG_UINT32_PROFILER_SLOW_TICK_THRESHOLD,
     CONFIG_UINT32_VALUE_COUNT
 };
 
@@ -284,6 +290,7 @@ enum eConfigFloatValues
     CONFIG_FLOAT_GHOST_RUN_SPEED_WORLD,
     CONFIG_FLOAT_GHOST_RUN_SPEED_BG,
     CONFIG_FLOAT_LEASH_RADIUS,
+    CONFIG_FLOAT_TERRAIN_PREFETCH_DISTANCE,
     CONFIG_FLOAT_VALUE_COUNT
 };
 
@@ -338,6 +345,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_OUTDOORPVP_SI_ENABLED,
     CONFIG_BOOL_OUTDOORPVP_EP_ENABLED,
     CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET,
+    CONFIG_BOOL_NETWORK_TICK_ALIGNED_FLUSH,
     CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT,
     CONFIG_BOOL_CLEAN_CHARACTER_DB,
     CONFIG_BOOL_VMAP_INDOOR_CHECK,
@@ -349,11 +357,17 @@ enum eConfigBoolValues
     CONFIG_BOOL_AUTOLOAD_ACTIVE,
     CONFIG_BOOL_PATH_FIND_OPTIMIZE,
     CONFIG_BOOL_PATH_FIND_NORMALIZE_Z,
+    CONFIG_BOOL_PATH_FIND_BATCH_REQUESTS,
+    CONFIG_BOOL_PATH_FIND_PATCH_CORRIDOR,
     CONFIG_BOOL_LFG_MATCHMAKING,
     CONFIG_BOOL_ALWAYS_SHOW_QUEST_GREETING,
     CONFIG_BOOL_DISABLE_INSTANCE_RELOCATE,
     CONFIG_BOOL_PRELOAD_MMAP_TILES,
     CONFIG_BOOL_REGEN_ZONE_AREA_ON_STARTUP,
+    CONFIG_BOOL_MAP_UPDATE_PIN_THREADS,
+    CONFIG_BOOL_TERRAIN_PREFETCH,
+    CONFIG_BOOL_PROFILER_OPCODE_STATS,
+    CONFIG_BOOL_GRID_LOADING_STAGED,
     CONFIG_BOOL_VALUE_COUNT
 };
 
@@ -540,6 +554,7 @@ class World
 
         static float GetRelocationLowerLimitSq() { return m_relocation_lower_limit_sq; }
         static uint32 GetRelocationAINotifyDelay() { return m_relocation_ai_notify_delay; }
+        static bool IsIncrementalVisibility() { return m_incremental_visibility; }
 
         void InitServerMaintenanceCheck();
         void ServerMaintenanceStart();
@@ -579,10 +594,8 @@ class World
         static uint32 GetCurrentMSTime() { return m_currentMSTime; }
         static TimePoint GetCurrentClockTime() { return m_currentTime; }
         static uint32 GetCurrentDiff() { return m_currentDiff; }
-#ifdef ENABLE_PLAYERBOTS
         static uint32 GetAverageDiff() { return m_averageDiff; }
         static uint32 GetMaxDiff() { return m_maxDiff; }
-#endif
 
         template<typename T>
         void ExecuteForAllSessions(T executor) const
@@ -676,6 +689,7 @@ class World
 
         static float  m_relocation_lower_limit_sq;
         static uint32 m_relocation_ai_notify_delay;
+        static bool   m_incremental_visibility;
 
         // CLI command holder to be thread safe
         std::mutex m_cliCommandQueueLock;
@@ -705,13 +719,11 @@ class World
         static uint32 m_currentMSTime;
         static TimePoint m_currentTime;
         static uint32 m_currentDiff;
-#ifdef ENABLE_PLAYERBOTS
         static uint32 m_currentDiffSum;
         static uint32 m_currentDiffSumIndex;
         static uint32 m_averageDiff;
         static uint32 m_maxDiff;
         static std::list<uint32> m_histDiff;
-#endif
 
         Messager<World> m_messager;
 
@@ -28,6 +28,7 @@
 #include "Log/Log.h"
 #include "RealmList.h"
 #include "AuthSocket.h"
+#include "BanCache.h"
 #include "AuthCodes.h"
 #include "Auth/SRP6.h"
 #include "Util/CommonDefines.h"
@@ -190,6 +191,14 @@ const char logonProofUnknownAccountVanilla[2] = { CMD_AUTH_LOGON_PROOF, AUTH_LOG
 const char logonProofVersionInvalid[2] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_VERSION_INVALID };
 const char logonProofUnknownAccountPinInvalid[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 3, 0 };
 
+/// Database state gathered for a logon challenge by the login query pool
+struct LogonChallengeQuery
+{
+    bool ipBanned = false;
+    std::unique_ptr<QueryResult> account;
+    AccountBanState banState = ACCOUNT_BAN_NONE;
+};
+
 /// Constructor - set the N and g values for SRP6
 AuthSocket::AuthSocket(boost::asio::io_context& context)
     : AsyncSocket<AuthSocket>(context), _status(STATUS_CHALLENGE), _build(0), _accountSecurityLevel(SEC_PLAYER), m_timeoutTimer(context)
@@ -405,24 +414,31 @@ bool AuthSocket::_HandleLogonChallenge()
             *pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
             *pkt << uint8(0x00);
 
-            ///- Verify that this IP is not in the ip_banned table
-            // No SQL injection possible (paste the IP address as passed by the socket)
-            std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
-                "WHERE (expires_at = banned_at OR expires_at > " _UNIXTIME_ ") AND ip = '%s'", self->GetRemoteAddress().c_str()));
-
-            if (ip_banned_result)
+            ///- Look the account and its bans up off the network thread
+            self->AsyncQuery([login = self->_safelogin, ip = self->GetRemoteAddress()]()
             {
-                *pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
-                BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", self->GetRemoteAddress().c_str());
-            }
-            else
+                LogonChallengeQuery data;
+                data.ipBanned = sBanCache.IsIpBanned(ip);
+                if (!data.ipBanned)
+                {
+                    // No SQL injection (escaped user name)
+                    data.account = LoginDatabase.PQuery("SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = '%s'", login.c_str());
+                    if (data.account)
+                        data.banState = sBanCache.GetAccountBanState((*data.account)[0].GetUInt32());
+                }
+                return data;
+            },
+            [self, pkt](LogonChallengeQuery data)
             {
-                ///- Get the account details from the account table
-                // No SQL injection (escaped user name)
-                auto queryResult = LoginDatabase.PQuery("SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = '%s'", self->_safelogin.c_str());
-                if (queryResult)
+                ///- Verify that this IP is not in the ip_banned table
+                if (data.ipBanned)
+                {
+                    *pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
+                    BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", self->GetRemoteAddress().c_str());
+                }
+                else if (data.account)
                 {
-                    Field* fields = queryResult->Fetch();
+                    Field* fields = data.account->Fetch();
 
                     ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
                     bool locked = false;
@@ -456,20 +472,15 @@ bool AuthSocket::_HandleLogonChallenge()
                     if (!locked && !broken)
                     {
                         ///- If the account is banned, reject the logon attempt
-                        auto banresult = LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
-                            "account_id = %u AND active = 1 AND (expires_at > " _UNIXTIME_ " OR expires_at = banned_at)", fields[0].GetUInt32());
-                        if (banresult)
+                        if (data.banState == ACCOUNT_BAN_BANNED)
                         {
-                            if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
-                            {
-                                *pkt << uint8(AUTH_LOGON_FAILED_BANNED);
-                                BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", self->_login.c_str());
-                            }
-                            else
-                            {
-                                *pkt << uint8(AUTH_LOGON_FAILED_SUSPENDED);
-                                BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", self->_login.c_str());
-                            }
+                            *pkt << uint8(AUTH_LOGON_FAILED_BANNED);
+                            BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", self->_login.c_str());
+                        }
+                        else if (data.banState == ACCOUNT_BAN_SUSPENDED)
+                        {
+                            *pkt << uint8(AUTH_LOGON_FAILED_SUSPENDED);
+                            BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", self->_login.c_str());
                         }
                         else
                         {
@@ -525,6 +536,8 @@ bool AuthSocket::_HandleLogonChallenge()
                             if (securityFlags & SECURITY_FLAG_AUTHENTICATOR)    // Authenticator input
                                 *pkt << uint8(1);
 
+                            self->m_accountId = fields[0].GetUInt32();
+
                             uint8 secLevel = fields[3].GetUInt8();
                             self->_accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
 
@@ -535,10 +548,10 @@ bool AuthSocket::_HandleLogonChallenge()
                 }
                 else                                                // no account
                     *pkt << uint8(AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT);
-            }
 
-            self->Write((const char*)pkt->contents(), pkt->size(), [self, pkt](const boost::system::error_code& /*error*/, std::size_t /*written*/) {});
-            self->ProcessIncomingData();
+                self->Write((const char*)pkt->contents(), pkt->size(), [self, pkt](const boost::system::error_code& /*error*/, std::size_t /*written*/) {});
+                self->ProcessIncomingData();
+            });
         });
     });
 
@@ -657,39 +670,50 @@ bool AuthSocket::_HandleLogonProof()
             uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
             if (MaxWrongPassCount > 0)
             {
-                // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
-                LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", self->_safelogin.c_str());
-
-                if (auto loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", self->_safelogin.c_str()))
+                self->AsyncQuery([login = self->_login, safeLogin = self->_safelogin, ip = self->GetRemoteAddress(), MaxWrongPassCount]()
                 {
-                    Field* fields = loginfail->Fetch();
-                    uint32 failed_logins = fields[1].GetUInt32();
+                    // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
+                    LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", safeLogin.c_str());
 
-                    if (failed_logins >= MaxWrongPassCount)
+                    if (auto loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", safeLogin.c_str()))
                     {
-                        uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
-                        bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+                        Field* fields = loginfail->Fetch();
+                        uint32 failed_logins = fields[1].GetUInt32();
 
-                        if (WrongPassBanType)
-                        {
-                            uint32 acc_id = fields[0].GetUInt32();
-                            LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
-                                "VALUES ('%u'," _UNIXTIME_ "," _UNIXTIME_ "+'%u','MaNGOS realmd','Failed login autoban',1)",
-                                acc_id, WrongPassBanTime);
-                            BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
-                                self->_login.c_str(), WrongPassBanTime, failed_logins);
-                        }
-                        else
+                        if (failed_logins >= MaxWrongPassCount)
                         {
-                            std::string current_ip = self->GetRemoteAddress();
-                            LoginDatabase.escape_string(current_ip);
-                            LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s'," _UNIXTIME_ "," _UNIXTIME_ "+'%u','MaNGOS realmd','Failed login autoban')",
-                                current_ip.c_str(), WrongPassBanTime);
-                            BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
-                                current_ip.c_str(), WrongPassBanTime, self->_login.c_str(), failed_logins);
+                            uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
+                            bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+
+                            if (WrongPassBanType)
+                            {
+                                uint32 acc_id = fields[0].GetUInt32();
+                                LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
+                                    "VALUES ('%u'," _UNIXTIME_ "," _UNIXTIME_ "+'%u','MaNGOS realmd','Failed login autoban',1)",
+                                    acc_id, WrongPassBanTime);
+                                sBanCache.InvalidateAccount(acc_id);
+                                BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
+                                    login.c_str(), WrongPassBanTime, failed_logins);
+                            }
+                            else
+                            {
+                                std::string current_ip = ip;
+                                LoginDatabase.escape_string(current_ip);
+                                LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s'," _UNIXTIME_ "," _UNIXTIME_ "+'%u','MaNGOS realmd','Failed login autoban')",
+                                    current_ip.c_str(), WrongPassBanTime);
+                                sBanCache.InvalidateIp(ip);
+                                BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
+                                    current_ip.c_str(), WrongPassBanTime, login.c_str(), failed_logins);
+                            }
                         }
                     }
-                }
+                    return true;
+                },
+                [self](bool)
+                {
+                    self->ProcessIncomingData();
+                });
+                return;
             }
             self->ProcessIncomingData();
         }
@@ -750,32 +774,37 @@ bool AuthSocket::_HandleReconnectChallenge()
             EndianConvert(body->build);
             self->_build = body->build;
 
-            auto queryResult = LoginDatabase.PQuery("SELECT sessionkey FROM account WHERE username = '%s'", self->_safelogin.c_str());
-
-            // Stop if the account is not found
-            if (!queryResult)
+            self->AsyncQuery([login = self->_safelogin]()
             {
-                sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", self->_login.c_str());
-                self->Close();
-                return;
-            }
+                return LoginDatabase.PQuery("SELECT sessionkey FROM account WHERE username = '%s'", login.c_str());
+            },
+            [self](std::unique_ptr<QueryResult> queryResult)
+            {
+                // Stop if the account is not found
+                if (!queryResult)
+                {
+                    sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", self->_login.c_str());
+                    self->Close();
+                    return;
+                }
 
-            Field* fields = queryResult->Fetch();
-            self->srp.SetStrongSessionKey(fields[0].GetString());
+                Field* fields = queryResult->Fetch();
+                self->srp.SetStrongSessionKey(fields[0].GetString());
 
-            ///- All good, await client's proof
-            self->_status = STATUS_RECON_PROOF;
+                ///- All good, await client's proof
+                self->_status = STATUS_RECON_PROOF;
 
-            ///- Sending response
-            std::shared_ptr<ByteBuffer> pkt = std::make_shared<ByteBuffer>();
-            *pkt << (uint8)CMD_AUTH_RECONNECT_CHALLENGE;
-            *pkt << (uint8)0x00;
-            self->_reconnectProof.SetRand(16 * 8);
-            pkt->append(self->_reconnectProof.AsByteArray(16));        // 16 bytes random
-            pkt->append(VersionChallenge.data(), VersionChallenge.size());
-            self->Write((const char*)pkt->contents(), pkt->size(), [self, pkt](const boost::system::error_code& /*error*/, std::size_t /*written*/) {});
+                ///- Sending response
+                std::shared_ptr<ByteBuffer> pkt = std::make_shared<ByteBuffer>();
+                *pkt << (uint8)CMD_AUTH_RECONNECT_CHALLENGE;
+                *pkt << (uint8)0x00;
+                self->_reconnectProof.SetRand(16 * 8);
+                pkt->append(self->_reconnectProof.AsByteArray(16));        // 16 bytes random
+                pkt->append(VersionChallenge.data(), VersionChallenge.size());
+                self->Write((const char*)pkt->contents(), pkt->size(), [self, pkt](const boost::system::error_code& /*error*/, std::size_t /*written*/) {});
 
-            self->ProcessIncomingData();
+                self->ProcessIncomingData();
+            });
         });
     });
 
@@ -852,40 +881,54 @@ bool AuthSocket::_HandleRealmList()
             return;
         }
 
-        // Get the user id (else close the connection)
+        // Get the user id and its character count on every realm in one go (else close the connection)
         // No SQL injection (escaped user name)
-
-        auto queryResult = LoginDatabase.PQuery("SELECT id, gmlevel FROM account WHERE username = '%s'", self->_safelogin.c_str());
-        if (!queryResult)
+        self->AsyncQuery([login = self->_safelogin]()
         {
-            sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.", self->_login.c_str());
-            self->Close();
-            return;
-        }
+            return LoginDatabase.PQuery("SELECT a.id, a.gmlevel, rc.realmid, rc.numchars FROM account a "
+                "LEFT JOIN realmcharacters rc ON rc.acctid = a.id WHERE a.username = '%s'", login.c_str());
+        },
+        [self](std::unique_ptr<QueryResult> queryResult)
+        {
+            if (!queryResult)
+            {
+                sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.", self->_login.c_str());
+                self->Close();
+                return;
+            }
 
-        uint32 id = (*queryResult)[0].GetUInt32();
-        uint8 accountSecurityLevel = (*queryResult)[1].GetUInt8();
+            uint8 accountSecurityLevel = (*queryResult)[1].GetUInt8();
 
-        ///- Update realm list if need
-        sRealmList.UpdateIfNeed();
+            RealmCharacterCounts characterCounts;
+            do
+            {
+                Field* fields = queryResult->Fetch();
+                if (!fields[2].IsNULL())
+                    characterCounts[fields[2].GetUInt32()] = fields[3].GetUInt8();
+            }
+            while (queryResult->NextRow());
 
-        ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
-        ByteBuffer pkt;
-        self->LoadRealmlist(pkt, id, accountSecurityLevel);
+            ///- Update realm list if need
+            sRealmList.UpdateIfNeed();
 
-        std::shared_ptr<ByteBuffer> hdr = std::make_shared<ByteBuffer>();
-        *hdr << (uint8)CMD_REALM_LIST;
-        *hdr << (uint16)pkt.size();
-        hdr->append(pkt);
+            ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
+            ByteBuffer pkt;
+            self->LoadRealmlist(pkt, characterCounts, accountSecurityLevel);
 
-        self->Write((const char*)hdr->contents(), hdr->size(), [self, hdr](const boost::system::error_code& /*error*/, std::size_t /*written*/) {});
-        self->ProcessIncomingData();
+            std::shared_ptr<ByteBuffer> hdr = std::make_shared<ByteBuffer>();
+            *hdr << (uint8)CMD_REALM_LIST;
+            *hdr << (uint16)pkt.size();
+            hdr->append(pkt);
+
+            self->Write((const char*)hdr->contents(), hdr->size(), [self, hdr](const boost::system::error_code& /*error*/, std::size_t /*written*/) {});
+            self->ProcessIncomingData();
+        });
     });
 
     return true;
 }
 
-void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLevel)
+void AuthSocket::LoadRealmlist(ByteBuffer& pkt, RealmCharacterCounts const& characterCounts, uint8 securityLevel)
 {
     switch (_build)
     {
@@ -898,17 +941,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
 
             for (const auto& i : sRealmList)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                auto queryResult = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (queryResult)
-                {
-                    Field* fields = queryResult->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                }
-                else
-                    AmountOfCharacters = 0;
+                auto countItr = characterCounts.find(i.second.m_ID);
+                uint8 AmountOfCharacters = countItr != characterCounts.end() ? countItr->second : 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
@@ -964,17 +998,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
 
             for (const auto& i : sRealmList)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                auto queryResult = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (queryResult)
-                {
-                    Field* fields = queryResult->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                }
-                else
-                    AmountOfCharacters = 0;
+                auto countItr = characterCounts.find(i.second.m_ID);
+                uint8 AmountOfCharacters = countItr != characterCounts.end() ? countItr->second : 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
@@ -1150,23 +1175,29 @@ void AuthSocket::verifyVersionAndFinalizeAuthentication(std::shared_ptr<sAuthLog
     ///- Update the sessionkey, current ip and login time and reset number of failed logins in the account table for this account
     // No SQL injection (escaped user input) and IP address as received by socket
     const char* K_hex = srp.GetStrongSessionKey().AsHexStr();
-    // Note: In case of heavy load, this sync query will be a heavy bottleneck
-    LoginDatabase.DirectPExecute("UPDATE account SET sessionkey = '%s', locale = '%s', failed_logins = 0, os = '%s', platform = '%s' WHERE username = '%s'", K_hex, _safelocale.c_str(), m_os.c_str(), m_platform.c_str(), _safelogin.c_str());
-    std::unique_ptr<QueryResult> loginfail(LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str()));
-    if (loginfail)
-        LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s'," _NOW_ ",'%u')", loginfail->Fetch()[0].GetUInt32(), GetRemoteAddress().c_str(), LOGIN_TYPE_REALMD);
+    std::string sessionKey = K_hex;
     OPENSSL_free((void*)K_hex);
 
-    ///- Finish SRP6 and send the final result to the client
-    Sha1Hash sha;
-    srp.Finalize(sha);
+    // the session key has to be stored before the client is told to connect to the world server
+    AsyncQuery([sessionKey, locale = _safelocale, os = m_os, platform = m_platform, login = _safelogin, accountId = m_accountId, ip = GetRemoteAddress()]()
+    {
+        LoginDatabase.DirectPExecute("UPDATE account SET sessionkey = '%s', locale = '%s', failed_logins = 0, os = '%s', platform = '%s' WHERE username = '%s'", sessionKey.c_str(), locale.c_str(), os.c_str(), platform.c_str(), login.c_str());
+        LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s'," _NOW_ ",'%u')", accountId, ip.c_str(), LOGIN_TYPE_REALMD);
+        return true;
+    },
+    [self = shared_from_this()](bool)
+    {
+        ///- Finish SRP6 and send the final result to the client
+        Sha1Hash sha;
+        self->srp.Finalize(sha);
 
-    SendProof(sha);
+        self->SendProof(sha);
 
-    ///- Set _status to authed!
-    _status = STATUS_AUTHED;
+        ///- Set _status to authed!
+        self->_status = STATUS_AUTHED;
 
-    ProcessIncomingData();
+        self->ProcessIncomingData();
+    });
 }
 
 int32 AuthSocket::generateToken(char const* b32key)
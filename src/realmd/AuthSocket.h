@@ -30,16 +30,21 @@
 #include "Util/ByteBuffer.h"
 
 #include "Network/AsyncSocket.hpp"
+#include "LoginQueryPool.h"
 
 #include <boost/asio.hpp>
 
 #include <functional>
+#include <map>
 
 #define HMAC_RES_SIZE 20
 
 struct sAuthLogonProof_C;
 struct sAuthLogonPinData_C;
 
+/// character count of an account per realm id
+typedef std::map<uint32, uint8> RealmCharacterCounts;
+
 class AuthSocket : public MaNGOS::AsyncSocket<AuthSocket>
 {
     public:
@@ -50,7 +55,7 @@ class AuthSocket : public MaNGOS::AsyncSocket<AuthSocket>
         bool OnOpen() override;
 
         void SendProof(Sha1Hash sha);
-        void LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 accountSecurityLevel = 0);
+        void LoadRealmlist(ByteBuffer& pkt, RealmCharacterCounts const& characterCounts, uint8 accountSecurityLevel = 0);
         bool VerifyPinData(uint32 pin, const sAuthLogonPinData_C& clientData);
         int32 generateToken(char const* b32key);
 
@@ -71,6 +76,13 @@ class AuthSocket : public MaNGOS::AsyncSocket<AuthSocket>
     private:
         void verifyVersionAndFinalizeAuthentication(std::shared_ptr<sAuthLogonProof_C> lp);
 
+        /// Runs query on the login query pool and continues with handler on the network thread
+        template<class Query, class Handler>
+        void AsyncQuery(Query&& query, Handler&& handler)
+        {
+            sLoginQueryPool.Execute(GetAsioSocket().get_executor(), std::forward<Query>(query), std::forward<Handler>(handler));
+        }
+
         enum eStatus
         {
             STATUS_CHALLENGE,
@@ -95,6 +107,7 @@ class AuthSocket : public MaNGOS::AsyncSocket<AuthSocket>
         std::string _safelocale;
         uint16 _build;
         AccountTypes _accountSecurityLevel;
+        uint32 m_accountId = 0;
 
         BigNumber m_serverSecuritySalt;
         uint32 m_gridSeed = 0;
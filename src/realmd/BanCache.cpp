@@ -0,0 +1,121 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "BanCache.h"
+#include "Database/DatabaseEnv.h"
+
+#include <ctime>
+
+extern DatabaseType LoginDatabase;
+
+// number of cached entries above which expired ones are dropped
+static constexpr size_t BAN_CACHE_PRUNE_SIZE = 4096;
+
+BanCache& BanCache::Instance()
+{
+    static BanCache cache;
+    return cache;
+}
+
+BanCache::BanCache() : m_ttl(0)
+{
+}
+
+template<class Map>
+void BanCache::PruneIfNeed(Map& entries, time_t now)
+{
+    if (entries.size() < BAN_CACHE_PRUNE_SIZE)
+        return;
+
+    for (auto itr = entries.begin(); itr != entries.end();)
+    {
+        if (itr->second.expireTime <= now)
+            itr = entries.erase(itr);
+        else
+            ++itr;
+    }
+}
+
+bool BanCache::IsIpBanned(std::string const& ip)
+{
+    time_t now = time(nullptr);
+    if (m_ttl)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto itr = m_ips.find(ip);
+        if (itr != m_ips.end() && itr->second.expireTime > now)
+            return itr->second.state;
+    }
+
+    // No SQL injection possible (paste the IP address as passed by the socket)
+    std::unique_ptr<QueryResult> result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
+        "WHERE (expires_at = banned_at OR expires_at > " _UNIXTIME_ ") AND ip = '%s'", ip.c_str()));
+    bool banned = result != nullptr;
+
+    if (m_ttl)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        PruneIfNeed(m_ips, now);
+        m_ips[ip] = { banned, now + m_ttl };
+    }
+
+    return banned;
+}
+
+AccountBanState BanCache::GetAccountBanState(uint32 accountId)
+{
+    time_t now = time(nullptr);
+    if (m_ttl)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto itr = m_accounts.find(accountId);
+        if (itr != m_accounts.end() && itr->second.expireTime > now)
+            return itr->second.state;
+    }
+
+    AccountBanState state = ACCOUNT_BAN_NONE;
+    auto result = LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
+        "account_id = %u AND active = 1 AND (expires_at > " _UNIXTIME_ " OR expires_at = banned_at)", accountId);
+    if (result)
+        state = (*result)[0].GetUInt64() == (*result)[1].GetUInt64() ? ACCOUNT_BAN_BANNED : ACCOUNT_BAN_SUSPENDED;
+
+    if (m_ttl)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        PruneIfNeed(m_accounts, now);
+        m_accounts[accountId] = { state, now + m_ttl };
+    }
+
+    return state;
+}
+
+void BanCache::InvalidateIp(std::string const& ip)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_ips.erase(ip);
+}
+
+void BanCache::InvalidateAccount(uint32 accountId)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_accounts.erase(accountId);
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _BANCACHE_H
+#define _BANCACHE_H
+
+#include "Common.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+enum AccountBanState
+{
+    ACCOUNT_BAN_NONE,
+    ACCOUNT_BAN_SUSPENDED,                                  // temporary ban
+    ACCOUNT_BAN_BANNED                                      // permanent ban
+};
+
+/// Short lived cache of ip_banned and account_banned lookups
+/// Lookups query the login database on a miss, so they are meant for the login query pool
+class BanCache
+{
+    public:
+        static BanCache& Instance();
+
+        BanCache();
+
+        /// Seconds a looked up state is reused, 0 disables the cache
+        void SetTTL(uint32 seconds) { m_ttl = seconds; }
+
+        bool IsIpBanned(std::string const& ip);
+        AccountBanState GetAccountBanState(uint32 accountId);
+
+        /// Forget a cached state after a ban was added by realmd itself
+        void InvalidateIp(std::string const& ip);
+        void InvalidateAccount(uint32 accountId);
+
+    private:
+        template<class T>
+        struct Entry
+        {
+            T state;
+            time_t expireTime;
+        };
+
+        template<class Map>
+        void PruneIfNeed(Map& entries, time_t now);
+
+        std::mutex m_mutex;
+        std::unordered_map<std::string, Entry<bool>> m_ips;
+        std::unordered_map<uint32, Entry<AccountBanState>> m_accounts;
+        uint32 m_ttl;
+};
+
+#define sBanCache BanCache::Instance()
+
+#endif
+/// @}
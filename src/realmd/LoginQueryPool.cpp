@@ -0,0 +1,60 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "LoginQueryPool.h"
+#include "Database/DatabaseEnv.h"
+
+extern DatabaseType LoginDatabase;
+
+LoginQueryPool& LoginQueryPool::Instance()
+{
+    static LoginQueryPool pool;
+    return pool;
+}
+
+void LoginQueryPool::Start(uint32 threads)
+{
+    m_context.restart();
+    m_work = std::make_unique<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>(m_context.get_executor());
+
+    for (uint32 i = 0; i < std::max(threads, 1u); ++i)
+        m_threads.emplace_back(&LoginQueryPool::Run, this);
+}
+
+void LoginQueryPool::Stop()
+{
+    if (!m_work)
+        return;
+
+    // threads leave once the queued work is done
+    m_work.reset();
+    for (std::thread& thread : m_threads)
+        thread.join();
+    m_threads.clear();
+}
+
+void LoginQueryPool::Run()
+{
+    LoginDatabase.ThreadStart();
+    m_context.run();
+    LoginDatabase.ThreadEnd();
+}
@@ -0,0 +1,71 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _LOGINQUERYPOOL_H
+#define _LOGINQUERYPOOL_H
+
+#include "Common.h"
+
+#include <boost/asio.hpp>
+
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// Runs login database work off the network threads
+class LoginQueryPool
+{
+    public:
+        static LoginQueryPool& Instance();
+
+        void Start(uint32 threads);
+        /// waits for all queued work to finish
+        void Stop();
+
+        /// Runs query on a pool thread and then handler with its result on executor
+        template<class Executor, class Query, class Handler>
+        void Execute(Executor const& executor, Query&& query, Handler&& handler)
+        {
+            boost::asio::post(m_context, [executor, query = std::forward<Query>(query), handler = std::forward<Handler>(handler)]() mutable
+            {
+                auto result = query();
+                boost::asio::post(executor, [result = std::move(result), handler = std::move(handler)]() mutable
+                {
+                    handler(std::move(result));
+                });
+            });
+        }
+
+    private:
+        /// every pool thread holds its own LoginDatabase thread resources while it runs
+        void Run();
+
+        boost::asio::io_context m_context;
+        std::unique_ptr<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> m_work;
+        std::vector<std::thread> m_threads;
+};
+
+#define sLoginQueryPool LoginQueryPool::Instance()
+
+#endif
+/// @}
@@ -27,6 +27,8 @@
 #include "Config/Config.h"
 #include "Log/Log.h"
 #include "AuthSocket.h"
+#include "BanCache.h"
+#include "LoginQueryPool.h"
 #include "SystemConfig.h"
 #include "revision.h"
 #include "revision_sql.h"
@@ -238,6 +240,10 @@ int main(int argc, char* argv[])
     LoginDatabase.Execute("DELETE FROM ip_banned WHERE expires_at<=" _UNIXTIME_ " AND expires_at<>banned_at");
     LoginDatabase.CommitTransaction();
 
+    // account and realm list queries run here instead of on the listener threads
+    sLoginQueryPool.Start(sConfig.GetIntDefault("LoginDatabaseConnections", 1));
+    sBanCache.SetTTL(sConfig.GetIntDefault("BanCacheTime", 5));
+
     uint32 networkThreadCount = sConfig.GetIntDefault("ListenerThreads", 1);
     MaNGOS::AsyncListener<AuthSocket> listener(context,
             sConfig.GetStringDefault("BindIP", "0.0.0.0"),
@@ -325,6 +331,8 @@ int main(int argc, char* argv[])
     for (uint32 i = 0; i < networkThreadCount; ++i)
         threads[i].join();
 
+    sLoginQueryPool.Stop();
+
     // Wait for the delay thread to exit
     LoginDatabase.HaltDelayThread();
 
@@ -366,9 +374,10 @@ bool StartDB()
         return false;
     }
 
-    sLog.outString("Login Database total connections: %i", 1 + 1);
+    int nConnections = sConfig.GetIntDefault("LoginDatabaseConnections", 1);
+    sLog.outString("Login Database total connections: %i", nConnections + 1);
 
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
     {
         sLog.outError("Cannot connect to database");
         return false;
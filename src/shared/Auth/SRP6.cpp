@@ -90,6 +90,48 @@ bool SRP6::CalculateSessionKey(uint8* lp_A, int l)
     return true;
 }
 
+bool SRP6::CalculateClientSessionKey(const std::string& username, const std::string& password, const uint8* lp_B, const uint8* lp_s, int l)
+{
+    B.SetBinary(lp_B, l);
+    s.SetBinary(lp_s, l);
+
+    // SRP safeguard: abort if B % N == 0
+    if ((B % N).isZero())
+        return false;
+
+    a.SetRand(19 * 8);
+    A = g.ModExp(a, N);
+
+    // same x as used for the verifier: H(s, H(USERNAME:PASSWORD))
+    Sha1Hash sha;
+    sha.UpdateData(username);
+    sha.UpdateData(":");
+    sha.UpdateData(password);
+    sha.Finalize();
+    uint8 hashIP[Sha1Hash::GetLength()];
+    memcpy(hashIP, sha.GetDigest(), Sha1Hash::GetLength());
+
+    sha.Initialize();
+    sha.UpdateData(s.AsByteArray());
+    sha.UpdateData(hashIP, Sha1Hash::GetLength());
+    sha.Finalize();
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), Sha1Hash::GetLength());
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&A, &B, nullptr);
+    sha.Finalize();
+    u.SetBinary(sha.GetDigest(), 20);
+
+    // S = (B - 3 * g^x) ^ (a + u * x), B is kept positive by adding N
+    BigNumber kgx = (g.ModExp(x, N) * 3) % N;
+    BigNumber base = ((B % N) + N - kgx) % N;
+    S = base.ModExp(a + u * x, N);
+
+    HashSessionKey();
+    return true;
+}
+
 bool SRP6::CalculateVerifier(const std::string& rI)
 {
     BigNumber salt;
@@ -56,6 +56,19 @@ class SRP6
         */
         bool CalculateSessionKey(uint8* lp_A, int l);
 
+        //! client side counterpart of CalculateHostPublicEphemeral and CalculateSessionKey
+        /*!
+          generates the client private (a) and public ephemeral (A) and calculates the session key (S)
+          and its hash (K), used by tools acting as a client. CalculateProof then yields the client proof (M)
+          \param username the unique identity of the account to authenticate
+          \param password the account password
+          \param lp_B the host public ephemeral (B)
+          \param lp_s the salt (s)
+          \param l the length of both B and s
+          \return true on valid safeguard conditions (B % N != 0) otherwise false
+        */
+        bool CalculateClientSessionKey(const std::string& username, const std::string& password, const uint8* lp_B, const uint8* lp_s, int l);
+
         //! calculates the password verifier (v)
         /*!
           \param rI a sha1 hash of USERNAME:PASSWORD
@@ -100,6 +113,7 @@ class SRP6
         */
         void Finalize(Sha1Hash& sha);
 
+        BigNumber GetClientPublicEphemeral(void) { return A; };
         BigNumber GetHostPublicEphemeral(void) { return B; };
         BigNumber GetGeneratorModulo(void) { return g; };
         BigNumber GetPrime(void) { return N; };
@@ -113,7 +127,7 @@ class SRP6
         bool SetVerifier(const char* new_v);
 
     private:
-        BigNumber A, u, S;
+        BigNumber a, A, u, S;
         BigNumber N, s, g, v;
         BigNumber b, B;
         BigNumber K;
@@ -28,73 +28,74 @@ DBCFileLoader::DBCFileLoader()
     fieldsOffset = nullptr;
 }
 
-bool DBCFileLoader::Load(const char* filename, const char* fmt)
+bool DBCFileLoader::ReadHeader(const unsigned char* header, const char* fmt)
 {
-    uint32 header;
-    delete[] data;
+    uint32 magic;
+    memcpy(&magic, header, 4);
+    EndianConvert(magic);
 
-    FILE* f = fopen(filename, "rb");
-    if (!f)
+    if (magic != 0x43424457)                                //'WDBC'
         return false;
 
-    if (fread(&header, 4, 1, f) != 1)                       // Number of records
+    memcpy(&recordCount, header + 4, 4);                    // Number of records
+    EndianConvert(recordCount);
+    memcpy(&fieldCount, header + 8, 4);                     // Number of fields
+    EndianConvert(fieldCount);
+    memcpy(&recordSize, header + 12, 4);                    // Size of a record
+    EndianConvert(recordSize);
+    memcpy(&stringSize, header + 16, 4);                    // String size
+    EndianConvert(stringSize);
+
+    delete[] fieldsOffset;
+    fieldsOffset = new uint32[fieldCount];
+    fieldsOffset[0] = 0;
+    for (uint32 i = 1; i < fieldCount; ++i)
     {
-        fclose(f);
-        return false;
+        fieldsOffset[i] = fieldsOffset[i - 1];
+        if (fmt[i - 1] == 'b' || fmt[i - 1] == 'X')         // byte fields
+            fieldsOffset[i] += 1;
+        else                                                // 4 byte fields (int32/float/strings)
+            fieldsOffset[i] += 4;
     }
 
+    return true;
+}
 
-    EndianConvert(header);
+bool DBCFileLoader::Load(const char* filename, const char* fmt)
+{
+    unsigned char header[20];
 
-    if (header != 0x43424457)                               //'WDBC'
-    {
-        fclose(f);
-        return false;
-    }
+    if (!file)
+        delete[] data;
+    data = nullptr;
+    file.reset();
 
-    if (fread(&recordCount, 4, 1, f) != 1)                  // Number of records
+    // mapped files are paged in on access and need no heap copy
+    std::unique_ptr<MaNGOS::MappedFile> mapped = std::make_unique<MaNGOS::MappedFile>();
+    if (mapped->Open(filename))
     {
-        fclose(f);
-        return false;
-    }
+        if (mapped->GetSize() < sizeof(header) || !ReadHeader(reinterpret_cast<unsigned char*>(mapped->GetData()), fmt))
+            return false;
 
-    EndianConvert(recordCount);
+        if (mapped->GetSize() - sizeof(header) < size_t(recordSize) * recordCount + stringSize)
+            return false;
 
-    if (fread(&fieldCount, 4, 1, f) != 1)                   // Number of fields
-    {
-        fclose(f);
-        return false;
+        file = std::move(mapped);
+        data = reinterpret_cast<unsigned char*>(file->GetData()) + sizeof(header);
+        stringTable = data + recordSize * recordCount;
+        return true;
     }
 
-    EndianConvert(fieldCount);
-
-    if (fread(&recordSize, 4, 1, f) != 1)                   // Size of a record
-    {
-        fclose(f);
+    FILE* f = fopen(filename, "rb");
+    if (!f)
         return false;
-    }
-
-    EndianConvert(recordSize);
 
-    if (fread(&stringSize, 4, 1, f) != 1)                   // String size
+    if (fread(header, sizeof(header), 1, f) != 1 || !ReadHeader(header, fmt))
     {
         fclose(f);
         return false;
     }
 
-    EndianConvert(stringSize);
-
-    fieldsOffset = new uint32[fieldCount];
-    fieldsOffset[0] = 0;
-    for (uint32 i = 1; i < fieldCount; ++i)
-    {
-        fieldsOffset[i] = fieldsOffset[i - 1];
-        if (fmt[i - 1] == 'b' || fmt[i - 1] == 'X')         // byte fields
-            fieldsOffset[i] += 1;
-        else                                                // 4 byte fields (int32/float/strings)
-            fieldsOffset[i] += 4;
-    }
-
     data = new unsigned char[recordSize * recordCount + stringSize];
     stringTable = data + recordSize * recordCount;
 
@@ -110,7 +111,8 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
 
 DBCFileLoader::~DBCFileLoader()
 {
-    delete[] data;
+    if (!file)
+        delete[] data;
     delete[] fieldsOffset;
 }
 
@@ -120,6 +122,13 @@ DBCFileLoader::Record DBCFileLoader::getRecord(size_t id)
     return Record(*this, data + id * recordSize);
 }
 
+std::unique_ptr<MaNGOS::MappedFile> DBCFileLoader::ReleaseFile()
+{
+    data = nullptr;
+    stringTable = nullptr;
+    return std::move(file);
+}
+
 uint32 DBCFileLoader::GetFormatRecordSize(const char* format, int32* index_pos)
 {
     uint32 recordsize = 0;
@@ -165,34 +174,18 @@ uint32 DBCFileLoader::GetFormatRecordSize(const char* format, int32* index_pos)
     return recordsize;
 }
 
-char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**& indexTable)
+char** DBCFileLoader::ProduceIndexTable(int32 indexPos, uint32& records)
 {
-    /*
-    format STRING, NA, FLOAT,NA,INT <=>
-    struct{
-    char* field0,
-    float field1,
-    int field2
-    }entry;
-
-    this func will generate  entry[rows] data;
-    */
-
     typedef char* ptr;
-    if (strlen(format) != fieldCount)
-        return nullptr;
+    ptr* indexTable;
 
-    // get struct size and index pos
-    int32 i;
-    uint32 recordsize = GetFormatRecordSize(format, &i);
-
-    if (i >= 0)
+    if (indexPos >= 0)
     {
         uint32 maxi = 0;
         // find max index
         for (uint32 y = 0; y < recordCount; ++y)
         {
-            uint32 ind = getRecord(y).getUInt(i);
+            uint32 ind = getRecord(y).getUInt(indexPos);
             if (ind > maxi)
                 maxi = ind;
         }
@@ -208,6 +201,31 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
         indexTable = new ptr[recordCount];
     }
 
+    return indexTable;
+}
+
+char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**& indexTable)
+{
+    /*
+    format STRING, NA, FLOAT,NA,INT <=>
+    struct{
+    char* field0,
+    float field1,
+    int field2
+    }entry;
+
+    this func will generate  entry[rows] data;
+    */
+
+    if (strlen(format) != fieldCount)
+        return nullptr;
+
+    // get struct size and index pos
+    int32 i;
+    uint32 recordsize = GetFormatRecordSize(format, &i);
+
+    indexTable = ProduceIndexTable(i, records);
+
     char* dataTable = new char[recordCount * recordsize];
 
     uint32 offset = 0;
@@ -259,6 +277,52 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
     return dataTable;
 }
 
+bool DBCFileLoader::CanProduceDataInPlace(const char* format) const
+{
+#if MANGOS_ENDIAN == MANGOS_BIG_ENDIAN
+    return false;
+#else
+    // records can only be used as they are when every field is stored unchanged and 4 byte aligned records follow each other
+    if (!file || strlen(format) != fieldCount || recordSize % 4 != 0)
+        return false;
+
+    for (uint32 x = 0; format[x]; ++x)
+    {
+        switch (format[x])
+        {
+            case FT_FLOAT:
+            case FT_IND:
+            case FT_INT:
+            case FT_BYTE:
+                break;
+            default:
+                return false;
+        }
+    }
+
+    return GetFormatRecordSize(format) == recordSize;
+#endif
+}
+
+char* DBCFileLoader::ProduceDataInPlace(const char* format, uint32& records, char**& indexTable)
+{
+    int32 i;
+    GetFormatRecordSize(format, &i);
+
+    indexTable = ProduceIndexTable(i, records);
+
+    for (uint32 y = 0; y < recordCount; ++y)
+    {
+        char* record = reinterpret_cast<char*>(data + y * recordSize);
+        if (i >= 0)
+            indexTable[getRecord(y).getUInt(i)] = record;
+        else
+            indexTable[y] = record;
+    }
+
+    return reinterpret_cast<char*>(data);
+}
+
 char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
 {
     if (strlen(format) != fieldCount)
@@ -267,6 +331,20 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
     char* stringPool = new char[stringSize];
     memcpy(stringPool, stringTable, stringSize);
 
+    FillStrings(format, dataTable, stringPool);
+    return stringPool;
+}
+
+void DBCFileLoader::ProduceStringsInPlace(const char* format, char* dataTable)
+{
+    if (strlen(format) != fieldCount)
+        return;
+
+    FillStrings(format, dataTable, reinterpret_cast<char*>(stringTable));
+}
+
+void DBCFileLoader::FillStrings(const char* format, char* dataTable, char* stringPool)
+{
     uint32 offset = 0;
 
     for (uint32 y = 0; y < recordCount; ++y)
@@ -310,6 +388,4 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
             }
         }
     }
-
-    return stringPool;
 }
@@ -20,7 +20,9 @@
 #define DBC_FILE_LOADER_H
 #include "Platform/Define.h"
 #include "Util/ByteConverter.h"
+#include "Util/MappedFile.h"
 #include <cassert>
+#include <memory>
 
 enum FieldFormat
 {
@@ -93,10 +95,20 @@ class DBCFileLoader
         uint32 GetCols() const { return fieldCount; }
         uint32 GetOffset(size_t id) const { return (fieldsOffset != nullptr && id < fieldCount) ? fieldsOffset[id] : 0; }
         bool IsLoaded() const { return data != nullptr; }
+        bool IsMapped() const { return file != nullptr; }
         char* AutoProduceData(const char* format, uint32& records, char**& indexTable);
         char* AutoProduceStrings(const char* format, char* dataTable);
         static uint32 GetFormatRecordSize(const char* format, int32* index_pos = nullptr);
+
+        // Serving records and strings straight from the mapped file, the caller keeps the file from ReleaseFile()
+        bool CanProduceDataInPlace(const char* format) const;
+        char* ProduceDataInPlace(const char* format, uint32& records, char**& indexTable);
+        void ProduceStringsInPlace(const char* format, char* dataTable);
+        std::unique_ptr<MaNGOS::MappedFile> ReleaseFile();
     private:
+        bool ReadHeader(const unsigned char* header, const char* fmt);
+        char** ProduceIndexTable(int32 indexPos, uint32& records);
+        void FillStrings(const char* format, char* dataTable, char* stringPool);
 
         uint32 recordSize;
         uint32 recordCount;
@@ -105,5 +117,6 @@ class DBCFileLoader
         uint32* fieldsOffset;
         unsigned char* data;
         unsigned char* stringTable;
+        std::unique_ptr<MaNGOS::MappedFile> file;           // data points into it when set
 };
 #endif
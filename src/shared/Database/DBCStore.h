@@ -21,12 +21,17 @@
 
 #include "DBCFileLoader.h"
 
+#include <cstring>
+#include <list>
+#include <memory>
+
 template<class T>
 class DBCStorage
 {
         typedef std::list<char*> StringPoolList;
+        typedef std::list<std::unique_ptr<MaNGOS::MappedFile>> MappedFileList;
     public:
-        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(nullptr), m_dataTable(nullptr) { }
+        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(nullptr), m_dataTable(nullptr), m_dataInPlace(false) { }
         ~DBCStorage() { Clear(); }
 
         T const* LookupEntry(uint32 id) const { return (id >= nCount) ? nullptr : indexTable[id]; }
@@ -43,11 +48,20 @@ class DBCStorage
 
             fieldCount = dbc.GetCols();
 
-            // load raw non-string data
+            // records matching the structure layout are used straight from the mapped file
+            m_dataInPlace = dbc.CanProduceDataInPlace(fmt);
+            if (m_dataInPlace)
+            {
+                // such formats have no strings, the mapping only has to outlive the store
+                m_dataTable = (T*)dbc.ProduceDataInPlace(fmt, nCount, (char**&)indexTable);
+                m_mappedFileList.push_back(dbc.ReleaseFile());
+                return indexTable != nullptr;
+            }
+
             m_dataTable = (T*)dbc.AutoProduceData(fmt, nCount, (char**&)indexTable);
 
             // load strings from dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            AddStrings(dbc);
 
             // error in dbc file at loading if nullptr
             return indexTable != nullptr;
@@ -65,7 +79,7 @@ class DBCStorage
                 return false;
 
             // load strings from another locale dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            AddStrings(dbc);
 
             return true;
         }
@@ -77,14 +91,17 @@ class DBCStorage
 
             delete[]((char*)indexTable);
             indexTable = nullptr;
-            delete[]((char*)m_dataTable);
+            if (!m_dataInPlace)
+                delete[]((char*)m_dataTable);
             m_dataTable = nullptr;
+            m_dataInPlace = false;
 
             while (!m_stringPoolList.empty())
             {
                 delete[] m_stringPoolList.front();
                 m_stringPoolList.pop_front();
             }
+            m_mappedFileList.clear();
             nCount = 0;
         }
 
@@ -92,12 +109,29 @@ class DBCStorage
         void InsertEntry(T* entry, uint32 id) { assert(id < nCount && "To be inserted entry must be in bounds!"); indexTable[id] = entry; }
 
     private:
+        void AddStrings(DBCFileLoader& dbc)
+        {
+            // strings of mapped files are only paged in when read, the file has to outlive the store then
+            if (dbc.IsMapped())
+            {
+                if (!strchr(fmt, FT_STRING))
+                    return;
+
+                dbc.ProduceStringsInPlace(fmt, (char*)m_dataTable);
+                m_mappedFileList.push_back(dbc.ReleaseFile());
+            }
+            else
+                m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+        }
+
         uint32 nCount;
         uint32 fieldCount;
         char const* fmt;
         T** indexTable;
         T* m_dataTable;
+        bool m_dataInPlace;
         StringPoolList m_stringPoolList;
+        MappedFileList m_mappedFileList;
 };
 
 #endif
@@ -26,6 +26,7 @@
 class SQLStorageBase
 {
         template<class DerivedLoader, class StorageClass> friend class SQLStorageLoaderBase;
+        friend class SQLStorageCache;
 
     public:
         char const* GetTableName() const { return m_tableName; }
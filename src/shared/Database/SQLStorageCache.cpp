@@ -0,0 +1,375 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Database/SQLStorageCache.h"
+#include "Database/SQLStorage.h"
+#include "Database/DatabaseEnv.h"
+#include "Log/Log.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+std::string SQLStorageCache::m_directory;
+std::string SQLStorageCache::m_conversionKey;
+
+// bump when the snapshot layout changes
+static constexpr uint32 SQLSTORAGE_CACHE_VERSION = 1;
+static char const SQLSTORAGE_CACHE_MAGIC[4] = { 'S', 'Q', 'L', 'S' };
+
+namespace
+{
+    uint64 HashBytes(char const* data, size_t size)
+    {
+        // FNV-1a, only guards against damaged files
+        uint64 hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= uint8(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    class SnapshotReader
+    {
+        public:
+            SnapshotReader(char const* data, size_t size) : m_data(data), m_size(size), m_pos(0) {}
+
+            bool Read(void* dst, size_t size)
+            {
+                if (m_size - m_pos < size)
+                    return false;
+                memcpy(dst, m_data + m_pos, size);
+                m_pos += size;
+                return true;
+            }
+
+            bool ReadString(std::string& str)
+            {
+                uint32 length;
+                if (!Read(&length, sizeof(length)) || m_size - m_pos < length)
+                    return false;
+                str.assign(m_data + m_pos, length);
+                m_pos += length;
+                return true;
+            }
+
+            char const* Skip(size_t size)
+            {
+                if (m_size - m_pos < size)
+                    return nullptr;
+                char const* data = m_data + m_pos;
+                m_pos += size;
+                return data;
+            }
+
+            size_t GetPos() const { return m_pos; }
+            size_t GetSize() const { return m_size; }
+
+        private:
+            char const* m_data;
+            size_t m_size;
+            size_t m_pos;
+    };
+
+    void AppendBytes(std::vector<char>& buffer, void const* data, size_t size)
+    {
+        buffer.insert(buffer.end(), static_cast<char const*>(data), static_cast<char const*>(data) + size);
+    }
+
+    void AppendString(std::vector<char>& buffer, char const* str, uint32 length)
+    {
+        AppendBytes(buffer, &length, sizeof(length));
+        AppendBytes(buffer, str, length);
+    }
+
+    /// offsets of owned string fields and of default filled pointer fields in a record
+    void GetPointerOffsets(char const* format, std::vector<uint32>& strings, std::vector<uint32>& pointers)
+    {
+        uint32 offset = 0;
+        for (char const* itr = format; *itr; ++itr)
+        {
+            switch (*itr)
+            {
+                case FT_LOGIC:       offset += sizeof(bool);   break;
+                case FT_BYTE:
+                case FT_NA_BYTE:     offset += sizeof(char);   break;
+                case FT_INT:
+                case FT_NA:          offset += sizeof(uint32); break;
+                case FT_FLOAT:
+                case FT_NA_FLOAT:    offset += sizeof(float);  break;
+                case FT_64BITINT:    offset += sizeof(uint64); break;
+                case FT_STRING:      strings.push_back(offset);  offset += sizeof(char*); break;
+                case FT_NA_POINTER:  pointers.push_back(offset); offset += sizeof(char*); break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+void SQLStorageCache::SetDirectory(std::string const& directory)
+{
+    m_directory = directory;
+    if (!m_directory.empty() && m_directory.back() != '/' && m_directory.back() != '\\')
+        m_directory += '/';
+}
+
+std::string SQLStorageCache::GetFileName(SQLStorageBase const& store)
+{
+    return m_directory + store.GetTableName() + ".snapshot";
+}
+
+bool SQLStorageCache::HasConversion(SQLStorageBase const& store)
+{
+    // same walk over source and destination fields as SQLStorageLoaderBase::Load
+    for (uint32 x = 0, y = 0; x < store.GetDstFieldCount() && y < store.GetSrcFieldCount();)
+    {
+        switch (store.GetDstFormat(x))
+        {
+            case FT_NA: case FT_NA_BYTE: case FT_NA_FLOAT: case FT_NA_POINTER:
+                ++x;
+                continue;
+            default:
+                break;
+        }
+
+        switch (store.GetSrcFormat(y))
+        {
+            case FT_NA: case FT_NA_BYTE: case FT_NA_FLOAT:
+                break;
+            case FT_STRING:
+                if (store.GetDstFormat(x) != FT_STRING)
+                    return true;
+                ++x;
+                break;
+            default:
+                ++x;
+                break;
+        }
+        ++y;
+    }
+    return false;
+}
+
+std::string SQLStorageCache::GetTableVersion(char const* tableName)
+{
+#if defined(DO_SQLITE)
+    (void)tableName;
+    return "";
+#else
+    // the release the world database claims, changed by every world database update
+    auto versionResult = WorldDatabase.Query("SELECT version FROM db_version LIMIT 1");
+    if (!versionResult || (*versionResult)[0].IsNULL())
+        return "";
+
+    std::string version = (*versionResult)[0].GetCppString();
+
+    // and when the table was last written, without reading any of it
+#if defined(DO_POSTGRESQL)
+    // row change counters of the statistics collector, they only count since the server started
+    auto result = WorldDatabase.PQuery("SELECT n_tup_ins, n_tup_upd, n_tup_del, pg_postmaster_start_time() FROM pg_stat_user_tables WHERE relname = '%s'", tableName);
+    uint32 const columns = 4;
+#else
+    // MyISAM keeps the update time of its data file, InnoDB reports NULL until the table is written after a restart
+    auto result = WorldDatabase.PQuery("SELECT CREATE_TIME, UPDATE_TIME FROM information_schema.TABLES WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = '%s'", tableName);
+    uint32 const columns = 2;
+#endif
+    if (!result)
+        return "";
+
+    Field* fields = result->Fetch();
+    for (uint32 i = 0; i < columns; ++i)
+    {
+        if (fields[i].IsNULL())
+            return "";
+        version += "|" + fields[i].GetCppString();
+    }
+    return version;
+#endif
+}
+
+std::string SQLStorageCache::GetStoreKey(SQLStorageBase const& store)
+{
+    if (m_directory.empty())
+        return "";
+
+    bool const conversion = HasConversion(store);
+    if (conversion && m_conversionKey.empty())
+        return "";
+
+    std::string version = GetTableVersion(store.GetTableName());
+    if (version.empty())
+        return "";
+
+    return version + "|" + (conversion ? m_conversionKey : "");
+}
+
+bool SQLStorageCache::Load(SQLStorageBase& store, uint32 maxEntry, uint32 recordCount, uint32 recordSize, std::string const& key)
+{
+    std::ifstream file(GetFileName(store), std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+
+    std::vector<char> buffer(size_t(file.tellg()));
+    file.seekg(0);
+    if (!file.read(buffer.data(), buffer.size()))
+        return false;
+
+    SnapshotReader reader(buffer.data(), buffer.size());
+    char magic[4];
+    uint32 version, fileMaxEntry, fileRecordCount, fileRecordSize;
+    uint64 hash;
+    std::string fileKey, srcFormat, dstFormat;
+    if (!reader.Read(magic, sizeof(magic)) || memcmp(magic, SQLSTORAGE_CACHE_MAGIC, sizeof(magic)) != 0 ||
+        !reader.Read(&version, sizeof(version)) || version != SQLSTORAGE_CACHE_VERSION ||
+        !reader.Read(&fileMaxEntry, sizeof(fileMaxEntry)) || fileMaxEntry != maxEntry ||
+        !reader.Read(&fileRecordCount, sizeof(fileRecordCount)) || fileRecordCount != recordCount ||
+        !reader.Read(&fileRecordSize, sizeof(fileRecordSize)) || fileRecordSize != recordSize ||
+        !reader.Read(&hash, sizeof(hash)) ||
+        !reader.ReadString(fileKey) || fileKey != key ||
+        !reader.ReadString(srcFormat) || srcFormat != store.GetSrcFormat() ||
+        !reader.ReadString(dstFormat) || dstFormat != store.GetDstFormat())
+        return false;
+
+    if (HashBytes(buffer.data() + reader.GetPos(), reader.GetSize() - reader.GetPos()) != hash)
+    {
+        sLog.outError("SQLStorageCache: snapshot of %s is damaged, loading from database", store.GetTableName());
+        return false;
+    }
+
+    char const* ids = reader.Skip(size_t(recordCount) * sizeof(uint32));
+    char const* records = reader.Skip(size_t(recordCount) * recordSize);
+    if (!ids || !records)
+        return false;
+
+    std::vector<uint32> stringOffsets, pointerOffsets;
+    GetPointerOffsets(store.GetDstFormat(), stringOffsets, pointerOffsets);
+
+    // check the string section completely before the store is touched
+    size_t const stringsStart = reader.GetPos();
+    for (uint32 i = 0; i < recordCount * stringOffsets.size(); ++i)
+    {
+        uint32 length;
+        if (!reader.Read(&length, sizeof(length)) || !reader.Skip(length))
+            return false;
+    }
+    if (reader.GetPos() != reader.GetSize())
+        return false;
+
+    SnapshotReader strings(buffer.data() + stringsStart, buffer.size() - stringsStart);
+    store.prepareToLoad(maxEntry, recordCount, recordSize);
+    for (uint32 i = 0; i < recordCount; ++i)
+    {
+        uint32 id;
+        memcpy(&id, ids + i * sizeof(uint32), sizeof(id));
+
+        char* record = store.createRecord(id);
+        memcpy(record, records + size_t(i) * recordSize, recordSize);
+
+        for (uint32 offset : stringOffsets)
+        {
+            uint32 length;
+            strings.Read(&length, sizeof(length));
+            char* str = new char[length + 1];
+            memcpy(str, strings.Skip(length), length);
+            str[length] = 0;
+            memcpy(record + offset, &str, sizeof(char*));
+        }
+
+        for (uint32 offset : pointerOffsets)
+        {
+            char* str = new char[1];
+            *str = 0;
+            memcpy(record + offset, &str, sizeof(char*));
+        }
+    }
+
+    sLog.outString("Loaded %u %s records from snapshot", recordCount, store.GetTableName());
+    return true;
+}
+
+void SQLStorageCache::Save(SQLStorageBase const& store, std::vector<uint32> const& ids, std::string const& key)
+{
+    uint32 const recordCount = store.m_recordCount;
+    uint32 const recordSize = store.m_recordSize;
+    if (ids.size() != recordCount)
+        return;
+
+    std::vector<uint32> stringOffsets, pointerOffsets;
+    GetPointerOffsets(store.GetDstFormat(), stringOffsets, pointerOffsets);
+
+    std::vector<char> payload;
+    AppendBytes(payload, ids.data(), ids.size() * sizeof(uint32));
+
+    size_t const recordsStart = payload.size();
+    AppendBytes(payload, store.m_data, size_t(recordCount) * recordSize);
+    for (uint32 i = 0; i < recordCount; ++i)
+    {
+        // pointers are meaningless in the next process
+        char* record = payload.data() + recordsStart + size_t(i) * recordSize;
+        for (uint32 offset : stringOffsets)
+            memset(record + offset, 0, sizeof(char*));
+        for (uint32 offset : pointerOffsets)
+            memset(record + offset, 0, sizeof(char*));
+    }
+
+    for (uint32 i = 0; i < recordCount; ++i)
+    {
+        char const* record = store.m_data + size_t(i) * recordSize;
+        for (uint32 offset : stringOffsets)
+        {
+            char const* str;
+            memcpy(&str, record + offset, sizeof(char*));
+            AppendString(payload, str ? str : "", str ? strlen(str) : 0);
+        }
+    }
+
+    std::vector<char> header;
+    uint32 const version = SQLSTORAGE_CACHE_VERSION;
+    uint64 const hash = HashBytes(payload.data(), payload.size());
+    AppendBytes(header, SQLSTORAGE_CACHE_MAGIC, sizeof(SQLSTORAGE_CACHE_MAGIC));
+    AppendBytes(header, &version, sizeof(version));
+    AppendBytes(header, &store.m_maxEntry, sizeof(uint32));
+    AppendBytes(header, &recordCount, sizeof(recordCount));
+    AppendBytes(header, &recordSize, sizeof(recordSize));
+    AppendBytes(header, &hash, sizeof(hash));
+    AppendString(header, key.data(), key.size());
+    AppendString(header, store.GetSrcFormat(), strlen(store.GetSrcFormat()));
+    AppendString(header, store.GetDstFormat(), strlen(store.GetDstFormat()));
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+
+    // written aside and renamed, a crash must not leave a half written snapshot behind
+    std::string const fileName = GetFileName(store);
+    std::string const tempName = fileName + ".tmp";
+    {
+        std::ofstream file(tempName, std::ios::binary | std::ios::trunc);
+        if (!file || !file.write(header.data(), header.size()) || !file.write(payload.data(), payload.size()))
+        {
+            sLog.outError("SQLStorageCache: could not write snapshot %s", tempName.c_str());
+            return;
+        }
+    }
+
+    std::filesystem::rename(tempName, fileName, error);
+    if (error)
+        sLog.outError("SQLStorageCache: could not replace snapshot %s: %s", fileName.c_str(), error.message().c_str());
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SQLSTORAGE_CACHE_H
+#define SQLSTORAGE_CACHE_H
+
+#include "Common.h"
+
+#include <string>
+#include <vector>
+
+class SQLStorageBase;
+
+/**
+ * Binary snapshots of SQLStorage tables.
+ *
+ * A snapshot holds the records exactly as SQLStorageLoader produced
+ * them, before any ObjectMgr post processing, and is keyed by the
+ * world database version, the time the database last wrote the table
+ * (row change counters on PostgreSQL), the storage formats, the record
+ * count and for tables storing script names as ids the script name
+ * list. None of these read the table itself. Anything not matching,
+ * including a damaged file, makes the caller load from SQL and write a
+ * fresh snapshot.
+ */
+class SQLStorageCache
+{
+    public:
+        /// empty directory disables the cache
+        static void SetDirectory(std::string const& directory);
+
+        /// key of the state loaders use to convert strings to values (script names),
+        /// tables with such conversions are only cached once it is set
+        static void SetConversionKey(std::string const& key) { m_conversionKey = key; }
+
+        /// key the snapshot of store has to match, empty if store cannot be cached (yet)
+        static std::string GetStoreKey(SQLStorageBase const& store);
+
+        /// fills store from its snapshot, false if there is no matching one
+        static bool Load(SQLStorageBase& store, uint32 maxEntry, uint32 recordCount, uint32 recordSize, std::string const& key);
+        /// writes the records of store, ids holds the record id of every record in order
+        static void Save(SQLStorageBase const& store, std::vector<uint32> const& ids, std::string const& key);
+
+    private:
+        /// database version and last write of the table, empty when the database cannot tell
+        static std::string GetTableVersion(char const* tableName);
+        /// true if a source string field is stored as something else
+        static bool HasConversion(SQLStorageBase const& store);
+        static std::string GetFileName(SQLStorageBase const& store);
+
+        static std::string m_directory;
+        static std::string m_conversionKey;
+};
+
+#endif
@@ -22,6 +22,7 @@
 #include "Util/ProgressBar.h"
 #include "Log/Log.h"
 #include "DBCFileLoader.h"
+#include "Database/SQLStorageCache.h"
 
 template<class DerivedLoader, class StorageClass>
 template<class S, class D>                                  // S source-type, D destination-type
@@ -325,27 +326,6 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         recordCount = fields[0].GetUInt32();
     }
 
-    queryResult = WorldDatabase.PQuery("SELECT * FROM %s", store.GetTableName());
-
-    if (!queryResult)
-    {
-        if (error_at_empty)
-            sLog.outError("%s table is empty!\n", store.GetTableName());
-        else
-            sLog.outString("%s table is empty!\n", store.GetTableName());
-
-        recordCount = 0;
-        return;
-    }
-
-    if (store.GetSrcFieldCount() != queryResult->GetFieldCount())
-    {
-        recordCount = 0;
-        sLog.outError("Error in %s table, probably sql file format was updated (there should be %d fields in sql).\n", store.GetTableName(), store.GetSrcFieldCount());
-        Log::WaitBeforeContinueIfNeed();
-        exit(1);                                            // Stop server at loading broken or non-compatible table.
-    }
-
     // get struct size
     uint32 offset = 0;
     for (uint32 x = 0; x < store.GetDstFieldCount(); ++x)
@@ -382,9 +362,39 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         }
     }
 
+    // a snapshot matching the table contents replaces the whole row by row conversion
+    std::string const cacheKey = SQLStorageCache::GetStoreKey(store);
+    if (!cacheKey.empty() && recordCount && SQLStorageCache::Load(store, maxRecordId, recordCount, recordsize, cacheKey))
+        return;
+
+    queryResult = WorldDatabase.PQuery("SELECT * FROM %s", store.GetTableName());
+
+    if (!queryResult)
+    {
+        if (error_at_empty)
+            sLog.outError("%s table is empty!\n", store.GetTableName());
+        else
+            sLog.outString("%s table is empty!\n", store.GetTableName());
+
+        recordCount = 0;
+        return;
+    }
+
+    if (store.GetSrcFieldCount() != queryResult->GetFieldCount())
+    {
+        recordCount = 0;
+        sLog.outError("Error in %s table, probably sql file format was updated (there should be %d fields in sql).\n", store.GetTableName(), store.GetSrcFieldCount());
+        Log::WaitBeforeContinueIfNeed();
+        exit(1);                                            // Stop server at loading broken or non-compatible table.
+    }
+
     // Prepare data storage and lookup storage
     store.prepareToLoad(maxRecordId, recordCount, recordsize);
 
+    std::vector<uint32> cacheIds;
+    if (!cacheKey.empty())
+        cacheIds.reserve(recordCount);
+
     BarGoLink bar(recordCount);
     do
     {
@@ -392,6 +402,8 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         bar.step();
 
         char* record = store.createRecord(fields[0].GetUInt32());
+        if (!cacheKey.empty())
+            cacheIds.push_back(fields[0].GetUInt32());
         offset = 0;
 
         // dependend on dest-size
@@ -440,6 +452,9 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         }
     }
     while (queryResult->NextRow());
+
+    if (!cacheKey.empty())
+        SQLStorageCache::Save(store, cacheIds, cacheKey);
 }
 
 #endif
@@ -17,6 +17,7 @@
  */
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <fstream>
 #include <functional>
 
 #include "Config/Config.h"
@@ -84,9 +85,14 @@ metric::metric::~metric()
     if (!m_enabled)
         return;
 
+    set_recording(false);
+
     boost::asio::post(m_writeContext, [&] {
         m_sendTimer->cancel();
     });
+    boost::asio::post(m_queueContext, [&] {
+        m_aggregateTimer->cancel();
+    });
 
     m_queueContextWork.get()->reset();
     m_writeContextWork.get()->reset();
@@ -110,8 +116,11 @@ void metric::metric::initialize()
         sConfig.GetStringDefault("Metric.Username", ""),
         sConfig.GetStringDefault("Metric.Password", "")
     };
+    m_outputFile = sConfig.GetStringDefault("Metric.OutputFile", "");
+    m_aggregateInterval = std::max(1, sConfig.GetIntDefault("Metric.AggregateInterval", 10));
 
     m_sendTimer.reset(new boost::asio::system_timer(m_writeContext));
+    m_aggregateTimer.reset(new boost::asio::system_timer(m_queueContext));
     m_queueContextWork = std::make_unique<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>(boost::asio::make_work_guard(m_queueContext));
     m_writeContextWork = std::make_unique<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>(boost::asio::make_work_guard(m_writeContext));
 
@@ -124,7 +133,10 @@ void metric::metric::initialize()
         m_writeContext.run();
     });
 
+    set_recording(true);
+
     schedule_timer();
+    schedule_aggregate();
 }
 
 metric::metric& metric::metric::instance()
@@ -149,7 +161,9 @@ void metric::metric::reload_config()
             sConfig.GetStringDefault("Metric.Username", ""),
             sConfig.GetStringDefault("Metric.Password", "")
         };
+        m_outputFile = sConfig.GetStringDefault("Metric.OutputFile", "");
     });
+    m_aggregateInterval = std::max(1, sConfig.GetIntDefault("Metric.AggregateInterval", 10));
 }
 
 void metric::metric::report(std::string measurement, std::string key, boost::any value, std::map<std::string, std::string> tags)
@@ -180,6 +194,55 @@ void metric::metric::schedule_timer()
     m_sendTimer->async_wait(std::bind(&metric::metric::prepare_send, this, _1));
 }
 
+void metric::metric::schedule_aggregate()
+{
+    using namespace std::placeholders;
+
+    if (!m_aggregateTimer)
+        return;
+
+    m_aggregateTimer->expires_after(std::chrono::seconds(m_aggregateInterval.load()));
+    m_aggregateTimer->async_wait(std::bind(&metric::metric::aggregate, this, _1));
+}
+
+void metric::metric::aggregate(const boost::system::error_code& ec)
+{
+    if (ec)
+    {
+        if (ec != boost::asio::error::operation_aborted)
+            sLog.outError("metric::metric::aggregate aborted, %s", ec.message().c_str());
+
+        return;
+    }
+
+    std::vector<series_summary> summaries = collect();
+    if (!summaries.empty())
+    {
+        std::lock_guard<std::mutex> guard(m_queueWriteLock);
+        for (auto const& summary : summaries)
+        {
+            std::map<std::string, boost::any> fields;
+            if (summary.type == series_type::histogram)
+            {
+                fields = {
+                    { "count", static_cast<int64>(summary.count) },
+                    { "sum", static_cast<int64>(summary.sum) },
+                    { "max", static_cast<int64>(summary.max) },
+                    { "p50", static_cast<int64>(summary.p50) },
+                    { "p90", static_cast<int64>(summary.p90) },
+                    { "p99", static_cast<int64>(summary.p99) }
+                };
+            }
+            else
+                fields = { { "value", static_cast<int64>(summary.sum) } };
+
+            m_measurementQueue.push_back(std::make_unique<Measurement>(summary.name + ".summary", summary.tags, fields));
+        }
+    }
+
+    schedule_aggregate();
+}
+
 void metric::metric::prepare_send(const boost::system::error_code& ec)
 {
     if (ec)
@@ -206,6 +269,26 @@ void metric::metric::send()
 
     sLog.outDetail("Sending %zu measurements!", measurements.size());
 
+    // local file output takes the same line protocol the database would get
+    if (!m_outputFile.empty())
+    {
+        if (measurements.empty())
+            return;
+
+        std::stringstream payload;
+        for (auto const& measurement : measurements)
+            (payload << *measurement) << "\n";
+
+        std::ofstream file(m_outputFile, std::ios::app);
+        if (!file)
+        {
+            sLog.outError("metric::metric::send cannot open %s", m_outputFile.c_str());
+            return;
+        }
+        file << payload.rdbuf();
+        return;
+    }
+
     using boost::asio::ip::tcp;
 
     boost::system::error_code error;
@@ -21,6 +21,7 @@
 
 #include <boost/any.hpp>
 #include <boost/asio.hpp>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <iostream>
@@ -29,6 +30,7 @@
 #include <vector>
 
 #include "Measurement.h"
+#include "Series.h"
 #include "Common.h"
 
 struct MetricConnectionInfo
@@ -105,6 +107,49 @@ namespace metric
             std::chrono::high_resolution_clock::time_point m_startTime;
     };
 
+    // samples into a registered histogram series, a measurement is only built for calls reaching the threshold
+    template <class precision>
+    class timer
+    {
+        public:
+            timer(series_id id, int64 threshold = 0, std::function<void(measurement&)> outlier = nullptr)
+                : m_id(id), m_threshold(threshold), m_outlier(std::move(outlier)), m_startTime(std::chrono::high_resolution_clock::now())
+            {}
+
+            ~timer()
+            {
+                auto endTime = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<precision>(endTime - m_startTime).count();
+
+                record(m_id, static_cast<uint64>(duration));
+                if (m_outlier && duration >= m_threshold && is_recording())
+                {
+                    measurement meas(series_name(m_id), "duration", static_cast<int64>(duration));
+                    m_outlier(meas);
+                }
+            }
+
+        private:
+            series_id m_id;
+            int64 m_threshold;
+            std::function<void(measurement&)> m_outlier;
+            std::chrono::high_resolution_clock::time_point m_startTime;
+    };
+
+    // timer outlier callback tagging the measurement with the world object it was taken for
+    template <class Object>
+    std::function<void(measurement&)> outlier_tags(Object const* object)
+    {
+        return [object](measurement& outlier)
+        {
+            outlier.add_tag("entry", std::to_string(object->GetEntry()));
+            outlier.add_tag("guid", std::to_string(object->GetGUIDLow()));
+            outlier.add_tag("unit_type", std::to_string(object->GetGUIDHigh()));
+            outlier.add_tag("map_id", std::to_string(object->GetMapId()));
+            outlier.add_tag("instance_id", std::to_string(object->GetInstanceId()));
+        };
+    }
+
     class metric
     {
         public:
@@ -124,6 +169,7 @@ namespace metric
             boost::asio::io_context m_writeContext;
 
             std::unique_ptr<boost::asio::system_timer> m_sendTimer;
+            std::unique_ptr<boost::asio::system_timer> m_aggregateTimer;
             std::unique_ptr<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> m_queueContextWork;
             std::unique_ptr<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> m_writeContextWork;
             std::thread m_queueServiceThread;
@@ -131,6 +177,8 @@ namespace metric
 
             bool m_enabled;
             MetricConnectionInfo m_connectionInfo;
+            std::string m_outputFile;
+            std::atomic<uint32> m_aggregateInterval;
 
             std::mutex m_queueWriteLock;
             std::vector<std::unique_ptr<Measurement>> m_measurementQueue;
@@ -138,6 +186,9 @@ namespace metric
             void schedule_timer();
             void prepare_send(const boost::system::error_code& ec);
             void send();
+
+            void schedule_aggregate();
+            void aggregate(const boost::system::error_code& ec);
     };
 }
 
@@ -0,0 +1,188 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "Series.h"
+
+namespace
+{
+    struct series_slot
+    {
+        std::atomic<uint64> count;
+        std::atomic<uint64> sum;
+        std::atomic<uint64> max;
+        std::array<std::atomic<uint32>, metric::HISTOGRAM_BUCKETS> buckets;
+    };
+
+    struct thread_slots
+    {
+        std::array<series_slot, metric::MAX_SERIES> slots;
+        std::atomic<bool> retired;
+    };
+
+    struct series_info
+    {
+        std::string name;
+        std::map<std::string, std::string> tags;
+        metric::series_type type;
+    };
+
+    // owned by the registry so samples of an exited thread are still collected
+    struct thread_handle
+    {
+        std::shared_ptr<thread_slots> slots;
+
+        ~thread_handle()
+        {
+            if (slots)
+                slots->retired = true;
+        }
+    };
+
+    std::mutex s_registryLock;
+    std::vector<series_info> s_series;
+    std::vector<std::shared_ptr<thread_slots>> s_threads;
+    std::atomic<bool> s_recording(false);
+
+    thread_local thread_handle t_slots;
+
+    thread_slots& local_slots()
+    {
+        if (!t_slots.slots)
+        {
+            t_slots.slots = std::make_shared<thread_slots>();
+            std::lock_guard<std::mutex> guard(s_registryLock);
+            s_threads.push_back(t_slots.slots);
+        }
+        return *t_slots.slots;
+    }
+}
+
+metric::series_id metric::register_series(std::string name, series_type type, std::map<std::string, std::string> tags)
+{
+    std::lock_guard<std::mutex> guard(s_registryLock);
+    if (s_series.size() >= MAX_SERIES)
+        return MAX_SERIES;
+
+    s_series.push_back({ std::move(name), std::move(tags), type });
+    return series_id(s_series.size() - 1);
+}
+
+std::string metric::series_name(series_id id)
+{
+    std::lock_guard<std::mutex> guard(s_registryLock);
+    if (id >= s_series.size())
+        return std::string();
+
+    return s_series[id].name;
+}
+
+void metric::record(series_id id, uint64 value)
+{
+    if (id >= MAX_SERIES || !s_recording.load(std::memory_order_relaxed))
+        return;
+
+    // only this thread writes the slot, the collector swaps values out atomically
+    series_slot& slot = local_slots().slots[id];
+    slot.buckets[histogram_layout::Index(value)].fetch_add(1, std::memory_order_relaxed);
+    slot.sum.fetch_add(value, std::memory_order_relaxed);
+    if (value > slot.max.load(std::memory_order_relaxed))
+        slot.max.store(value, std::memory_order_relaxed);
+    slot.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void metric::increment(series_id id, uint64 value)
+{
+    if (id >= MAX_SERIES || !s_recording.load(std::memory_order_relaxed))
+        return;
+
+    series_slot& slot = local_slots().slots[id];
+    slot.sum.fetch_add(value, std::memory_order_relaxed);
+    slot.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void metric::set_recording(bool enabled)
+{
+    s_recording = enabled;
+}
+
+bool metric::is_recording()
+{
+    return s_recording.load(std::memory_order_relaxed);
+}
+
+std::vector<metric::series_summary> metric::collect()
+{
+    std::vector<series_summary> summaries;
+    std::array<uint64, HISTOGRAM_BUCKETS> buckets;
+
+    std::lock_guard<std::mutex> guard(s_registryLock);
+
+    // an exited thread wrote its last samples before retiring, so only those seen retired before draining can go
+    std::vector<bool> retired;
+    retired.reserve(s_threads.size());
+    for (auto& thread : s_threads)
+        retired.push_back(thread->retired.load());
+
+    for (series_id id = 0; id < s_series.size(); ++id)
+    {
+        series_info const& info = s_series[id];
+        series_summary summary{ info.name, info.tags, info.type, 0, 0, 0, 0, 0, 0 };
+        buckets.fill(0);
+
+        for (auto& thread : s_threads)
+        {
+            series_slot& slot = thread->slots[id];
+            // samples landing between these loads are left for the next collection
+            uint64 count = slot.count.exchange(0, std::memory_order_relaxed);
+            if (!count)
+                continue;
+
+            summary.count += count;
+            summary.sum += slot.sum.exchange(0, std::memory_order_relaxed);
+            summary.max = std::max(summary.max, slot.max.exchange(0, std::memory_order_relaxed));
+            if (info.type == series_type::histogram)
+                for (uint32 i = 0; i < HISTOGRAM_BUCKETS; ++i)
+                    buckets[i] += slot.buckets[i].exchange(0, std::memory_order_relaxed);
+        }
+
+        if (!summary.count)
+            continue;
+
+        if (info.type == series_type::histogram)
+        {
+            summary.p50 = histogram_layout::Percentile(buckets, summary.count, 50);
+            summary.p90 = histogram_layout::Percentile(buckets, summary.count, 90);
+            summary.p99 = histogram_layout::Percentile(buckets, summary.count, 99);
+        }
+        summaries.push_back(std::move(summary));
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < s_threads.size(); ++i)
+        if (!retired[i])
+            s_threads[kept++] = std::move(s_threads[i]);
+    s_threads.resize(kept);
+
+    return summaries;
+}
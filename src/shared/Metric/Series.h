@@ -0,0 +1,76 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOSSERVER_METRIC_SERIES_H
+#define MANGOSSERVER_METRIC_SERIES_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Common.h"
+#include "Util/LogLinearHistogram.h"
+
+namespace metric
+{
+    typedef uint32 series_id;
+
+    // every recording thread holds a slot for each possible series, registering more fails
+    constexpr uint32 MAX_SERIES = 128;
+
+    // log linear buckets, 8 per power of two keep a reported percentile within 12.5% of the sample
+    constexpr uint32 HISTOGRAM_SUB_BUCKET_BITS = 3;
+    constexpr uint32 HISTOGRAM_MAX_EXPONENT = 39;
+    typedef MaNGOS::LogLinearBuckets<HISTOGRAM_SUB_BUCKET_BITS, HISTOGRAM_MAX_EXPONENT> histogram_layout;
+    constexpr uint32 HISTOGRAM_BUCKETS = histogram_layout::COUNT;
+
+    enum class series_type
+    {
+        counter,
+        histogram
+    };
+
+    struct series_summary
+    {
+        std::string name;
+        std::map<std::string, std::string> tags;
+        series_type type;
+        uint64 count;
+        uint64 sum;
+        uint64 max;
+        uint64 p50;
+        uint64 p90;
+        uint64 p99;
+    };
+
+    // meant to be called once per call site and kept in a static, returns MAX_SERIES when full
+    series_id register_series(std::string name, series_type type, std::map<std::string, std::string> tags = {});
+    std::string series_name(series_id id);
+
+    // lock free, only touches counters owned by the calling thread
+    void record(series_id id, uint64 value);
+    void increment(series_id id, uint64 value = 1);
+
+    void set_recording(bool enabled);
+    bool is_recording();
+
+    // drains the counters of every thread, only series which got samples since the last call are returned
+    std::vector<series_summary> collect();
+}
+
+#endif // MANGOSSERVER_METRIC_SERIES_H
@@ -36,9 +36,11 @@ namespace MaNGOS
             virtual ~AsyncSocket();
 
             void Read(char* buffer, size_t length, std::function<void(const boost::system::error_code&, std::size_t)>&& callback);
+            void ReadSome(char* buffer, size_t length, std::function<void(const boost::system::error_code&, std::size_t)>&& callback);
             void ReadUntil(std::string& buffer, char delimiter, std::function<void(const boost::system::error_code&, std::size_t)>&& callback);
             void ReadSkip(size_t skipSize, std::function<void(const boost::system::error_code&, std::size_t)>&& callback);
             void Write(const char* buffer, size_t length, std::function<void(const boost::system::error_code&, std::size_t)>&& callback);
+            void Write(std::vector<boost::asio::const_buffer> const& buffers, std::function<void(const boost::system::error_code&, std::size_t)>&& callback);
 
             bool Start();
             void Close()
@@ -92,6 +94,13 @@ namespace MaNGOS
         boost::asio::async_read(m_socket, boost::asio::buffer(buffer, length), callback);
     }
 
+    template <typename SocketType>
+    void MaNGOS::AsyncSocket<SocketType>::ReadSome(char* buffer, size_t length, std::function<void(const boost::system::error_code&, std::size_t)>&& callback)
+    {
+        // completes with whatever is available, at least one byte
+        m_socket.async_read_some(boost::asio::buffer(buffer, length), callback);
+    }
+
     template <typename SocketType>
     void MaNGOS::AsyncSocket<SocketType>::ReadUntil(std::string& buffer, char delimiter, std::function<void(const boost::system::error_code&, std::size_t)>&& callback)
     {
@@ -114,6 +123,13 @@ namespace MaNGOS
         boost::asio::async_write(m_socket, boost::asio::buffer(buffer, length), callback);
     }
 
+    template <typename SocketType>
+    void MaNGOS::AsyncSocket<SocketType>::Write(std::vector<boost::asio::const_buffer> const& buffers, std::function<void(const boost::system::error_code&, std::size_t)>&& callback)
+    {
+        // gathered write, buffers must stay alive until the callback
+        boost::asio::async_write(m_socket, buffers, callback);
+    }
+
     template <typename SocketType>
     bool MaNGOS::AsyncSocket<SocketType>::AsyncSocket::Start()
     {
@@ -0,0 +1,134 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Util/DistanceFilter.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DISTANCE_FILTER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(DISTANCE_FILTER_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define DISTANCE_FILTER_AVX2
+#include <immintrin.h>
+#endif
+
+namespace MaNGOS
+{
+    namespace DistanceFilter
+    {
+        static uint64 InRangeScalar(float const* xs, float const* ys, float const* zs, float const* extra, uint32 begin, uint32 count,
+                                    float x, float y, float z, float radius)
+        {
+            uint64 mask = 0;
+            for (uint32 i = begin; i < count; ++i)
+            {
+                float dx = xs[i] - x;
+                float dy = ys[i] - y;
+                float dz = zs ? zs[i] - z : 0.0f;
+                float maxDist = radius + extra[i];
+                if (dx * dx + dy * dy + dz * dz <= maxDist * maxDist)
+                    mask |= uint64(1) << i;
+            }
+            return mask;
+        }
+
+#ifdef DISTANCE_FILTER_SSE2
+        static uint64 InRangeSSE2(float const* xs, float const* ys, float const* zs, float const* extra, uint32 count,
+                                  float x, float y, float z, float radius)
+        {
+            __m128 const cx = _mm_set1_ps(x);
+            __m128 const cy = _mm_set1_ps(y);
+            __m128 const cz = _mm_set1_ps(z);
+            __m128 const r = _mm_set1_ps(radius);
+
+            uint64 mask = 0;
+            uint32 i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), cx);
+                __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), cy);
+                __m128 dist = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+                if (zs)
+                {
+                    __m128 dz = _mm_sub_ps(_mm_loadu_ps(zs + i), cz);
+                    dist = _mm_add_ps(dist, _mm_mul_ps(dz, dz));
+                }
+                __m128 maxDist = _mm_add_ps(r, _mm_loadu_ps(extra + i));
+                __m128 in = _mm_cmple_ps(dist, _mm_mul_ps(maxDist, maxDist));
+                mask |= uint64(_mm_movemask_ps(in)) << i;
+            }
+
+            return mask | InRangeScalar(xs, ys, zs, extra, i, count, x, y, z, radius);
+        }
+#endif
+
+#ifdef DISTANCE_FILTER_AVX2
+        __attribute__((target("avx2")))
+        static uint64 InRangeAVX2(float const* xs, float const* ys, float const* zs, float const* extra, uint32 count,
+                                  float x, float y, float z, float radius)
+        {
+            __m256 const cx = _mm256_set1_ps(x);
+            __m256 const cy = _mm256_set1_ps(y);
+            __m256 const cz = _mm256_set1_ps(z);
+            __m256 const r = _mm256_set1_ps(radius);
+
+            uint64 mask = 0;
+            uint32 i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), cx);
+                __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), cy);
+                __m256 dist = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+                if (zs)
+                {
+                    __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(zs + i), cz);
+                    dist = _mm256_add_ps(dist, _mm256_mul_ps(dz, dz));
+                }
+                __m256 maxDist = _mm256_add_ps(r, _mm256_loadu_ps(extra + i));
+                __m256 in = _mm256_cmp_ps(dist, _mm256_mul_ps(maxDist, maxDist), _CMP_LE_OQ);
+                mask |= uint64(_mm256_movemask_ps(in)) << i;
+            }
+
+            return mask | InRangeScalar(xs, ys, zs, extra, i, count, x, y, z, radius);
+        }
+
+        static bool HasAVX2()
+        {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+        }
+
+        static bool const s_hasAVX2 = HasAVX2();
+#endif
+
+        uint64 InRange(float const* xs, float const* ys, float const* zs, float const* extra, uint32 count,
+                       float x, float y, float z, float radius)
+        {
+#ifdef DISTANCE_FILTER_AVX2
+            if (s_hasAVX2)
+                return InRangeAVX2(xs, ys, zs, extra, count, x, y, z, radius);
+#endif
+#ifdef DISTANCE_FILTER_SSE2
+            return InRangeSSE2(xs, ys, zs, extra, count, x, y, z, radius);
+#else
+            return InRangeScalar(xs, ys, zs, extra, 0, count, x, y, z, radius);
+#endif
+        }
+    }
+}
@@ -0,0 +1,42 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_DISTANCEFILTER_H
+#define MANGOS_DISTANCEFILTER_H
+
+#include "Platform/Define.h"
+
+namespace MaNGOS
+{
+    namespace DistanceFilter
+    {
+        // largest batch a single call can test, one bit per position
+        static constexpr uint32 BATCH_SIZE = 64;
+
+        /**
+         * Tests a batch of positions stored as separate coordinate arrays against a center.
+         * Bit i of the result is set when position i lies within radius + extra[i] of the center.
+         * Distances are 2d when zs is nullptr. count must not exceed BATCH_SIZE.
+         * Uses AVX2 or SSE2 when the cpu has them, plain floats otherwise.
+         */
+        uint64 InRange(float const* xs, float const* ys, float const* zs, float const* extra, uint32 count,
+                       float x, float y, float z, float radius);
+    }
+}
+
+#endif
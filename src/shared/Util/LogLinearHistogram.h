@@ -0,0 +1,85 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LOGLINEARHISTOGRAM_H
+#define MANGOS_LOGLINEARHISTOGRAM_H
+
+#include "Platform/Define.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace MaNGOS
+{
+    /**
+     * Bucket layout of a log linear histogram.
+     * Values below 2 << SubBucketBits get a bucket each, every power of two above is split into
+     * 1 << SubBucketBits buckets up to 2^(MaxExponent + 1), larger values share the last bucket.
+     * A percentile read back is within 1 / (1 << SubBucketBits) of the recorded value.
+     */
+    template<uint32 SubBucketBits, uint32 MaxExponent>
+    struct LogLinearBuckets
+    {
+        static constexpr uint32 LINEAR = 2 << SubBucketBits;
+        static constexpr uint32 SUB_BUCKETS = 1 << SubBucketBits;
+        static constexpr uint32 COUNT = LINEAR + (MaxExponent - SubBucketBits) * SUB_BUCKETS;
+
+        static uint32 Index(uint64 value)
+        {
+            if (value < LINEAR)
+                return uint32(value);
+
+            uint32 exponent = std::bit_width(value) - 1;
+            if (exponent > MaxExponent)
+                return COUNT - 1;
+
+            uint32 shift = exponent - SubBucketBits;
+            uint32 subBucket = uint32(value >> shift) & (SUB_BUCKETS - 1);
+            return std::min(LINEAR + (shift - 1) * SUB_BUCKETS + subBucket, COUNT - 1);
+        }
+
+        // middle of the value range covered by the bucket
+        static uint64 Value(uint32 index)
+        {
+            if (index < LINEAR)
+                return index;
+
+            uint32 shift = (index - LINEAR) / SUB_BUCKETS + 1;
+            uint64 subBucket = (index - LINEAR) % SUB_BUCKETS;
+            uint64 lower = ((uint64(1) << SubBucketBits) + subBucket) << shift;
+            return lower + (uint64(1) << (shift - 1));
+        }
+
+        // buckets holds COUNT sample counts adding up to count
+        template<class Buckets>
+        static uint64 Percentile(Buckets const& buckets, uint64 count, uint32 percent)
+        {
+            uint64 rank = std::max<uint64>(1, (count * percent + 99) / 100);
+            uint64 seen = 0;
+            for (uint32 i = 0; i < COUNT; ++i)
+            {
+                seen += buckets[i];
+                if (seen >= rank)
+                    return Value(i);
+            }
+            return 0;
+        }
+    };
+}
+
+#endif
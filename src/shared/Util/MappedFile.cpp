@@ -0,0 +1,182 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Util/MappedFile.h"
+
+#if PLATFORM == PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MaNGOS
+{
+#if PLATFORM == PLATFORM_WINDOWS
+    namespace
+    {
+        typedef BOOL (WINAPI* PrefetchVirtualMemoryFunction)(HANDLE, ULONG_PTR, PWIN32_MEMORY_RANGE_ENTRY, ULONG);
+
+        // PrefetchVirtualMemory exists since Windows 8, older systems just get no prefetch
+        PrefetchVirtualMemoryFunction GetPrefetchVirtualMemory()
+        {
+            static PrefetchVirtualMemoryFunction const function = reinterpret_cast<PrefetchVirtualMemoryFunction>(
+                        GetProcAddress(GetModuleHandleA("kernel32.dll"), "PrefetchVirtualMemory"));
+            return function;
+        }
+    }
+
+    bool MappedFile::Open(char const* fileName)
+    {
+        Close();
+
+        HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+        if (!data)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        m_file = file;
+        m_mapping = mapping;
+        m_data = static_cast<char*>(data);
+        m_size = size_t(size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_data)
+            UnmapViewOfFile(m_data);
+        if (m_mapping)
+            CloseHandle(m_mapping);
+        if (m_file)
+            CloseHandle(m_file);
+
+        m_data = nullptr;
+        m_size = 0;
+        m_mapping = nullptr;
+        m_file = nullptr;
+    }
+
+    void MappedFile::Prefetch(size_t offset, size_t size) const
+    {
+        PrefetchVirtualMemoryFunction prefetch = GetPrefetchVirtualMemory();
+        if (!prefetch || !m_data || offset >= m_size)
+            return;
+
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = m_data + offset;
+        range.NumberOfBytes = size < m_size - offset ? size : m_size - offset;
+        prefetch(GetCurrentProcess(), 1, &range, 0);
+    }
+
+    void MappedFile::Touch() const
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+
+        // read faults map the cached file pages, nothing is copied
+        char sum = 0;
+        for (size_t offset = 0; offset < m_size; offset += info.dwPageSize)
+            sum ^= m_data[offset];
+        volatile char sink = sum;
+        (void)sink;
+    }
+#else
+    bool MappedFile::Open(char const* fileName)
+    {
+        Close();
+
+        int fd = open(fileName, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        void* data = mmap(nullptr, size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        // the mapping stays valid after the descriptor is closed
+        close(fd);
+        if (data == MAP_FAILED)
+            return false;
+
+        m_data = static_cast<char*>(data);
+        m_size = size_t(st.st_size);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_data)
+            munmap(m_data, m_size);
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    void MappedFile::Prefetch(size_t offset, size_t size) const
+    {
+        if (!m_data || offset >= m_size)
+            return;
+
+        // madvise wants a page aligned start
+        size_t const pageSize = size_t(sysconf(_SC_PAGESIZE));
+        size_t const start = offset & ~(pageSize - 1);
+        size_t const end = size < m_size - offset ? offset + size : m_size;
+        madvise(m_data + start, end - start, MADV_WILLNEED);
+    }
+
+    void MappedFile::Touch() const
+    {
+        // not MAP_POPULATE, that would copy every page of the writable private mapping, read
+        // faults map the cached file pages
+        size_t const pageSize = size_t(sysconf(_SC_PAGESIZE));
+        char sum = 0;
+        for (size_t offset = 0; offset < m_size; offset += pageSize)
+            sum ^= m_data[offset];
+        volatile char sink = sum;
+        (void)sink;
+    }
+#endif
+}
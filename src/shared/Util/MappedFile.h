@@ -0,0 +1,71 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPPEDFILE_H
+#define MANGOS_MAPPEDFILE_H
+
+#include "Platform/Define.h"
+
+#include <cstddef>
+
+namespace MaNGOS
+{
+    /**
+     * Read only file mapped into memory. Pages are mapped copy on write,
+     * so data served from the mapping may still be patched in place
+     * without touching the file. Pages not yet copied are read from the
+     * file, which therefore must not be truncated or rewritten in place
+     * while it is mapped: reading a page past the new end raises SIGBUS.
+     */
+    class MappedFile
+    {
+        public:
+            MappedFile() : m_data(nullptr), m_size(0)
+#if PLATFORM == PLATFORM_WINDOWS
+                , m_file(nullptr), m_mapping(nullptr)
+#endif
+            {}
+            ~MappedFile() { Close(); }
+
+            MappedFile(MappedFile const&) = delete;
+            MappedFile& operator=(MappedFile const&) = delete;
+
+            /// false if the file does not exist, is empty or cannot be mapped
+            bool Open(char const* fileName);
+            void Close();
+
+            bool IsOpen() const { return m_data != nullptr; }
+            char* GetData() const { return m_data; }
+            size_t GetSize() const { return m_size; }
+
+            /// hints that [offset, offset + size) will be read soon
+            void Prefetch(size_t offset, size_t size) const;
+            /// reads every page once, so the disk reads happen now and not in later accesses
+            void Touch() const;
+
+        private:
+            char* m_data;
+            size_t m_size;
+#if PLATFORM == PLATFORM_WINDOWS
+            void* m_file;
+            void* m_mapping;
+#endif
+    };
+}
+
+#endif
@@ -0,0 +1,253 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Util/TickProfiler.h"
+#include "Config/Config.h"
+#include "Log/Log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+INSTANTIATE_SINGLETON_1(TickProfiler);
+
+TickProfiler::TickProfiler() : m_epoch(std::chrono::steady_clock::now()), m_recording(false), m_slowTickThreshold(0),
+    m_capturing(false), m_captureStart(0), m_tickStart(0), m_nextSlowTickDump(0),
+    m_stopWriter(false)
+{
+}
+
+TickProfiler::~TickProfiler()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_writerLock);
+        m_stopWriter = true;
+    }
+    m_writerCondition.notify_one();
+
+    // dumps still queued are written before the writer exits
+    if (m_writer.joinable())
+        m_writer.join();
+}
+
+uint64 TickProfiler::Now() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+}
+
+ProfileThreadBuffer* TickProfiler::CreateThreadBuffer()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_buffers.push_back(std::make_unique<ProfileThreadBuffer>());
+    ProfileThreadBuffer* buffer = m_buffers.back().get();
+    buffer->threadIndex = uint32(m_buffers.size());
+    buffer->head = 0;
+    return buffer;
+}
+
+void TickProfiler::Record(char const* name, uint64 start, uint64 end)
+{
+    // buffers are kept until shutdown so readers never see one go away
+    thread_local ProfileThreadBuffer* buffer = nullptr;
+    if (!buffer)
+        buffer = CreateThreadBuffer();
+
+    uint64 head = buffer->head.load(std::memory_order_relaxed);
+    ProfileEvent& event = buffer->events[head & (PROFILER_RING_SIZE - 1)];
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void TickProfiler::UpdateRecording()
+{
+    m_recording = m_capturing || m_slowTickThreshold.load() != 0;
+}
+
+void TickProfiler::SetSlowTickThreshold(uint32 thresholdMs)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_slowTickThreshold = thresholdMs;
+    UpdateRecording();
+}
+
+void TickProfiler::BeginTick()
+{
+    m_tickStart = m_slowTickThreshold.load(std::memory_order_relaxed) ? Now() : 0;
+}
+
+void TickProfiler::EndTick()
+{
+    uint32 threshold = m_slowTickThreshold.load(std::memory_order_relaxed);
+    if (!threshold || !m_tickStart)
+        return;
+
+    uint64 tickEnd = Now();
+    if (tickEnd - m_tickStart < uint64(threshold) * 1000000)
+        return;
+
+    time_t now = time(nullptr);
+    if (now < m_nextSlowTickDump)
+        return;
+
+    m_nextSlowTickDump = now + PROFILER_SLOW_TICK_DUMP_COOLDOWN;
+
+    std::string fileName;
+    uint32 eventCount;
+    Dump(m_tickStart, tickEnd, "slowtick", "TickProfiler: tick took " + std::to_string((tickEnd - m_tickStart) / 1000000) + " ms", fileName, eventCount);
+}
+
+bool TickProfiler::StartCapture()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (m_capturing)
+        return false;
+
+    m_capturing = true;
+    m_captureStart = Now();
+    UpdateRecording();
+    return true;
+}
+
+bool TickProfiler::StopCapture(std::string& fileName, uint32& eventCount)
+{
+    uint64 captureStart;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (!m_capturing)
+            return false;
+
+        m_capturing = false;
+        captureStart = m_captureStart;
+        UpdateRecording();
+    }
+
+    Dump(captureStart, Now(), "capture", "TickProfiler: capture", fileName, eventCount);
+    return true;
+}
+
+bool TickProfiler::IsCapturing() const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_capturing;
+}
+
+std::vector<TickProfiler::DumpEvent> TickProfiler::Collect(uint64 from, uint64 to)
+{
+    // only the copy happens under the lock, so threads starting to record are not held up by the file output
+    std::vector<DumpEvent> collected;
+    std::lock_guard<std::mutex> guard(m_lock);
+    for (auto& buffer : m_buffers)
+    {
+        uint64 head = buffer->head.load(std::memory_order_acquire);
+        uint64 first = head > PROFILER_RING_SIZE ? head - PROFILER_RING_SIZE : 0;
+        size_t begin = collected.size();
+        for (uint64 i = first; i < head; ++i)
+        {
+            ProfileEvent const& event = buffer->events[i & (PROFILER_RING_SIZE - 1)];
+            collected.push_back({ event.name.load(std::memory_order_relaxed), event.start.load(std::memory_order_relaxed),
+                event.end.load(std::memory_order_relaxed), buffer->threadIndex });
+        }
+
+        // the owner kept writing meanwhile, drop what it overwrote including the slot it may be in the middle of
+        uint64 headAfter = buffer->head.load(std::memory_order_acquire);
+        if (headAfter + 1 > first + PROFILER_RING_SIZE)
+        {
+            size_t overwritten = size_t(std::min<uint64>(headAfter + 1 - PROFILER_RING_SIZE - first, head - first));
+            collected.erase(collected.begin() + begin, collected.begin() + begin + overwritten);
+        }
+
+        collected.erase(std::remove_if(collected.begin() + begin, collected.end(), [from, to](DumpEvent const& event)
+        {
+            return !event.name || event.start < from || event.end > to;
+        }), collected.end());
+    }
+    return collected;
+}
+
+void TickProfiler::Dump(uint64 from, uint64 to, char const* reason, std::string const& message, std::string& fileName, uint32& eventCount)
+{
+    std::vector<DumpEvent> events = Collect(from, to);
+    eventCount = uint32(events.size());
+
+    std::string logsDir = sConfig.GetStringDefault("LogsDir");
+    if (!logsDir.empty() && logsDir.back() != '/' && logsDir.back() != '\\')
+        logsDir.append("/");
+
+    char timeStr[20];
+    time_t now = time(nullptr);
+    tm localTm;
+#ifdef _MSC_VER
+    localtime_s(&localTm, &now);
+#else
+    localtime_r(&now, &localTm);
+#endif
+    strftime(timeStr, sizeof(timeStr), "%Y%m%d_%H%M%S", &localTm);
+    fileName = logsDir + "profile_" + reason + "_" + timeStr + ".json";
+
+    {
+        std::lock_guard<std::mutex> guard(m_writerLock);
+        if (!m_writer.joinable())
+            m_writer = std::thread(&TickProfiler::WriterThread, this);
+
+        m_pendingDumps.push_back({ fileName, message, std::move(events) });
+    }
+    m_writerCondition.notify_one();
+}
+
+void TickProfiler::WriterThread()
+{
+    std::unique_lock<std::mutex> lock(m_writerLock);
+    while (true)
+    {
+        m_writerCondition.wait(lock, [this] { return m_stopWriter || !m_pendingDumps.empty(); });
+        if (m_pendingDumps.empty())
+            return;
+
+        PendingDump dump = std::move(m_pendingDumps.front());
+        m_pendingDumps.pop_front();
+
+        lock.unlock();
+        if (Write(dump.fileName, dump.events))
+            sLog.outString("%s, %u zones written to %s", dump.message.c_str(), uint32(dump.events.size()), dump.fileName.c_str());
+        lock.lock();
+    }
+}
+
+bool TickProfiler::Write(std::string const& fileName, std::vector<DumpEvent> const& events)
+{
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+    {
+        sLog.outError("TickProfiler: cannot open %s for writing", fileName.c_str());
+        return false;
+    }
+
+    // chrome trace event format, complete events in microseconds
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        DumpEvent const& event = events[i];
+        fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            i ? ",\n" : "", event.name, event.threadIndex, event.start / 1000.0, (event.end - event.start) / 1000.0);
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    return true;
+}
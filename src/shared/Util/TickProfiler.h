@@ -0,0 +1,148 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TICKPROFILER_H
+#define MANGOS_TICKPROFILER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define PROFILER_RING_SIZE                  65536           // events kept per thread, power of two
+#define PROFILER_SLOW_TICK_DUMP_COOLDOWN    60              // seconds between two automatic slow tick dumps
+
+struct ProfileEvent
+{
+    std::atomic<char const*> name;
+    std::atomic<uint64> start;
+    std::atomic<uint64> end;
+};
+
+// written by its own thread only, overwrites the oldest events once full
+struct ProfileThreadBuffer
+{
+    uint32 threadIndex;
+    std::atomic<uint64> head;                               // events written so far
+    std::array<ProfileEvent, PROFILER_RING_SIZE> events;
+};
+
+class TickProfiler
+{
+    public:
+        TickProfiler();
+        ~TickProfiler();
+
+        bool IsRecording() const { return m_recording.load(std::memory_order_relaxed); }
+        uint64 Now() const;                                 // nanoseconds since profiler creation
+        void Record(char const* name, uint64 start, uint64 end);
+
+        // world ticks reaching the threshold are written out automatically, 0 disables
+        void SetSlowTickThreshold(uint32 thresholdMs);
+        void BeginTick();
+        void EndTick();
+
+        bool StartCapture();
+        // the file is written in the background, fileName and eventCount are known right away
+        bool StopCapture(std::string& fileName, uint32& eventCount);
+        bool IsCapturing() const;
+
+    private:
+        struct DumpEvent
+        {
+            char const* name;
+            uint64 start;
+            uint64 end;
+            uint32 threadIndex;
+        };
+
+        void UpdateRecording();
+        ProfileThreadBuffer* CreateThreadBuffer();
+        std::vector<DumpEvent> Collect(uint64 from, uint64 to);
+        struct PendingDump
+        {
+            std::string fileName;
+            std::string message;
+            std::vector<DumpEvent> events;
+        };
+
+        // formatting and file output run on m_writer so the calling tick is not stalled
+        void Dump(uint64 from, uint64 to, char const* reason, std::string const& message, std::string& fileName, uint32& eventCount);
+        void WriterThread();
+        static bool Write(std::string const& fileName, std::vector<DumpEvent> const& events);
+
+        std::chrono::steady_clock::time_point m_epoch;
+        std::atomic<bool> m_recording;
+        std::atomic<uint32> m_slowTickThreshold;
+
+        mutable std::mutex m_lock;
+        std::vector<std::unique_ptr<ProfileThreadBuffer>> m_buffers;
+        bool m_capturing;
+        uint64 m_captureStart;
+
+        uint64 m_tickStart;
+        time_t m_nextSlowTickDump;
+
+        std::mutex m_writerLock;
+        std::condition_variable m_writerCondition;
+        std::deque<PendingDump> m_pendingDumps;
+        bool m_stopWriter;
+        std::thread m_writer;
+};
+
+#define sTickProfiler MaNGOS::Singleton<TickProfiler>::Instance()
+
+// times the enclosing scope while the profiler records, name must outlive the process (literals, opcode names)
+class ProfileZone
+{
+    public:
+        explicit ProfileZone(char const* name) : m_name(name), m_active(sTickProfiler.IsRecording()), m_start(m_active ? sTickProfiler.Now() : 0) {}
+        ~ProfileZone()
+        {
+            if (m_active)
+                sTickProfiler.Record(m_name, m_start, sTickProfiler.Now());
+        }
+
+    private:
+        char const* m_name;
+        bool m_active;
+        uint64 m_start;
+};
+
+// marks one world tick, the slow tick check runs when it goes out of scope
+class ProfileTick
+{
+    public:
+        ProfileTick() { sTickProfiler.BeginTick(); }
+        ~ProfileTick() { sTickProfiler.EndTick(); }
+};
+
+#define PROFILE_ZONE_CONCAT_(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_ZONE_CONCAT(profileZone, __LINE__)(name)
+
+#endif
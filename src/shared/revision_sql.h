@@ -3,5 +3,5 @@
  #define REVISION_DB_REALMD "required_z2820_01_realmd_joindate_datetime"
  #define REVISION_DB_LOGS "required_z2778_01_logs_anticheat"
  #define REVISION_DB_CHARACTERS "required_z2819_01_characters_item_instance_text_id_fix"
- #define REVISION_DB_MANGOS "required_z2830_01_mangos_icon_name"
+ #define REVISION_DB_MANGOS "required_z2831_01_mangos_update_diff_string"
 #endif // __REVISION_SQL_H__